@@ -0,0 +1,529 @@
+#include "farso_bench.h"
+#include "../size.h"
+
+#if FARSO_HAS_RAPIDJSON == 1
+
+#include <SDL2/SDL.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+using namespace FarsoExample;
+
+/************************************************************************
+ *                          Allocation Counter                          *
+ ************************************************************************/
+
+/* Note: all memory allocations of the process are counted, by replacing
+ * the global new and delete operators (new[] and delete[] default ones
+ * call them). */
+static std::atomic<size_t> totalAllocations(0);
+
+void* operator new(size_t size)
+{
+   totalAllocations++;
+   void* ptr = malloc((size > 0) ? size : 1);
+   if(ptr == NULL)
+   {
+      throw std::bad_alloc();
+   }
+   return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+   free(ptr);
+}
+
+/************************************************************************
+ *                              Constructor                             *
+ ************************************************************************/
+FarsoBench::FarsoBench(int frames, bool composite)
+{
+   Kobold::Log::init(&log);
+
+   this->frames = frames;
+   this->composite = composite;
+   this->renderer = NULL;
+   this->scrollText = NULL;
+   this->dragX = 0;
+   this->dragY = 0;
+
+   Farso::Controller::setFrameStatsEnabled(true);
+
+   /* The example layouts */
+   const char* files[] = { "single_window", "dialog_window", "header_menu" };
+   for(int i = 0; i < 3; i++)
+   {
+      Layout layout;
+      layout.name = files[i];
+      layout.widgets.push_back(loadFile(Kobold::String("data/json/") + 
+               files[i] + ".json"));
+      layouts.push_back(layout);
+   }
+
+   /* And the generated ones */
+   Layout stress;
+   createStressLayout(stress);
+   layouts.push_back(stress);
+
+   Layout text;
+   createTextLayout(text);
+   layouts.push_back(text);
+}
+
+/************************************************************************
+ *                               Destructor                             *
+ ************************************************************************/
+FarsoBench::~FarsoBench()
+{
+   unload();
+}
+
+/************************************************************************
+ *                                loadFile                              *
+ ************************************************************************/
+Kobold::String FarsoBench::loadFile(const Kobold::String& filename)
+{
+   struct stat tagStat;
+   if(stat(filename.c_str(), &tagStat) != 0)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't open file '%s'", filename.c_str());
+      return "";
+   }
+   FILE* pFile = fopen(filename.c_str(), "rb");
+   if(!pFile)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't open file '%s'", filename.c_str());
+      return "";
+   }
+
+   Kobold::String res;
+   res.resize(tagStat.st_size);
+   size_t read = fread(&res[0], 1, tagStat.st_size, pFile);
+   fclose(pFile);
+   res.resize(read);
+
+   return res;
+}
+
+/************************************************************************
+ *                           createStressLayout                         *
+ ************************************************************************/
+void FarsoBench::createStressLayout(Layout& layout)
+{
+   layout.name = "generated_stress";
+
+   char buf[256];
+   for(int w = 0; w < FARSO_BENCH_STRESS_WINDOWS; w++)
+   {
+      /* Cascade the windows over the screen */
+      snprintf(buf, sizeof(buf), 
+            "{\"widget\":{\"type\":\"window\",\"caption\":\"Stress %d\","
+            "\"position\":[%d,%d],\"size\":[420,360],\"children\":[",
+            w, (w * 29) % (FARSO_EXAMPLE_WINDOW_WIDTH - 420),
+            (w * 17) % (FARSO_EXAMPLE_WINDOW_HEIGHT - 360));
+      Kobold::String json = buf;
+
+      for(int i = 0; i < FARSO_BENCH_STRESS_WIDGETS; i++)
+      {
+         /* A grid of mixed widgets */
+         int x = (i % 10) * 40;
+         int y = (i / 10) * 21;
+         switch(i % 4)
+         {
+            case 0:
+               snprintf(buf, sizeof(buf), "{\"type\":\"button\","
+                     "\"caption\":\"B%d\",\"position\":[%d,%d],"
+                     "\"size\":[38,20]}", i, x, y);
+            break;
+            case 1:
+               snprintf(buf, sizeof(buf), "{\"type\":\"label\","
+                     "\"caption\":\"L%d\",\"position\":[%d,%d],"
+                     "\"size\":[38,20]}", i, x, y);
+            break;
+            case 2:
+               snprintf(buf, sizeof(buf), "{\"type\":\"checkbox\","
+                     "\"caption\":\"\",\"position\":[%d,%d],"
+                     "\"size\":38,\"checked\":%s}", x, y, 
+                     (i % 8 == 2) ? "true" : "false");
+            break;
+            default:
+               snprintf(buf, sizeof(buf), "{\"type\":\"progressBar\","
+                     "\"position\":[%d,%d],\"size\":[38,20],"
+                     "\"value\":%d}", x, y, i % 100);
+            break;
+         }
+         json += buf;
+         json += (i < FARSO_BENCH_STRESS_WIDGETS - 1) ? "," : "";
+      }
+
+      json += "]}}";
+      layout.widgets.push_back(json);
+   }
+}
+
+/************************************************************************
+ *                            createTextLayout                          *
+ ************************************************************************/
+void FarsoBench::createTextLayout(Layout& layout)
+{
+   layout.name = "generated_text";
+   layout.widgets.push_back("{\"widget\":{\"type\":\"window\","
+         "\"caption\":\"Text\",\"position\":[100,50],\"size\":[600,600],"
+         "\"children\":[{\"type\":\"scrollText\",\"id\":\"bench_text\","
+         "\"position\":[0,0],\"size\":[580,560]}]}}");
+}
+
+/************************************************************************
+ *                                   load                               *
+ ************************************************************************/
+bool FarsoBench::load(const Layout& layout)
+{
+   renderer = new Farso::MemoryRenderer(composite);
+   Farso::Controller::init(&loader, renderer, FARSO_EXAMPLE_WINDOW_WIDTH,
+         FARSO_EXAMPLE_WINDOW_HEIGHT, 32, "data/gui/");
+   Farso::FontManager::setDefaultFont("fonts/LiberationSans-Regular.ttf");
+   Farso::Controller::loadSkin("skins/clean.skin");
+
+   for(size_t i = 0; i < layout.widgets.size(); i++)
+   {
+      if(!Farso::Controller::insertFromJson(layout.widgets[i]))
+      {
+         Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+               "Error: couldn't load layout '%s'", layout.name.c_str());
+         return false;
+      }
+   }
+
+   /* Define drag point, at the active window's title bar */
+   Farso::Widget* active = Farso::Controller::getActiveWidget();
+   if((active != NULL) && 
+      (active->getType() == Farso::Widget::WIDGET_TYPE_WINDOW))
+   {
+      dragX = active->getX() + active->getWidth() / 2;
+      dragY = active->getY() + 10;
+   }
+   else
+   {
+      dragX = -1;
+      dragY = -1;
+   }
+
+   Farso::Widget* text = Farso::Controller::getWidgetById("bench_text");
+   scrollText = ((text != NULL) && 
+         (text->getType() == Farso::Widget::WIDGET_TYPE_SCROLL_TEXT)) ?
+      static_cast<Farso::ScrollText*>(text) : NULL;
+
+   return true;
+}
+
+/************************************************************************
+ *                                  unload                              *
+ ************************************************************************/
+void FarsoBench::unload()
+{
+   if(renderer != NULL)
+   {
+      Farso::Controller::finish();
+      delete renderer;
+      renderer = NULL;
+   }
+   scrollText = NULL;
+}
+
+/************************************************************************
+ *                             getScenarioName                          *
+ ************************************************************************/
+const char* FarsoBench::getScenarioName(Scenario scenario)
+{
+   switch(scenario)
+   {
+      case SCENARIO_IDLE:
+         return "idle";
+      case SCENARIO_HOVER_SWEEP:
+         return "hover_sweep";
+      case SCENARIO_WINDOW_DRAG:
+         return "window_drag";
+      case SCENARIO_SKIN_SWITCH:
+         return "skin_switch";
+      case SCENARIO_TEXT_HEAVY:
+         return "text_heavy";
+      default:
+      break;
+   }
+   return "unknown";
+}
+
+/************************************************************************
+ *                                  frame                               *
+ ************************************************************************/
+void FarsoBench::frame(Scenario scenario, int index)
+{
+   static const char* skins[] = { "skins/clean.skin", "skins/moderna.skin",
+      "skins/arkana.skin", "skins/scifi.skin", "skins/wyrmheart.skin" };
+
+   switch(scenario)
+   {
+      case SCENARIO_IDLE:
+      {
+         Farso::Controller::verifyEvents(false, false, 0, 0);
+      }
+      break;
+      case SCENARIO_HOVER_SWEEP:
+      {
+         /* Zig-zag the cursor over the screen */
+         int x = (index * 37) % FARSO_EXAMPLE_WINDOW_WIDTH;
+         int y = ((index * 37) / FARSO_EXAMPLE_WINDOW_WIDTH * 23) % 
+                 FARSO_EXAMPLE_WINDOW_HEIGHT;
+         Farso::Controller::verifyEvents(false, false, x, y);
+      }
+      break;
+      case SCENARIO_WINDOW_DRAG:
+      {
+         /* Go back and forth, releasing only at last frame */
+         int delta = (index % 100 < 50) ? (index % 50) : 50 - (index % 50);
+         Farso::Controller::verifyEvents(index < frames - 1, false, 
+               dragX + delta * 2, dragY + delta);
+      }
+      break;
+      case SCENARIO_SKIN_SWITCH:
+      {
+         Farso::Controller::loadSkin(skins[index % 5]);
+         Farso::Controller::verifyEvents(false, false, 0, 0);
+      }
+      break;
+      case SCENARIO_TEXT_HEAVY:
+      {
+         char buf[128];
+         snprintf(buf, sizeof(buf), "Line %d: the quick brown fox jumps "
+               "over the lazy dog, again and again.", index);
+         scrollText->addText(buf);
+         Farso::Controller::verifyEvents(false, false, 0, 0);
+      }
+      break;
+      default:
+      break;
+   }
+}
+
+/************************************************************************
+ *                               runScenario                            *
+ ************************************************************************/
+bool FarsoBench::runScenario(const Kobold::String& layoutName, 
+      Scenario scenario)
+{
+   if(((scenario == SCENARIO_WINDOW_DRAG) && (dragX < 0)) ||
+      ((scenario == SCENARIO_TEXT_HEAVY) && (scrollText == NULL)))
+   {
+      /* Not applicable */
+      return false;
+   }
+
+   /* Make sure the layout is fully drawn and stable before measuring */
+   for(int i = 0; i < FARSO_BENCH_WARMUP_FRAMES; i++)
+   {
+      Farso::Controller::verifyEvents(false, false, 0, 0);
+   }
+
+   Result result;
+   result.layout = layoutName;
+   result.scenario = scenario;
+   result.frameTimes.reserve(frames);
+   for(int c = 0; c < Farso::FrameStats::TOTAL_COUNTERS; c++)
+   {
+      result.counters[c] = 0;
+   }
+   for(int p = 0; p < Farso::FrameStats::TOTAL_PHASES; p++)
+   {
+      result.phaseTimes[p] = 0.0;
+   }
+
+   Farso::WidgetRenderer::resetUploadCounters();
+   size_t allocations = totalAllocations.load();
+   double freq = (double) SDL_GetPerformanceFrequency();
+
+   for(int i = 0; i < frames; i++)
+   {
+      Uint64 start = SDL_GetPerformanceCounter();
+      frame(scenario, i);
+      result.frameTimes.push_back(
+            (1000.0 * (SDL_GetPerformanceCounter() - start)) / freq);
+
+      /* Accumulate the Controller statistics of this frame */
+      Farso::FrameStats stats = Farso::Controller::getLastFrameStats();
+      for(int c = 0; c < Farso::FrameStats::TOTAL_COUNTERS; c++)
+      {
+         result.counters[c] += stats.getCounter(
+               (Farso::FrameStats::Counter) c);
+      }
+      for(int p = 0; p < Farso::FrameStats::TOTAL_PHASES; p++)
+      {
+         result.phaseTimes[p] += stats.getPhaseTime(
+               (Farso::FrameStats::Phase) p);
+      }
+   }
+
+   /* Note: the frameTimes vector was reserved, so don't count here. */
+   result.allocations = totalAllocations.load() - allocations;
+   result.uploads = Farso::WidgetRenderer::getUploadCount();
+   result.uploadedBytes = Farso::WidgetRenderer::getUploadedBytes();
+   result.fullUploadBytes = Farso::WidgetRenderer::getFullUploadBytes();
+
+   results.push_back(result);
+
+   Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, "%s/%s: done", 
+         layoutName.c_str(), getScenarioName(scenario));
+
+   return true;
+}
+
+/************************************************************************
+ *                                    run                               *
+ ************************************************************************/
+void FarsoBench::run()
+{
+   for(size_t l = 0; l < layouts.size(); l++)
+   {
+      for(int s = 0; s < TOTAL_SCENARIOS; s++)
+      {
+         /* Each scenario starts from the freshly loaded layout */
+         if(load(layouts[l]))
+         {
+            runScenario(layouts[l].name, (Scenario) s);
+         }
+         unload();
+      }
+   }
+}
+
+/************************************************************************
+ *                                percentile                            *
+ ************************************************************************/
+double FarsoBench::percentile(const std::vector<double>& sorted, double p)
+{
+   if(sorted.empty())
+   {
+      return 0.0;
+   }
+   size_t index = (size_t) (p * (sorted.size() - 1) + 0.5);
+   return sorted[index];
+}
+
+/************************************************************************
+ *                               writeResults                           *
+ ************************************************************************/
+void FarsoBench::writeResults(FILE* file)
+{
+   fprintf(file, "{\n   \"version\" : \"%s\",\n", FARSO_VERSION);
+   fprintf(file, "   \"frames\" : %d,\n", frames);
+   fprintf(file, "   \"composite\" : %s,\n", composite ? "true" : "false");
+   fprintf(file, "   \"results\" :\n   [\n");
+
+   for(size_t i = 0; i < results.size(); i++)
+   {
+      Result& res = results[i];
+      std::vector<double> sorted = res.frameTimes;
+      std::sort(sorted.begin(), sorted.end());
+      double total = 0.0;
+      for(size_t f = 0; f < sorted.size(); f++)
+      {
+         total += sorted[f];
+      }
+
+      fprintf(file, "      {\n");
+      fprintf(file, "         \"layout\" : \"%s\",\n", res.layout.c_str());
+      fprintf(file, "         \"scenario\" : \"%s\",\n", 
+            getScenarioName(res.scenario));
+      fprintf(file, "         \"mean_ms\" : %.4f,\n", 
+            (sorted.empty()) ? 0.0 : total / sorted.size());
+      fprintf(file, "         \"p50_ms\" : %.4f,\n", percentile(sorted, 0.5));
+      fprintf(file, "         \"p90_ms\" : %.4f,\n", percentile(sorted, 0.9));
+      fprintf(file, "         \"p99_ms\" : %.4f,\n", 
+            percentile(sorted, 0.99));
+      fprintf(file, "         \"max_ms\" : %.4f,\n", 
+            (sorted.empty()) ? 0.0 : sorted.back());
+      fprintf(file, "         \"uploads\" : %zu,\n", res.uploads);
+      fprintf(file, "         \"uploaded_bytes\" : %zu,\n", 
+            res.uploadedBytes);
+      fprintf(file, "         \"full_upload_bytes\" : %zu,\n", 
+            res.fullUploadBytes);
+      fprintf(file, "         \"allocations\" : %zu,\n", res.allocations);
+      for(int c = 0; c < Farso::FrameStats::TOTAL_COUNTERS; c++)
+      {
+         fprintf(file, "         \"%s\" : %llu,\n", 
+               Farso::FrameStats::getCounterName(
+                  (Farso::FrameStats::Counter) c),
+               (unsigned long long) res.counters[c]);
+      }
+      for(int p = 0; p < Farso::FrameStats::TOTAL_PHASES; p++)
+      {
+         fprintf(file, "         \"%s_mean_ms\" : %.4f%s\n", 
+               Farso::FrameStats::getPhaseName((Farso::FrameStats::Phase) p),
+               (frames > 0) ? res.phaseTimes[p] / frames : 0.0,
+               (p < Farso::FrameStats::TOTAL_PHASES - 1) ? "," : "");
+      }
+      fprintf(file, "      }%s\n", (i < results.size() - 1) ? "," : "");
+   }
+
+   fprintf(file, "   ]\n}\n");
+}
+
+/*********************************************************************
+ *                           Main Code                               *
+ *********************************************************************/
+int main(int argc, char **argv)
+{
+   /* Usage: farso-bench [frames] [--composite] [--trace trace.json] 
+    *                    [output.json] */
+   int frames = FARSO_BENCH_DEFAULT_FRAMES;
+   bool composite = false;
+   const char* output = NULL;
+   for(int i = 1; i < argc; i++)
+   {
+      if(strcmp(argv[i], "--composite") == 0)
+      {
+         composite = true;
+      }
+      else if((strcmp(argv[i], "--trace") == 0) && (i + 1 < argc))
+      {
+         i++;
+         Farso::Trace::start(argv[i]);
+      }
+      else if(atoi(argv[i]) > 0)
+      {
+         frames = atoi(argv[i]);
+      }
+      else
+      {
+         output = argv[i];
+      }
+   }
+
+   FarsoBench* bench = new FarsoBench(frames, composite);
+   bench->run();
+   Farso::Trace::stop();
+
+   FILE* file = (output != NULL) ? fopen(output, "w") : stdout;
+   if(file != NULL)
+   {
+      bench->writeResults(file);
+      if(file != stdout)
+      {
+         fclose(file);
+      }
+   }
+
+   delete bench;
+
+   return 0;
+}
+
+#endif
+
@@ -0,0 +1,136 @@
+#ifndef _farso_bench_h
+#define _farso_bench_h
+
+#include "farsoconfig.h"
+
+#if FARSO_HAS_RAPIDJSON == 1
+
+#include "../../../src/controller.h"
+#include "../../../src/loader.h"
+#include "../../../src/memory/memoryrenderer.h"
+
+#include <kobold/log.h>
+
+#include <stdio.h>
+#include <vector>
+
+namespace FarsoExample
+{
+
+/*! Default number of measured frames for each scenario */
+#define FARSO_BENCH_DEFAULT_FRAMES    300
+/*! Frames run before measuring each scenario */
+#define FARSO_BENCH_WARMUP_FRAMES       5
+/*! Number of windows on the generated stress layout */
+#define FARSO_BENCH_STRESS_WINDOWS     20
+/*! Number of widgets on each window of the generated stress layout */
+#define FARSO_BENCH_STRESS_WIDGETS    150
+
+/*! Scenario benchmark: loads layouts from JSON and run scripted frames
+ * of Controller::verifyEvents with synthetic mouse input, on the 
+ * headless MemoryRenderer, reporting the results as JSON. */
+class FarsoBench
+{
+   public:
+      /*! Scenarios run for each layout */
+      enum Scenario
+      {
+         /*! Nothing happens: mouse stopped and no buttons pressed */
+         SCENARIO_IDLE = 0,
+         /*! Mouse hovering all over the screen */
+         SCENARIO_HOVER_SWEEP,
+         /*! Drag the active window by its title bar */
+         SCENARIO_WINDOW_DRAG,
+         /*! Change the skin on each frame */
+         SCENARIO_SKIN_SWITCH,
+         /*! Add a line of text to a ScrollText on each frame */
+         SCENARIO_TEXT_HEAVY,
+         /*! Just to know the total */
+         TOTAL_SCENARIOS
+      };
+
+      /*! Constructor
+       * \param frames number of measured frames of each scenario
+       * \param composite if the MemoryRenderer should composite the 
+       *        widgets into a framebuffer */
+      FarsoBench(int frames, bool composite);
+      /*! Destructor */
+      ~FarsoBench();
+
+      /*! Run all scenarios for all layouts */
+      void run();
+
+      /*! Write the results, as JSON, to a file */
+      void writeResults(FILE* file);
+
+   private:
+      /*! A layout to benchmark */
+      struct Layout
+      {
+         Kobold::String name; /**< Its name on results */
+         std::vector<Kobold::String> widgets; /**< Each root widget JSON */
+      };
+
+      /*! Result of a scenario run on a layout */
+      struct Result
+      {
+         Kobold::String layout; /**< Layout name */
+         Scenario scenario; /**< Scenario run */
+         std::vector<double> frameTimes; /**< Each frame time, in ms */
+         size_t uploads; /**< Surface uploads */
+         size_t uploadedBytes; /**< Bytes uploaded */
+         size_t fullUploadBytes; /**< Bytes if uploading whole surfaces */
+         size_t allocations; /**< Memory allocations */
+         uint64_t counters[Farso::FrameStats::TOTAL_COUNTERS]; /**< Sum of
+                                              frame statistics counters */
+         double phaseTimes[Farso::FrameStats::TOTAL_PHASES]; /**< Sum of 
+                                              frame phase times, in ms */
+      };
+
+      /*! Init the Controller and load a layout to it.
+       * \return false if couldn't load it. */
+      bool load(const Layout& layout);
+      /*! Finish the Controller, unloading current layout */
+      void unload();
+
+      /*! Run a scenario on the current loaded layout.
+       * \return false if the scenario isn't applicable to the layout */
+      bool runScenario(const Kobold::String& layoutName, Scenario scenario);
+
+      /*! Run a single frame of a scenario */
+      void frame(Scenario scenario, int index);
+
+      /*! \return a percentile of sorted frame times */
+      double percentile(const std::vector<double>& sorted, double p);
+
+      /*! \return the name of a scenario */
+      const char* getScenarioName(Scenario scenario);
+
+      /*! Load a file contents */
+      Kobold::String loadFile(const Kobold::String& filename);
+
+      /*! Create the generated stress layout */
+      void createStressLayout(Layout& layout);
+      /*! Create the generated text-heavy layout */
+      void createTextLayout(Layout& layout);
+
+      int frames; /**< Measured frames for each scenario */
+      bool composite; /**< If compositing */
+      Kobold::DefaultLog log; /**< Log used */
+      Farso::DefaultLoader loader; /**< Loader used */
+      Farso::MemoryRenderer* renderer; /**< Current renderer */
+
+      int dragX; /**< Drag start X coordinate */
+      int dragY; /**< Drag start Y coordinate */
+      Farso::ScrollText* scrollText; /**< ScrollText of text layout */
+
+      std::vector<Layout> layouts; /**< Layouts to benchmark */
+      std::vector<Result> results; /**< Results of each run */
+};
+
+}
+
+#endif
+
+#endif
+
@@ -0,0 +1,466 @@
+#include "farso_microbench.h"
+
+#include "../../../src/blendspan.h"
+#include "../../../src/memory/memoryrenderer.h"
+#include "../../../src/sdl/sdlrenderer.h"
+
+#include <math.h>
+#include <string.h>
+
+using namespace FarsoExample;
+
+/*! Texts on different scripts, for font kernels */
+static const char* benchScripts[] = 
+{
+   "The quick brown fox jumps over the lazy dog",
+   "Ação à côté naïve façade über straße",
+   "Ξεσκεπάζω την ψυχοφθόρα βδελυγμία",
+   "Съешь же ещё этих мягких французских булок"
+};
+static const char* benchScriptNames[] = 
+{
+   "latin", "latin_accented", "greek", "cyrillic"
+};
+#define FARSO_MICROBENCH_TOTAL_SCRIPTS   4
+
+/************************************************************************
+ *                              Constructor                             *
+ ************************************************************************/
+FarsoMicroBench::FarsoMicroBench()
+{
+   Kobold::Log::init(&log);
+
+   renderer = NULL;
+   sdlTarget = NULL;
+   sdlRenderer = NULL;
+   targetRenderer = NULL;
+   target = NULL;
+   sourceRenderer = NULL;
+   source = NULL;
+   font = NULL;
+
+   /* A 16x16 synthetic glyph, with a gray ramp */
+   glyphBuffer = new Uint8[16 * 16];
+   for(int i = 0; i < 16 * 16; i++)
+   {
+      glyphBuffer[i] = (Uint8) ((i * 7) % 256);
+   }
+   memset(&glyph, 0, sizeof(FT_Bitmap));
+   glyph.rows = 16;
+   glyph.width = 16;
+   glyph.pitch = 16;
+   glyph.buffer = glyphBuffer;
+   glyph.pixel_mode = FT_PIXEL_MODE_GRAY;
+
+   createCases();
+}
+
+/************************************************************************
+ *                               Destructor                             *
+ ************************************************************************/
+FarsoMicroBench::~FarsoMicroBench()
+{
+   finish();
+   delete[] glyphBuffer;
+}
+
+/************************************************************************
+ *                               createCases                            *
+ ************************************************************************/
+void FarsoMicroBench::createCases()
+{
+   const int sizes[] = { 8, 64, 256 };
+   const int fontSizes[] = { 10, 16, 32 };
+   const int outlines[] = { 0, 2 };
+
+   Case c;
+   c.outline = 0;
+   c.script = -1;
+
+   /* Draw primitives, by size */
+   for(int k = KERNEL_LINE; k <= KERNEL_FREETYPE_STAMP; k++)
+   {
+      c.kernel = (Kernel) k;
+      for(int s = 0; s < 3; s++)
+      {
+         c.size = (k == KERNEL_FREETYPE_STAMP) ? 16 : sizes[s];
+         cases.push_back(c);
+         if(k == KERNEL_FREETYPE_STAMP)
+         {
+            /* Glyph has a fixed size */
+            break;
+         }
+      }
+   }
+
+   /* Font functions, by size, outline and script */
+   for(int k = KERNEL_FONT_WRITE; k <= KERNEL_FONT_GET_WHILE_FITS; k++)
+   {
+      c.kernel = (Kernel) k;
+      for(int s = 0; s < 3; s++)
+      {
+         c.size = fontSizes[s];
+         for(int o = 0; o < 2; o++)
+         {
+            /* Note: getWhileFits doesn't take outlines */
+            if((k == KERNEL_FONT_GET_WHILE_FITS) && (o > 0))
+            {
+               continue;
+            }
+            c.outline = outlines[o];
+            for(int t = 0; t < FARSO_MICROBENCH_TOTAL_SCRIPTS; t++)
+            {
+               c.script = t;
+               cases.push_back(c);
+            }
+         }
+      }
+   }
+}
+
+/************************************************************************
+ *                                   init                               *
+ ************************************************************************/
+bool FarsoMicroBench::init(Backend backend)
+{
+   if(backend == BACKEND_SDL)
+   {
+      /* A software renderer to a surface, thus no window is needed */
+      sdlTarget = SDL_CreateRGBSurface(0, FARSO_MICROBENCH_TARGET_SIZE,
+            FARSO_MICROBENCH_TARGET_SIZE, 32, 0, 0, 0, 0);
+      sdlRenderer = (sdlTarget) ? SDL_CreateSoftwareRenderer(sdlTarget) : 
+                                  NULL;
+      if(!sdlRenderer)
+      {
+         Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+               "Error: couldn't create SDL software renderer: %s", 
+               SDL_GetError());
+         return false;
+      }
+      renderer = new Farso::SDLRenderer(sdlRenderer);
+   }
+   else
+   {
+      renderer = new Farso::MemoryRenderer();
+   }
+
+   Farso::Controller::init(&loader, renderer, FARSO_MICROBENCH_TARGET_SIZE,
+         FARSO_MICROBENCH_TARGET_SIZE, 32, "data/gui/");
+   font = Farso::FontManager::setDefaultFont(
+         "fonts/LiberationSans-Regular.ttf");
+
+   /* Create our target and a semi-transparent pattern to stamp */
+   Farso::Draw* draw = Farso::Controller::getDraw();
+   targetRenderer = Farso::Controller::createNewWidgetRenderer(
+         FARSO_MICROBENCH_TARGET_SIZE, FARSO_MICROBENCH_TARGET_SIZE, false);
+   target = targetRenderer->getSurface();
+   sourceRenderer = Farso::Controller::createNewWidgetRenderer(32, 32, 
+         false);
+   source = sourceRenderer->getSurface();
+   source->lock();
+   for(int y = 0; y < 32; y++)
+   {
+      for(int x = 0; x < 32; x++)
+      {
+         draw->setActiveColor(x * 8, y * 8, 128, (x + y) * 4);
+         draw->setPixel(source, x, y);
+      }
+   }
+   source->unlock();
+
+   return true;
+}
+
+/************************************************************************
+ *                                  finish                              *
+ ************************************************************************/
+void FarsoMicroBench::finish()
+{
+   if(renderer != NULL)
+   {
+      delete targetRenderer;
+      delete sourceRenderer;
+      targetRenderer = NULL;
+      sourceRenderer = NULL;
+      target = NULL;
+      source = NULL;
+      font = NULL;
+
+      Farso::Controller::finish();
+      delete renderer;
+      renderer = NULL;
+   }
+   if(sdlRenderer != NULL)
+   {
+      SDL_DestroyRenderer(sdlRenderer);
+      sdlRenderer = NULL;
+   }
+   if(sdlTarget != NULL)
+   {
+      SDL_FreeSurface(sdlTarget);
+      sdlTarget = NULL;
+   }
+}
+
+/************************************************************************
+ *                              getKernelName                           *
+ ************************************************************************/
+const char* FarsoMicroBench::getKernelName(Kernel kernel)
+{
+   switch(kernel)
+   {
+      case KERNEL_LINE:
+         return "doLine";
+      case KERNEL_ANTI_ALIASED_LINE:
+         return "doAntiAliasedLine";
+      case KERNEL_ROUNDED_RECTANGLE:
+         return "doRoundedRectangle";
+      case KERNEL_FILLED_TRIANGLE:
+         return "doFilledTriangle";
+      case KERNEL_CIRCLE:
+         return "doCircle";
+      case KERNEL_FILLED_CIRCLE:
+         return "doFilledCircle";
+      case KERNEL_FILLED_ROUNDED_RECTANGLE:
+         return "doFilledRoundedRectangle";
+      case KERNEL_STAMP_FILL:
+         return "doStampFill";
+      case KERNEL_FREETYPE_STAMP:
+         return "doFreeTypeStamp";
+      case KERNEL_FONT_WRITE:
+         return "Font::write";
+      case KERNEL_FONT_GET_WIDTH:
+         return "Font::getWidth";
+      case KERNEL_FONT_GET_WHILE_FITS:
+         return "Font::getWhileFits";
+      default:
+      break;
+   }
+   return "unknown";
+}
+
+/************************************************************************
+ *                              isGlyphKernel                           *
+ ************************************************************************/
+bool FarsoMicroBench::isGlyphKernel(Kernel kernel)
+{
+   return kernel >= KERNEL_FONT_WRITE;
+}
+
+/************************************************************************
+ *                               countGlyphs                            *
+ ************************************************************************/
+size_t FarsoMicroBench::countGlyphs(const Kobold::String& text)
+{
+   /* Count all but UTF-8 continuation bytes */
+   size_t total = 0;
+   for(size_t i = 0; i < text.length(); i++)
+   {
+      if((((Uint8) text[i]) & 0xC0) != 0x80)
+      {
+         total++;
+      }
+   }
+   return total;
+}
+
+/************************************************************************
+ *                                callKernel                            *
+ ************************************************************************/
+size_t FarsoMicroBench::callKernel(const Case& c, int iteration)
+{
+   Farso::Draw* draw = Farso::Controller::getDraw();
+
+   /* Vary the position, keeping the primitive inside the target */
+   int limit = FARSO_MICROBENCH_TARGET_SIZE - c.size - 1;
+   int x = (iteration * 13) % limit;
+   int y = (iteration * 29) % limit;
+   int s = c.size - 1;
+
+   switch(c.kernel)
+   {
+      case KERNEL_LINE:
+         draw->doLine(target, x, y, x + s, y + s / 2);
+         return c.size;
+      case KERNEL_ANTI_ALIASED_LINE:
+         draw->doAntiAliasedLine(target, x, y, x + s, y + s / 2);
+         return c.size;
+      case KERNEL_ROUNDED_RECTANGLE:
+         draw->doRoundedRectangle(target, x, y, x + s, y + s, 
+               Farso::Color(10, 20, 30, 255));
+         return 4 * c.size;
+      case KERNEL_FILLED_TRIANGLE:
+         draw->doFilledTriangle(target, x, y, x + s, y + s, x, y + s);
+         return (c.size * c.size) / 2;
+      case KERNEL_CIRCLE:
+         draw->doCircle(target, x + c.size / 2, y + c.size / 2, c.size / 2);
+         return (size_t) (M_PI * c.size);
+      case KERNEL_FILLED_CIRCLE:
+         draw->doFilledCircle(target, x + c.size / 2, y + c.size / 2, 
+               c.size / 2);
+         return (size_t) (M_PI * c.size * c.size / 4);
+      case KERNEL_FILLED_ROUNDED_RECTANGLE:
+         draw->doFilledRoundedRectangle(target, x, y, x + s, y + s, 
+               c.size / 4, true);
+         return c.size * c.size;
+      case KERNEL_STAMP_FILL:
+         draw->doStampFill(target, x, y, x + s, y + s, source, 0, 0, 31, 31);
+         return c.size * c.size;
+      case KERNEL_FREETYPE_STAMP:
+         draw->doFreeTypeStamp(target, x, y + 16, &glyph, 0, 16);
+         return 16 * 16;
+      case KERNEL_FONT_WRITE:
+      {
+         Kobold::String text = benchScripts[c.script];
+         int ty = y % (FARSO_MICROBENCH_TARGET_SIZE - c.size * 2);
+         Farso::Rect area(0, ty, FARSO_MICROBENCH_TARGET_SIZE - 1, 
+               ty + c.size * 2 - 1);
+         font->write(target, area, text, Farso::Color(0, 0, 0, 255), 
+               c.outline);
+         return countGlyphs(text);
+      }
+      case KERNEL_FONT_GET_WIDTH:
+      {
+         Kobold::String text = benchScripts[c.script];
+         font->getWidth(text, c.outline);
+         return countGlyphs(text);
+      }
+      case KERNEL_FONT_GET_WHILE_FITS:
+      {
+         Kobold::String text = benchScripts[c.script];
+         Kobold::String fit, wontFit;
+         bool brokeOnSpace = false;
+         font->getWhileFits(text, fit, wontFit, 
+               FARSO_MICROBENCH_TARGET_SIZE / 4, brokeOnSpace);
+         return countGlyphs(text);
+      }
+      default:
+      break;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ *                                  measure                             *
+ ************************************************************************/
+void FarsoMicroBench::measure(Backend backend, const Case& c)
+{
+   Farso::Draw* draw = Farso::Controller::getDraw();
+   draw->setActiveColor(200, 100, 50, 255);
+   font->setSize((c.size > 0) ? c.size : 10);
+
+   Result result;
+   result.backend = backend;
+   result.measured = c;
+   result.calls = 0;
+   result.units = 0;
+   result.ms = 0.0;
+
+   double freq = (double) SDL_GetPerformanceFrequency();
+
+   target->lock();
+
+   /* Warm up (caches, glyphs, etc) */
+   callKernel(c, 0);
+
+   /* Run batches until reaching the minimum time */
+   int batch = 16;
+   while(result.ms < FARSO_MICROBENCH_MIN_TIME_MS)
+   {
+      Uint64 start = SDL_GetPerformanceCounter();
+      for(int i = 0; i < batch; i++)
+      {
+         result.units += callKernel(c, result.calls + i);
+      }
+      result.ms += (1000.0 * (SDL_GetPerformanceCounter() - start)) / freq;
+      result.calls += batch;
+      batch *= 2;
+   }
+
+   target->unlock();
+
+   results.push_back(result);
+}
+
+/************************************************************************
+ *                                    run                               *
+ ************************************************************************/
+void FarsoMicroBench::run()
+{
+   for(int b = 0; b < TOTAL_BACKENDS; b++)
+   {
+      if(init((Backend) b))
+      {
+         for(size_t c = 0; c < cases.size(); c++)
+         {
+            measure((Backend) b, cases[c]);
+         }
+      }
+      finish();
+   }
+}
+
+/************************************************************************
+ *                               writeResults                           *
+ ************************************************************************/
+void FarsoMicroBench::writeResults(FILE* file)
+{
+   fprintf(file, "{\n   \"version\" : \"%s\",\n", FARSO_VERSION);
+   fprintf(file, "   \"blend_span\" : \"%s\",\n", 
+         Farso::BlendSpan::getImplementationName(
+            Farso::BlendSpan::getImplementation()));
+   fprintf(file, "   \"results\" :\n   [\n");
+
+   for(size_t i = 0; i < results.size(); i++)
+   {
+      Result& res = results[i];
+      bool glyphs = isGlyphKernel(res.measured.kernel);
+      double perSecond = (res.ms > 0.0) ? (res.units * 1000.0) / res.ms : 0.0;
+
+      fprintf(file, "      {\n");
+      fprintf(file, "         \"backend\" : \"%s\",\n", 
+            (res.backend == BACKEND_SDL) ? "sdl" : "memory");
+      fprintf(file, "         \"kernel\" : \"%s\",\n", 
+            getKernelName(res.measured.kernel));
+      fprintf(file, "         \"size\" : %d,\n", res.measured.size);
+      if(glyphs)
+      {
+         fprintf(file, "         \"outline\" : %d,\n", res.measured.outline);
+         fprintf(file, "         \"script\" : \"%s\",\n", 
+               benchScriptNames[res.measured.script]);
+      }
+      fprintf(file, "         \"calls\" : %zu,\n", res.calls);
+      fprintf(file, "         \"ms\" : %.3f,\n", res.ms);
+      fprintf(file, "         \"%s_per_s\" : %.0f\n", 
+            (glyphs) ? "glyphs" : "pixels", perSecond);
+      fprintf(file, "      }%s\n", (i < results.size() - 1) ? "," : "");
+   }
+
+   fprintf(file, "   ]\n}\n");
+}
+
+/*********************************************************************
+ *                           Main Code                               *
+ *********************************************************************/
+int main(int argc, char **argv)
+{
+   /* Usage: farso-microbench [output.json] */
+   FarsoMicroBench* bench = new FarsoMicroBench();
+   bench->run();
+
+   FILE* file = (argc > 1) ? fopen(argv[1], "w") : stdout;
+   if(file != NULL)
+   {
+      bench->writeResults(file);
+      if(file != stdout)
+      {
+         fclose(file);
+      }
+   }
+
+   delete bench;
+
+   return 0;
+}
+
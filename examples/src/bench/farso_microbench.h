@@ -0,0 +1,131 @@
+#ifndef _farso_microbench_h
+#define _farso_microbench_h
+
+#include "../../../src/controller.h"
+#include "../../../src/loader.h"
+
+#include <kobold/log.h>
+#include <SDL2/SDL.h>
+
+#include <stdio.h>
+#include <vector>
+
+namespace FarsoExample
+{
+
+/*! Minimum time, in milliseconds, to run each case */
+#define FARSO_MICROBENCH_MIN_TIME_MS     200.0
+/*! Width and height of the target surface */
+#define FARSO_MICROBENCH_TARGET_SIZE       512
+
+/*! Micro-benchmark of Draw primitives and Font rendering, measuring
+ * each kernel throughput (pixels/s or glyphs/s) in isolation, on both
+ * MemoryDraw and SDLDraw (the last with a SDL software renderer). No
+ * window is needed. Results are reported as JSON. */
+class FarsoMicroBench
+{
+   public:
+      /*! Measured kernels */
+      enum Kernel
+      {
+         KERNEL_LINE = 0,
+         KERNEL_ANTI_ALIASED_LINE,
+         KERNEL_ROUNDED_RECTANGLE,
+         KERNEL_FILLED_TRIANGLE,
+         KERNEL_CIRCLE,
+         KERNEL_FILLED_CIRCLE,
+         KERNEL_FILLED_ROUNDED_RECTANGLE,
+         KERNEL_STAMP_FILL,
+         KERNEL_FREETYPE_STAMP,
+         KERNEL_FONT_WRITE,
+         KERNEL_FONT_GET_WIDTH,
+         KERNEL_FONT_GET_WHILE_FITS,
+         TOTAL_KERNELS
+      };
+
+      /*! Backends to measure */
+      enum Backend
+      {
+         BACKEND_MEMORY = 0,
+         BACKEND_SDL,
+         TOTAL_BACKENDS
+      };
+
+      /*! Constructor */
+      FarsoMicroBench();
+      /*! Destructor */
+      ~FarsoMicroBench();
+
+      /*! Run all kernels on all backends */
+      void run();
+
+      /*! Write the results, as JSON, to a file */
+      void writeResults(FILE* file);
+
+   private:
+      /*! A case to measure */
+      struct Case
+      {
+         Kernel kernel; /**< Kernel to measure */
+         int size; /**< Primitive size, in pixels, or font size, in pt */
+         int outline; /**< Font outline */
+         int script; /**< Index of the text script, or -1 */
+      };
+
+      /*! Result of a case */
+      struct Result
+      {
+         Backend backend; /**< Backend used */
+         Case measured; /**< Measured case */
+         size_t calls; /**< Number of kernel calls */
+         size_t units; /**< Total pixels or glyphs processed */
+         double ms; /**< Total time, in milliseconds */
+      };
+
+      /*! Init the Controller with a backend */
+      bool init(Backend backend);
+      /*! Finish the Controller and free the current backend */
+      void finish();
+
+      /*! Define all cases to measure */
+      void createCases();
+
+      /*! Measure a case, at current backend */
+      void measure(Backend backend, const Case& c);
+
+      /*! Call the kernel of a case once.
+       * \param c the case
+       * \param iteration current iteration, to vary positions
+       * \return number of pixels or glyphs processed by the call */
+      size_t callKernel(const Case& c, int iteration);
+
+      /*! \return the name of a kernel */
+      const char* getKernelName(Kernel kernel);
+      /*! \return if the kernel throughput is in glyphs (or pixels) */
+      bool isGlyphKernel(Kernel kernel);
+
+      /*! \return number of UTF-8 characters of a string */
+      size_t countGlyphs(const Kobold::String& text);
+
+      Kobold::DefaultLog log; /**< Log used */
+      Farso::DefaultLoader loader; /**< Loader used */
+      Farso::Renderer* renderer; /**< Current renderer */
+      SDL_Surface* sdlTarget; /**< Target of the SDL software renderer */
+      SDL_Renderer* sdlRenderer; /**< SDL software renderer */
+
+      Farso::WidgetRenderer* targetRenderer; /**< Owner of target */
+      Farso::Surface* target; /**< Surface to draw to */
+      Farso::WidgetRenderer* sourceRenderer; /**< Owner of source */
+      Farso::Surface* source; /**< Surface to stamp from */
+      FT_Bitmap glyph; /**< Synthetic glyph bitmap to stamp */
+      Uint8* glyphBuffer; /**< Synthetic glyph pixels */
+      Farso::Font* font; /**< Font used */
+
+      std::vector<Case> cases; /**< Cases to measure */
+      std::vector<Result> results; /**< Measured results */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,203 @@
+
+#include "opengl3_example.h"
+
+#include <kobold/keyboard.h>
+#include <kobold/mouse.h>
+#include <SDL2/SDL_opengl.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../size.h"
+#include "../../../src/controller.h"
+
+using namespace FarsoExample;
+
+#define NORMAL_FPS 35       /**< Minimun FPS to the engine runs smooth */
+#define UPDATE_RATE (1000 / NORMAL_FPS) /**< Update Rate in ms */
+
+/************************************************************************
+ *                             OpenGL3Example                           *
+ ************************************************************************/
+OpenGL3Example::OpenGL3Example(int maxFrames)
+{
+   this->maxFrames = maxFrames;
+   window = NULL;
+   glcontext = NULL;
+   renderer = NULL;
+   example = NULL;
+   Kobold::Log::init(&log);
+
+   /* Try to init SDL */
+   if( SDL_Init(SDL_INIT_VIDEO) < 0)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "ERROR: Couldn't init SDL");
+      exit(-1);
+   }
+
+   /* Ask for an OpenGL 3.3 core profile context */
+   SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, 
+         SDL_GL_CONTEXT_PROFILE_CORE);
+   SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+   SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+   SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+   /* Try to create our window */
+   window = SDL_CreateWindow("farso_opengl3_example", 
+         SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 
+         FARSO_EXAMPLE_WINDOW_WIDTH, FARSO_EXAMPLE_WINDOW_HEIGHT, 
+         SDL_WINDOW_OPENGL);
+   if(window == NULL)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+           "Couldn't create SDL Window!");
+      SDL_Quit();
+      exit(-2);
+   }
+
+   /* Define OpenGL Context */
+   glcontext = SDL_GL_CreateContext(window);
+   if(glcontext == NULL)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Couldn't create an OpenGL 3.3 core profile context: %s",
+            SDL_GetError());
+      return;
+   }
+   Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, "OpenGL: %s (%s)",
+         (const char*) glGetString(GL_VERSION), 
+         (const char*) glGetString(GL_RENDERER));
+
+   /* Create farso renderer */
+   renderer = new Farso::OpenGL3Renderer();
+   if(!renderer->isValid())
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Couldn't initialize the OpenGL 3.3 renderer!");
+   }
+}
+
+/************************************************************************
+ *                            ~OpenGL3Example                           *
+ ************************************************************************/
+OpenGL3Example::~OpenGL3Example()
+{
+   if(example != NULL)
+   {
+      delete example;
+   }
+   if(renderer != NULL)
+   {
+      delete renderer;
+   }
+   if(glcontext != NULL)
+   {
+      SDL_GL_DeleteContext(glcontext);
+   }
+   if(window != NULL)
+   {
+      SDL_DestroyWindow(window);
+      window = NULL;
+   }
+
+   SDL_Quit();
+}
+
+/************************************************************************
+ *                                isValid                               *
+ ************************************************************************/
+bool OpenGL3Example::isValid()
+{
+   return (renderer != NULL) && (renderer->isValid());
+}
+
+/************************************************************************
+ *                                   run                                *
+ ************************************************************************/
+void OpenGL3Example::run()
+{
+   Uint32 lastTime = 0;
+   Uint32 time;
+   int frames = 0;
+
+   example = new Example();
+   example->init(&loader, renderer);
+
+   while((!example->shouldQuit()) && 
+         ((maxFrames == 0) || (frames < maxFrames)))
+   {
+      time = SDL_GetTicks();
+      if(time - lastTime >= UPDATE_RATE)
+      {
+         lastTime = time;
+
+         /* Get Keyboard and Mouse State */
+         SDL_PumpEvents();
+         Kobold::Keyboard::updateState();
+         Kobold::Mouse::update();
+
+         /* Let's update things by events (usually, only used for text 
+          * editing and mouse release states) */
+         SDL_Event event;
+         while(SDL_PollEvent(&event))
+         {
+            if(Kobold::Keyboard::isEditingText())
+            {
+               Kobold::Keyboard::updateByEvent(event);
+            }
+            Kobold::Mouse::updateByEvent(event);
+         }
+
+         glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+
+         example->step(Kobold::Mouse::isLeftButtonPressed(), 
+               Kobold::Mouse::isRightButtonPressed(),
+               Kobold::Mouse::getX(), Kobold::Mouse::getY());
+
+         /* Note: a core profile double buffered context must present 
+          * every frame, as the back buffer is cleared above. */
+         SDL_GL_SwapWindow(window);
+         frames++;
+      }
+      else if((UPDATE_RATE-1) - (time - lastTime) > 0 )
+      {
+         /* Must sleep a little */
+         SDL_Delay((UPDATE_RATE-1) - (time - lastTime) );
+      }
+   }
+
+   GLenum error = glGetError();
+   Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+         "Rendered %d frames (OpenGL error: 0x%x)", frames, error);
+}
+
+/*********************************************************************
+ *                           Main Code                               *
+ *********************************************************************/
+int main(int argc, char **argv)
+{
+   /* --frames N: quit after rendering N frames */
+   int maxFrames = 0;
+   for(int i = 1; i < argc - 1; i++)
+   {
+      if(strcmp(argv[i], "--frames") == 0)
+      {
+         maxFrames = atoi(argv[i + 1]);
+      }
+   }
+
+   OpenGL3Example* example = new OpenGL3Example(maxFrames);
+   int res = 0;
+   if(example->isValid())
+   {
+      example->run();
+   }
+   else
+   {
+      res = 1;
+   }
+   delete example;
+
+   return res;
+}
+
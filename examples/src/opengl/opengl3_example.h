@@ -0,0 +1,53 @@
+
+#ifndef _farso_opengl3_example_h
+#define _farso_opengl3_example_h
+
+#include <SDL2/SDL.h>
+#include <kobold/log.h>
+
+#include "../common.h"
+#include "../../../src/opengl/opengl3renderer.h"
+#include "../../../src/loader.h"
+
+namespace FarsoExample
+{
+
+/*! The usual example, but rendered by OpenGL3Renderer on an OpenGL 3.3
+ * core profile context. Runs on software implementations too (for 
+ * example, with LIBGL_ALWAYS_SOFTWARE=1 on Mesa). */
+class OpenGL3Example
+{
+    public:
+       /*! Constructor
+        * \param maxFrames frames to render before quitting, or 0 to run
+        *        until the user quits (used for smoke tests). */
+       OpenGL3Example(int maxFrames);
+       ~OpenGL3Example();
+
+       /*! \return if the core profile context and its renderer were 
+        *          created (if not, errors were already logged). */
+       bool isValid();
+
+       void run();
+
+    private:
+       /*! The window used */
+       SDL_Window* window;
+       /*! Our OpenGL context */
+       SDL_GLContext glcontext;
+       /*! Default log to use */
+       Kobold::DefaultLog log;
+
+       Farso::DefaultLoader loader;
+       Farso::OpenGL3Renderer* renderer;
+
+       /*! The example itself */
+       Example* example;
+       /*! Frames to render before quitting (0 for no limit) */
+       int maxFrames;
+};
+
+}
+
+#endif
+
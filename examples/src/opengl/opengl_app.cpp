@@ -7,6 +7,7 @@
 #include <SDL2/SDL_opengl.h>
 
 #include "../size.h"
+#include "../../../src/controller.h"
 
 using namespace FarsoExample;
 
@@ -93,8 +94,14 @@ void OpenGLApp::run()
          /* Let's update things by events (usually, only used for text 
           * editing and mouse release states) */
          SDL_Event event;
+         bool forcePresent = false;
          while(SDL_PollEvent(&event))
          {
+            if(event.type == SDL_WINDOWEVENT)
+            {
+               /* Window exposed, resized, etc: must present again */
+               forcePresent = true;
+            }
             if(Kobold::Keyboard::isEditingText())
             {
                Kobold::Keyboard::updateByEvent(event);
@@ -109,7 +116,12 @@ void OpenGLApp::run()
               Kobold::Mouse::getX(), Kobold::Mouse::getY());
 
          glFlush();
-         SDL_GL_SwapWindow(window);
+
+         /* Only need to swap if anything changed */
+         if((forcePresent) || (Farso::Controller::needsPresent()))
+         {
+            SDL_GL_SwapWindow(window);
+         }
       }
       else if((UPDATE_RATE-1) - (time - lastTime) > 0 )
       {
@@ -7,6 +7,7 @@
 #include <SDL2/SDL_opengl.h>
 
 #include "../size.h"
+#include "../../../src/controller.h"
 
 using namespace FarsoExample;
 
@@ -91,8 +92,14 @@ void SDLApp::run()
          /* Let's update things by events (usually, only used for text 
           * editing and mouse release states) */
          SDL_Event event;
+         bool forcePresent = false;
          while(SDL_PollEvent(&event))
          {
+            if(event.type == SDL_WINDOWEVENT)
+            {
+               /* Window exposed, resized, etc: must present again */
+               forcePresent = true;
+            }
             if(Kobold::Keyboard::isEditingText())
             {
                Kobold::Keyboard::updateByEvent(event);
@@ -107,7 +114,11 @@ void SDLApp::run()
               Kobold::Mouse::isRightButtonPressed(),
               Kobold::Mouse::getX(), Kobold::Mouse::getY());
 
-         SDL_RenderPresent(sdlRenderer);
+         /* Only need to present if anything changed */
+         if((forcePresent) || (Farso::Controller::needsPresent()))
+         {
+            SDL_RenderPresent(sdlRenderer);
+         }
       }
       else if((UPDATE_RATE-1) - (time - lastTime) > 0 )
       {
@@ -0,0 +1,118 @@
+
+#include "sdl_hittest_bench.h"
+#include "../size.h"
+#include <kobold/log.h>
+
+using namespace FarsoExample;
+
+/************************************************************************
+ *                            SDLHitTestBench                           *
+ ************************************************************************/
+SDLHitTestBench::SDLHitTestBench()
+{
+   done = false;
+}
+
+/************************************************************************
+ *                           ~SDLHitTestBench                           *
+ ************************************************************************/
+SDLHitTestBench::~SDLHitTestBench()
+{
+   Farso::Controller::finish();
+}
+
+/************************************************************************
+ *                                   init                               *
+ ************************************************************************/
+void SDLHitTestBench::init()
+{
+   Farso::Controller::init(&loader, renderer, FARSO_EXAMPLE_WINDOW_WIDTH,
+         FARSO_EXAMPLE_WINDOW_HEIGHT, 32, "data/gui/");
+   Farso::FontManager::setDefaultFont("fonts/LiberationSans-Regular.ttf");
+   Farso::Controller::loadSkin("skins/clean.skin");
+
+   /* A window full of small buttons */
+   Farso::Window* window = new Farso::Window(FARSO_EXAMPLE_WINDOW_WIDTH - 24,
+         FARSO_EXAMPLE_WINDOW_HEIGHT - 24, "HitTest");
+   Farso::Container* cont = new Farso::Container(
+         Farso::Container::TYPE_TOP_LEFT, window);
+
+   int columns = 100;
+   int buttonWidth = (cont->getBody().getWidth() - 1) / columns;
+   int rows = HITTEST_BENCH_TOTAL_WIDGETS / columns;
+   int buttonHeight = (cont->getBody().getHeight() - 1) / rows;
+   for(int i = 0; i < HITTEST_BENCH_TOTAL_WIDGETS; i++)
+   {
+      new Farso::Button((i % columns) * buttonWidth, 
+            (i / columns) * buttonHeight, buttonWidth, buttonHeight, 
+            "", cont);
+   }
+   window->open();
+
+   /* Let's draw all at least once, before measuring. */
+   Farso::Controller::verifyEvents(false, false, 0, 0);
+}
+
+/************************************************************************
+ *                                shouldQuit                            *
+ ************************************************************************/
+bool SDLHitTestBench::shouldQuit()
+{
+   return done;
+}
+
+/************************************************************************
+ *                                  sweep                               *
+ ************************************************************************/
+double SDLHitTestBench::sweep(bool useIndex)
+{
+   Farso::Controller::setHitTestIndexEnabled(useIndex);
+
+   Uint64 total = 0;
+   for(int s = 0; s < HITTEST_BENCH_SWEEPS; s++)
+   {
+      for(int i = 0; i < HITTEST_BENCH_SWEEP_STEPS; i++)
+      {
+         /* Zig-zag the cursor over the window */
+         int x = (i * 7) % FARSO_EXAMPLE_WINDOW_WIDTH;
+         int y = (i * FARSO_EXAMPLE_WINDOW_HEIGHT) / HITTEST_BENCH_SWEEP_STEPS;
+
+         Uint64 start = SDL_GetPerformanceCounter();
+         Farso::Controller::verifyEvents(false, false, x, y);
+         total += SDL_GetPerformanceCounter() - start;
+      }
+   }
+
+   return (1000.0 * total) / (SDL_GetPerformanceFrequency() * 
+         (double)(HITTEST_BENCH_SWEEPS * HITTEST_BENCH_SWEEP_STEPS));
+}
+
+/************************************************************************
+ *                                   step                               *
+ ************************************************************************/
+void SDLHitTestBench::step(bool leftButtonPressed, bool rightButtonPressed,
+      int mouseX, int mouseY)
+{
+   double fullWalk = sweep(false);
+   double indexed = sweep(true);
+
+   Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+         "HitTest with %d widgets: full walk %.4fms, indexed %.4fms per call",
+         HITTEST_BENCH_TOTAL_WIDGETS, fullWalk, indexed);
+   Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+         "Controller locks acquired per frame: %u",
+         Farso::Controller::getLastFrameLockCount());
+
+   done = true;
+}
+
+/*********************************************************************
+ *                           Main Code                               *
+ *********************************************************************/
+int main(int argc, char **argv)
+{
+   SDLHitTestBench* bench = new SDLHitTestBench();
+   bench->run();
+   delete bench;
+}
+
@@ -0,0 +1,46 @@
+
+#ifndef _farso_sdl_hittest_bench_h
+#define _farso_sdl_hittest_bench_h
+
+#include "../../../src/controller.h"
+
+#include "sdl_app.h"
+
+namespace FarsoExample
+{
+
+/*! Number of widgets to create for the benchmark */
+#define HITTEST_BENCH_TOTAL_WIDGETS  5000
+/*! Number of cursor positions checked by each sweep */
+#define HITTEST_BENCH_SWEEP_STEPS    2000
+/*! Number of sweeps for each mode */
+#define HITTEST_BENCH_SWEEPS           10
+
+/*! A simple benchmark of mouse hover hit testing, with a window full of
+ * widgets, comparing the time spent on Controller::verifyEvents with and 
+ * without the WidgetIndex. */
+class SDLHitTestBench : public SDLApp
+{
+    public:
+       SDLHitTestBench();
+       ~SDLHitTestBench();
+
+       void init();
+
+       bool shouldQuit();
+
+       void step(bool leftButtonPressed, bool rightButtonPressed,
+             int mouseX, int mouseY);
+
+    private:
+       /*! Do the hover sweeps, with the index enabled or not.
+        * \return average time, in milliseconds, of each verifyEvents call */
+       double sweep(bool useIndex);
+
+       bool done; /**< If done with the benchmark */
+};
+
+}
+
+#endif
+
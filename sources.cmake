@@ -1,4 +1,6 @@
 set(FARSO_SOURCES
+src/atlaspacker.cpp
+src/blendspan.cpp
 src/button.cpp
 src/checkbox.cpp
 src/clickablepicture.cpp
@@ -11,6 +13,7 @@ src/draw.cpp
 src/event.cpp
 src/fileselector.cpp
 src/font.cpp
+src/framestats.cpp
 src/grid.cpp
 src/label.cpp
 src/labelledpicture.cpp
@@ -18,28 +21,40 @@ src/loader.cpp
 src/menu.cpp
 src/picture.cpp
 src/progressbar.cpp
+src/rasterpool.cpp
 src/rect.cpp
 src/renderer.cpp
 src/scrollbar.cpp
 src/scrolltext.cpp
 src/skin.cpp
+src/skinelementcache.cpp
 src/spin.cpp
 src/stacktab.cpp
 src/surface.cpp
 src/textentry.cpp
 src/textselector.cpp
+src/trace.cpp
 src/treeview.cpp
 src/widget.cpp
+src/widgetcommand.cpp
 src/widgetjsonparser.cpp
 src/widgetrenderer.cpp
+src/widgetindex.cpp
 src/window.cpp
 src/sdl/sdlsurface.cpp
 src/sdl/sdldraw.cpp
 src/sdl/sdlrenderer.cpp
 src/sdl/sdlwidgetrenderer.cpp
+src/memory/memorydraw.cpp
+src/memory/memoryimagedecoder.cpp
+src/memory/memoryrenderer.cpp
+src/memory/memorysurface.cpp
+src/memory/memorywidgetrenderer.cpp
 )
 
 set(FARSO_HEADERS
+src/atlaspacker.h
+src/blendspan.h
 src/button.h
 src/checkbox.h
 src/clickablepicture.h
@@ -53,49 +68,73 @@ src/event.h
 src/eventtype.h
 src/fileselector.h
 src/font.h
+src/framestats.h
 src/grid.h
 src/label.h
 src/labelledpicture.h
 src/loader.h
 src/menu.h
 src/picture.h
+src/pixelwriter.h
 src/progressbar.h
+src/rasterpool.h
 src/rect.h
 src/renderer.h
 src/scrollbar.h
 src/scrolltext.h
 src/skin.h
+src/skinelementcache.h
 src/spin.h
 src/stacktab.h
 src/surface.h
 src/textentry.h
 src/textselector.h
+src/trace.h
 src/treeview.h
 src/widget.h
+src/widgetcommand.h
 src/widgetjsonparser.h
 src/widgetrenderer.h
+src/widgetindex.h
 src/widgeteventlistener.h
 src/window.h
 src/sdl/sdlsurface.h
 src/sdl/sdldraw.h
 src/sdl/sdlrenderer.h
 src/sdl/sdlwidgetrenderer.h
+src/memory/memorydraw.h
+src/memory/memoryimagedecoder.h
+src/memory/memoryrenderer.h
+src/memory/memorysurface.h
+src/memory/memorywidgetrenderer.h
 )
 
 set(FARSO_FULL_SOURCES ${FARSO_SOURCES})
 set(FARSO_FULL_HEADERS ${FARSO_HEADERS})
 
 set(FARSO_OPENGL_SOURCES
+src/opengl/opengl3functions.cpp
+src/opengl/opengl3renderer.cpp
+src/opengl/opengl3uploadring.cpp
+src/opengl/opengl3widgetrenderer.cpp
+src/opengl/openglcompositor.cpp
 src/opengl/opengldraw.cpp
 src/opengl/openglrenderer.cpp
 src/opengl/openglsurface.cpp
+src/opengl/opengltextureatlas.cpp
 src/opengl/openglwidgetrenderer.cpp
 )
 
 set(FARSO_OPENGL_HEADERS 
+src/opengl/opengl3functions.h
+src/opengl/opengl3renderer.h
+src/opengl/opengl3uploadring.h
+src/opengl/opengl3widgetrenderer.h
+src/opengl/openglcompositor.h
 src/opengl/opengldraw.h
 src/opengl/openglrenderer.h
 src/opengl/openglsurface.h
+src/opengl/opengltextureatlas.h
 src/opengl/openglwidgetrenderer.h
 )
 
@@ -109,6 +148,7 @@ src/ogre3d/ogredraw.cpp
 src/ogre3d/ogreloader.cpp
 src/ogre3d/ogrerenderer.cpp
 src/ogre3d/ogresurface.cpp
+src/ogre3d/ogrestagingring.cpp
 src/ogre3d/ogrewidgetmovable.cpp
 src/ogre3d/ogrewidgetrenderable.cpp
 src/ogre3d/ogrewidgetrenderer.cpp
@@ -119,6 +159,7 @@ src/ogre3d/ogredraw.h
 src/ogre3d/ogreloader.h
 src/ogre3d/ogrerenderer.h
 src/ogre3d/ogresurface.h
+src/ogre3d/ogrestagingring.h
 src/ogre3d/ogrewidgetmovable.h
 src/ogre3d/ogrewidgetrenderable.h
 src/ogre3d/ogrewidgetrenderer.h
@@ -153,6 +194,27 @@ set(FARSO_SDL_EXAMPLE_HEADERS
 examples/src/sdl/sdl_example.h
 )
 
+set(FARSO_SDL_HITTEST_BENCH_SOURCES
+examples/src/sdl/sdl_hittest_bench.cpp
+)
+set(FARSO_SDL_HITTEST_BENCH_HEADERS
+examples/src/sdl/sdl_hittest_bench.h
+)
+
+set(FARSO_BENCH_SOURCES
+examples/src/bench/farso_bench.cpp
+)
+set(FARSO_BENCH_HEADERS
+examples/src/bench/farso_bench.h
+)
+
+set(FARSO_MICROBENCH_SOURCES
+examples/src/bench/farso_microbench.cpp
+)
+set(FARSO_MICROBENCH_HEADERS
+examples/src/bench/farso_microbench.h
+)
+
 set(FARSO_SDL_JSON_SOURCES
 examples/src/sdl/sdl_jsonloader.cpp
 )
@@ -182,6 +244,13 @@ set(FARSO_OPENGL_EXAMPLE_HEADERS
 examples/src/opengl/opengl_example.h
 )
 
+set(FARSO_OPENGL3_EXAMPLE_SOURCES
+examples/src/opengl/opengl3_example.cpp
+)
+set(FARSO_OPENGL3_EXAMPLE_HEADERS
+examples/src/opengl/opengl3_example.h
+)
+
 set(FARSO_OPENGL_JSON_SOURCES
 examples/src/opengl/opengl_jsonloader.cpp
 )
@@ -247,6 +316,12 @@ if(${OPENGL_FOUND})
                         ${FARSO_OPENGL_COMMON_HEADERS}
                         ${FARSO_OPENGL_EXAMPLE_HEADERS})
 
+   add_executable(farso_opengl3_example WIN32 
+                        ${FARSO_COMMON_EXAMPLE_SOURCES}
+                        ${FARSO_OPENGL3_EXAMPLE_SOURCES}
+                        ${FARSO_COMMON_EXAMPLE_HEADERS}
+                        ${FARSO_OPENGL3_EXAMPLE_HEADERS})
+
    if(${FARSO_HAS_RAPIDJSON})
       add_executable(farso_opengl_jsonloader WIN32 
                            ${FARSO_COMMON_EXAMPLE_SOURCES}
@@ -267,6 +342,7 @@ if(${OPENGL_FOUND})
                  m ${LIBINTL_LIBRARIES} pthread)
 
    target_link_libraries(farso_opengl_example ${LIBRARIES})
+   target_link_libraries(farso_opengl3_example ${LIBRARIES})
 
    if(${FARSO_HAS_RAPIDJSON})
       target_link_libraries(farso_opengl_jsonloader ${LIBRARIES})
@@ -290,6 +366,12 @@ if(${FARSO_BUILD_SDL_EXAMPLES})
                   ${FARSO_SDL_COMMON_HEADERS}
                   ${FARSO_SDL_EXAMPLE_HEADERS})
 
+   add_executable(farso_sdl_hittest_bench 
+                  ${FARSO_SDL_COMMON_SOURCES}
+                  ${FARSO_SDL_HITTEST_BENCH_SOURCES}
+                  ${FARSO_SDL_COMMON_HEADERS}
+                  ${FARSO_SDL_HITTEST_BENCH_HEADERS})
+
    if(${FARSO_HAS_RAPIDJSON})
       add_executable(farso_sdl_jsonloader WIN32 
                      ${FARSO_COMMON_EXAMPLE_SOURCES}
@@ -312,6 +394,7 @@ set(LIBRARIES farso
 if(${FARSO_BUILD_SDL_EXAMPLES})
 
    target_link_libraries(farso_sdl_example ${LIBRARIES})
+   target_link_libraries(farso_sdl_hittest_bench ${LIBRARIES})
 
    if(${FARSO_HAS_RAPIDJSON})
       target_link_libraries(farso_sdl_jsonloader ${LIBRARIES})
@@ -321,7 +404,32 @@ if(${FARSO_BUILD_SDL_EXAMPLES})
       COMMAND ${CMAKE_COMMAND} -E copy_directory
       ${CMAKE_SOURCE_DIR}/examples/data 
       $<TARGET_FILE_DIR:farso_sdl_example>/data)
+   add_custom_command(TARGET farso_sdl_hittest_bench PRE_BUILD
+      COMMAND ${CMAKE_COMMAND} -E copy_directory
+      ${CMAKE_SOURCE_DIR}/examples/data 
+      $<TARGET_FILE_DIR:farso_sdl_hittest_bench>/data)
    set(FARSO_HAS_EXAMPLE 1)
 
 endif(${FARSO_BUILD_SDL_EXAMPLES})
 
+
+# Headless scenario benchmark (needs RapidJSON to load its layouts)
+if((${FARSO_BUILD_BENCH}) AND (${FARSO_HAS_RAPIDJSON}))
+   add_executable(farso-bench ${FARSO_BENCH_SOURCES} ${FARSO_BENCH_HEADERS})
+   target_link_libraries(farso-bench ${LIBRARIES})
+   add_custom_command(TARGET farso-bench PRE_BUILD
+      COMMAND ${CMAKE_COMMAND} -E copy_directory
+      ${CMAKE_SOURCE_DIR}/examples/data 
+      $<TARGET_FILE_DIR:farso-bench>/data)
+endif((${FARSO_BUILD_BENCH}) AND (${FARSO_HAS_RAPIDJSON}))
+
+# Draw primitives and Font micro-benchmarks
+if(${FARSO_BUILD_BENCH})
+   add_executable(farso-microbench ${FARSO_MICROBENCH_SOURCES} 
+                  ${FARSO_MICROBENCH_HEADERS})
+   target_link_libraries(farso-microbench ${LIBRARIES})
+   add_custom_command(TARGET farso-microbench PRE_BUILD
+      COMMAND ${CMAKE_COMMAND} -E copy_directory
+      ${CMAKE_SOURCE_DIR}/examples/data 
+      $<TARGET_FILE_DIR:farso-microbench>/data)
+endif(${FARSO_BUILD_BENCH})
@@ -0,0 +1,171 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "atlaspacker.h"
+using namespace Farso;
+
+/***********************************************************************
+ *                             AtlasPacker                             *
+ ***********************************************************************/
+AtlasPacker::AtlasPacker(int width, int height)
+{
+   this->width = width;
+   this->height = height;
+   clear();
+}
+
+/***********************************************************************
+ *                            ~AtlasPacker                             *
+ ***********************************************************************/
+AtlasPacker::~AtlasPacker()
+{
+}
+
+/***********************************************************************
+ *                                clear                                *
+ ***********************************************************************/
+void AtlasPacker::clear()
+{
+   Segment first;
+   first.x = 0;
+   first.y = 0;
+   first.width = width;
+
+   skyline.clear();
+   skyline.push_back(first);
+   usedArea = 0;
+}
+
+/***********************************************************************
+ *                                 fit                                 *
+ ***********************************************************************/
+int AtlasPacker::fit(size_t index, int width, int height) const
+{
+   int x = skyline[index].x;
+   if(x + width > this->width)
+   {
+      return -1;
+   }
+
+   /* Must be over all segments it spans */
+   int y = 0;
+   int remaining = width;
+   for(size_t i = index; remaining > 0; i++)
+   {
+      if(skyline[i].y > y)
+      {
+         y = skyline[i].y;
+      }
+      if(y + height > this->height)
+      {
+         return -1;
+      }
+      remaining -= skyline[i].width;
+   }
+
+   return y;
+}
+
+/***********************************************************************
+ *                               insert                                *
+ ***********************************************************************/
+Rect AtlasPacker::insert(int width, int height)
+{
+   if((width <= 0) || (height <= 0))
+   {
+      return Rect();
+   }
+
+   /* Find the position with the lowest bottom (and, on ties, where the 
+    * rectangle better fits the segment) */
+   int bestBottom = this->height + 1;
+   int bestWidth = this->width + 1;
+   int bestY = -1;
+   size_t bestIndex = 0;
+   for(size_t i = 0; i < skyline.size(); i++)
+   {
+      int y = fit(i, width, height);
+      if((y >= 0) && ((y + height < bestBottom) || 
+         ((y + height == bestBottom) && (skyline[i].width < bestWidth))))
+      {
+         bestBottom = y + height;
+         bestWidth = skyline[i].width;
+         bestY = y;
+         bestIndex = i;
+      }
+   }
+
+   if(bestY < 0)
+   {
+      /* No space left */
+      return Rect();
+   }
+
+   int x = skyline[bestIndex].x;
+   addSegment(bestIndex, x, bestY, width, height);
+   usedArea += width * height;
+
+   return Rect(x, bestY, x + width - 1, bestY + height - 1);
+}
+
+/***********************************************************************
+ *                             addSegment                              *
+ ***********************************************************************/
+void AtlasPacker::addSegment(size_t index, int x, int y, 
+      int width, int height)
+{
+   Segment seg;
+   seg.x = x;
+   seg.y = y + height;
+   seg.width = width;
+   skyline.insert(skyline.begin() + index, seg);
+
+   /* Shrink (or remove) the segments now under the new one */
+   for(size_t i = index + 1; i < skyline.size(); )
+   {
+      int covered = (seg.x + seg.width) - skyline[i].x;
+      if(covered <= 0)
+      {
+         break;
+      }
+      if(covered < skyline[i].width)
+      {
+         skyline[i].x += covered;
+         skyline[i].width -= covered;
+         break;
+      }
+      skyline.erase(skyline.begin() + i);
+   }
+
+   /* Merge neighbour segments at the same height */
+   for(size_t i = 0; i + 1 < skyline.size(); )
+   {
+      if(skyline[i].y == skyline[i + 1].y)
+      {
+         skyline[i].width += skyline[i + 1].width;
+         skyline.erase(skyline.begin() + i + 1);
+      }
+      else
+      {
+         i++;
+      }
+   }
+}
+
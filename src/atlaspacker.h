@@ -0,0 +1,93 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_atlas_packer_h
+#define _farso_atlas_packer_h
+
+#include "farsoconfig.h"
+#include "rect.h"
+
+#include <stddef.h>
+#include <vector>
+
+namespace Farso
+{
+
+/*! A skyline rectangle packer: places rectangles inside a bigger one 
+ * (usually a texture atlas page), keeping just the 'skyline' formed by 
+ * the top of the already placed ones, and putting each new rectangle 
+ * where its bottom is the lowest possible (bottom-left rule).
+ * \note there's no removal of a single rectangle: to reclaim the space
+ *       of removed ones, clear the packer and insert the remaining 
+ *       rectangles again (ideally sorted by decreasing height). */
+class AtlasPacker
+{
+   public:
+      /*! Constructor
+       * \param width width of the area to pack into
+       * \param height height of the area to pack into */
+      AtlasPacker(int width, int height);
+      /*! Destructor */
+      ~AtlasPacker();
+
+      /*! Place a rectangle.
+       * \param width width of the rectangle to place
+       * \param height height of the rectangle to place
+       * \return the area where it was placed. Undefined if there's no 
+       *         space left for it. */
+      Rect insert(int width, int height);
+
+      /*! Remove all placed rectangles */
+      void clear();
+
+      /*! \return total area of the rectangles placed since last clear */
+      const int getUsedArea() const { return usedArea; };
+
+      /*! \return packer width */
+      const int getWidth() const { return width; };
+      /*! \return packer height */
+      const int getHeight() const { return height; };
+
+   private:
+      /*! A horizontal segment of the skyline */
+      struct Segment
+      {
+         int x; /**< Left coordinate */
+         int y; /**< Coordinate of the first free line */
+         int width; /**< Width of the segment */
+      };
+
+      /*! \return the y where a rectangle fits starting at the segment 
+       *          index, or -1 if it doesn't fit there. */
+      int fit(size_t index, int width, int height) const;
+
+      /*! Add a segment, for a just placed rectangle, at index */
+      void addSegment(size_t index, int x, int y, int width, int height);
+
+      std::vector<Segment> skyline; /**< The skyline, from left to right */
+      int width; /**< Packer width */
+      int height; /**< Packer height */
+      int usedArea; /**< Area of placed rectangles */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,424 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "blendspan.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+   #if defined(__SSE2__) || defined(_M_X64) || \
+       (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+      #define FARSO_BLEND_SPAN_SSE2 1
+      #include <emmintrin.h>
+   #endif
+   #if defined(__GNUC__) || defined(__clang__)
+      /* Compiled with target attribute, used only if CPU supports it */
+      #define FARSO_BLEND_SPAN_AVX2 1
+      #include <immintrin.h>
+   #endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+   #define FARSO_BLEND_SPAN_NEON 1
+   #include <arm_neon.h>
+#endif
+
+using namespace Farso;
+
+/* Note: all kernels compute, for each byte of the pixel,
+ *    t = (s * c + t * (255 - c)) / 255
+ * where s is the color byte (255 for alpha) and c the coverage. This is 
+ * the same of Draw::blendColor, as for alpha:
+ *    (255 * c + t * (255 - c)) / 255 = c + t * (255 - c) / 255.
+ * The division by 255 is done exactly (for x <= 255 * 255) as
+ *    (x + 1 + (x >> 8)) >> 8
+ * and, as in Draw::blendColor, fully transparent pixels just receive the
+ * color, with the coverage as alpha. With premultiplied alpha the same 
+ * formula is the source (color * c, c) over the target, thus it's just 
+ * done without the transparent pixels special case. */
+
+/************************************************************************
+ *                              blendScalar                             *
+ ************************************************************************/
+static void blendScalar(Uint8* dst, const Uint8* coverage, int count,
+      Uint32 color, Uint32 alphaMask, bool premultiplied)
+{
+   Uint8 src[4];
+   memcpy(src, &color, 4);
+
+   for(int i = 0; i < count; i++)
+   {
+      Uint32 c = coverage[i];
+      Uint32 pixel;
+      memcpy(&pixel, dst, 4);
+
+      if((!premultiplied) && ((pixel & alphaMask) == 0))
+      {
+         pixel = (color & ~alphaMask) | ((c * 0x01010101) & alphaMask);
+         memcpy(dst, &pixel, 4);
+      }
+      else
+      {
+         for(int b = 0; b < 4; b++)
+         {
+            Uint32 x = src[b] * c + dst[b] * (255 - c);
+            dst[b] = (Uint8) ((x + 1 + (x >> 8)) >> 8);
+         }
+      }
+      dst += 4;
+   }
+}
+
+#ifdef FARSO_BLEND_SPAN_SSE2
+/************************************************************************
+ *                               blendSSE2                              *
+ ************************************************************************/
+static void blendSSE2(Uint8* dst, const Uint8* coverage, int count,
+      Uint32 color, Uint32 alphaMask, bool premultiplied)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i one = _mm_set1_epi16(1);
+   const __m128i full = _mm_set1_epi16(255);
+   const __m128i src = _mm_set1_epi32((int) color);
+   const __m128i srcWide = _mm_unpacklo_epi8(src, zero);
+   const __m128i mask = _mm_set1_epi32((int) alphaMask);
+
+   int i = 0;
+   for(; i + 4 <= count; i += 4)
+   {
+      __m128i d = _mm_loadu_si128((const __m128i*) (dst + i * 4));
+
+      /* Each coverage byte to all bytes of its pixel */
+      int c4;
+      memcpy(&c4, coverage + i, 4);
+      __m128i c = _mm_cvtsi32_si128(c4);
+      c = _mm_unpacklo_epi8(c, c);
+      c = _mm_unpacklo_epi16(c, c);
+
+      /* Blend at 16 bits */
+      __m128i cLo = _mm_unpacklo_epi8(c, zero);
+      __m128i cHi = _mm_unpackhi_epi8(c, zero);
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(srcWide, cLo),
+            _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), 
+               _mm_sub_epi16(full, cLo)));
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(srcWide, cHi),
+            _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), 
+               _mm_sub_epi16(full, cHi)));
+      lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), 
+               _mm_srli_epi16(lo, 8)), 8);
+      hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), 
+               _mm_srli_epi16(hi, 8)), 8);
+      __m128i res = _mm_packus_epi16(lo, hi);
+
+      /* Transparent pixels just receive the color */
+      if(!premultiplied)
+      {
+         __m128i transp = _mm_cmpeq_epi32(_mm_and_si128(d, mask), zero);
+         __m128i replace = _mm_or_si128(_mm_andnot_si128(mask, src),
+               _mm_and_si128(c, mask));
+         res = _mm_or_si128(_mm_and_si128(transp, replace), 
+               _mm_andnot_si128(transp, res));
+      }
+
+      _mm_storeu_si128((__m128i*) (dst + i * 4), res);
+   }
+
+   blendScalar(dst + i * 4, coverage + i, count - i, color, alphaMask, 
+         premultiplied);
+}
+#endif
+
+#ifdef FARSO_BLEND_SPAN_AVX2
+/************************************************************************
+ *                               blendAVX2                              *
+ ************************************************************************/
+__attribute__((target("avx2")))
+static void blendAVX2(Uint8* dst, const Uint8* coverage, int count,
+      Uint32 color, Uint32 alphaMask, bool premultiplied)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i one = _mm256_set1_epi16(1);
+   const __m256i full = _mm256_set1_epi16(255);
+   const __m256i bytes = _mm256_set1_epi32(0x01010101);
+   const __m256i src = _mm256_set1_epi32((int) color);
+   const __m256i srcWide = _mm256_unpacklo_epi8(src, zero);
+   const __m256i mask = _mm256_set1_epi32((int) alphaMask);
+
+   int i = 0;
+   for(; i + 8 <= count; i += 8)
+   {
+      __m256i d = _mm256_loadu_si256((const __m256i*) (dst + i * 4));
+
+      /* Each coverage byte to all bytes of its pixel */
+      __m256i c = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*) (coverage + i)));
+      c = _mm256_mullo_epi32(c, bytes);
+
+      /* Blend at 16 bits (note: unpack and pack are both per 128-bit 
+       * lane, thus the pixel order is kept) */
+      __m256i cLo = _mm256_unpacklo_epi8(c, zero);
+      __m256i cHi = _mm256_unpackhi_epi8(c, zero);
+      __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(srcWide, cLo),
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), 
+               _mm256_sub_epi16(full, cLo)));
+      __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(srcWide, cHi),
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), 
+               _mm256_sub_epi16(full, cHi)));
+      lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), 
+               _mm256_srli_epi16(lo, 8)), 8);
+      hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), 
+               _mm256_srli_epi16(hi, 8)), 8);
+      __m256i res = _mm256_packus_epi16(lo, hi);
+
+      /* Transparent pixels just receive the color */
+      if(!premultiplied)
+      {
+         __m256i transp = _mm256_cmpeq_epi32(_mm256_and_si256(d, mask), 
+               zero);
+         __m256i replace = _mm256_or_si256(_mm256_andnot_si256(mask, src),
+               _mm256_and_si256(c, mask));
+         res = _mm256_blendv_epi8(res, replace, transp);
+      }
+
+      _mm256_storeu_si256((__m256i*) (dst + i * 4), res);
+   }
+
+   blendScalar(dst + i * 4, coverage + i, count - i, color, alphaMask, 
+         premultiplied);
+}
+#endif
+
+#ifdef FARSO_BLEND_SPAN_NEON
+/************************************************************************
+ *                               blendNEON                              *
+ ************************************************************************/
+static void blendNEON(Uint8* dst, const Uint8* coverage, int count,
+      Uint32 color, Uint32 alphaMask, bool premultiplied)
+{
+   const uint16x8_t one = vdupq_n_u16(1);
+   const uint8x16_t src = vreinterpretq_u8_u32(vdupq_n_u32(color));
+   const uint32x4_t mask = vdupq_n_u32(alphaMask);
+
+   int i = 0;
+   for(; i + 4 <= count; i += 4)
+   {
+      uint8x16_t d = vld1q_u8(dst + i * 4);
+
+      /* Each coverage byte to all bytes of its pixel */
+      uint32_t c4;
+      memcpy(&c4, coverage + i, 4);
+      uint8x8_t c8 = vreinterpret_u8_u32(vdup_n_u32(c4));
+      uint8x8x2_t z = vzip_u8(c8, c8);
+      z = vzip_u8(z.val[0], z.val[0]);
+      uint8x16_t c = vcombine_u8(z.val[0], z.val[1]);
+      uint8x16_t inv = vmvnq_u8(c);
+
+      /* Blend at 16 bits */
+      uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(src), vget_low_u8(c)),
+            vget_low_u8(d), vget_low_u8(inv));
+      uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(src), vget_high_u8(c)),
+            vget_high_u8(d), vget_high_u8(inv));
+      lo = vaddq_u16(vaddq_u16(lo, one), vshrq_n_u16(lo, 8));
+      hi = vaddq_u16(vaddq_u16(hi, one), vshrq_n_u16(hi, 8));
+      uint8x16_t res = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+
+      /* Transparent pixels just receive the color */
+      if(!premultiplied)
+      {
+         uint32x4_t transp = vceqq_u32(vandq_u32(
+                  vreinterpretq_u32_u8(d), mask), vdupq_n_u32(0));
+         uint8x16_t replace = vbslq_u8(vreinterpretq_u8_u32(mask), c, src);
+         res = vbslq_u8(vreinterpretq_u8_u32(transp), replace, res);
+      }
+
+      vst1q_u8(dst + i * 4, res);
+   }
+
+   blendScalar(dst + i * 4, coverage + i, count - i, color, alphaMask, 
+         premultiplied);
+}
+#endif
+
+/************************************************************************
+ *                               BlendSpan                              *
+ ************************************************************************/
+BlendSpan::BlendSpan(const Color& color, const Layout& layout, 
+      bool premultiplied)
+{
+   this->premultiplied = premultiplied;
+
+   Uint8 src[4];
+   src[layout.red] = color.red;
+   src[layout.green] = color.green;
+   src[layout.blue] = color.blue;
+   src[layout.alpha] = 255;
+   memcpy(&this->color, src, 4);
+
+   Uint8 mask[4] = {0, 0, 0, 0};
+   mask[layout.alpha] = 255;
+   memcpy(&this->alphaMask, mask, 4);
+}
+
+/************************************************************************
+ *                                 blend                                *
+ ************************************************************************/
+void BlendSpan::blend(Uint8* dst, const Uint8* coverage, int count) const
+{
+   kernel(dst, coverage, count, color, alphaMask, premultiplied);
+}
+
+/************************************************************************
+ *                              premultiply                             *
+ ************************************************************************/
+void BlendSpan::premultiply(Uint8* pixels, int count, const Layout& layout)
+{
+   for(int i = 0; i < count; i++, pixels += 4)
+   {
+      Uint32 a = pixels[layout.alpha];
+      if(a != 255)
+      {
+         Uint32 x = pixels[layout.red] * a;
+         pixels[layout.red] = (Uint8) ((x + 1 + (x >> 8)) >> 8);
+         x = pixels[layout.green] * a;
+         pixels[layout.green] = (Uint8) ((x + 1 + (x >> 8)) >> 8);
+         x = pixels[layout.blue] * a;
+         pixels[layout.blue] = (Uint8) ((x + 1 + (x >> 8)) >> 8);
+      }
+   }
+}
+
+/************************************************************************
+ *                              isSupported                             *
+ ************************************************************************/
+bool BlendSpan::isSupported(Implementation impl)
+{
+   switch(impl)
+   {
+      case IMPLEMENTATION_SCALAR:
+         return true;
+#ifdef FARSO_BLEND_SPAN_SSE2
+      case IMPLEMENTATION_SSE2:
+         return true;
+#endif
+#ifdef FARSO_BLEND_SPAN_AVX2
+      case IMPLEMENTATION_AVX2:
+         return __builtin_cpu_supports("avx2");
+#endif
+#ifdef FARSO_BLEND_SPAN_NEON
+      case IMPLEMENTATION_NEON:
+         return true;
+#endif
+      default:
+      break;
+   }
+   return false;
+}
+
+/************************************************************************
+ *                                 detect                               *
+ ************************************************************************/
+BlendSpan::Implementation BlendSpan::detect()
+{
+   const Implementation preferred[] = { IMPLEMENTATION_AVX2, 
+      IMPLEMENTATION_SSE2, IMPLEMENTATION_NEON };
+
+   for(int i = 0; i < 3; i++)
+   {
+      if(isSupported(preferred[i]))
+      {
+         return preferred[i];
+      }
+   }
+   return IMPLEMENTATION_SCALAR;
+}
+
+/************************************************************************
+ *                               getKernel                              *
+ ************************************************************************/
+BlendSpan::Kernel BlendSpan::getKernel(Implementation impl)
+{
+   switch(impl)
+   {
+#ifdef FARSO_BLEND_SPAN_SSE2
+      case IMPLEMENTATION_SSE2:
+         return blendSSE2;
+#endif
+#ifdef FARSO_BLEND_SPAN_AVX2
+      case IMPLEMENTATION_AVX2:
+         return blendAVX2;
+#endif
+#ifdef FARSO_BLEND_SPAN_NEON
+      case IMPLEMENTATION_NEON:
+         return blendNEON;
+#endif
+      default:
+      break;
+   }
+   return blendScalar;
+}
+
+/************************************************************************
+ *                           getImplementation                          *
+ ************************************************************************/
+BlendSpan::Implementation BlendSpan::getImplementation()
+{
+   return implementation;
+}
+
+/************************************************************************
+ *                         getImplementationName                        *
+ ************************************************************************/
+const char* BlendSpan::getImplementationName(Implementation impl)
+{
+   switch(impl)
+   {
+      case IMPLEMENTATION_SCALAR:
+         return "scalar";
+      case IMPLEMENTATION_SSE2:
+         return "sse2";
+      case IMPLEMENTATION_AVX2:
+         return "avx2";
+      case IMPLEMENTATION_NEON:
+         return "neon";
+      default:
+      break;
+   }
+   return "unknown";
+}
+
+/************************************************************************
+ *                           setImplementation                          *
+ ************************************************************************/
+bool BlendSpan::setImplementation(Implementation impl)
+{
+   if(!isSupported(impl))
+   {
+      return false;
+   }
+   implementation = impl;
+   kernel = getKernel(impl);
+   return true;
+}
+
+BlendSpan::Implementation BlendSpan::implementation = BlendSpan::detect();
+BlendSpan::Kernel BlendSpan::kernel = BlendSpan::getKernel(
+      BlendSpan::implementation);
+
@@ -0,0 +1,120 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_blend_span_h
+#define _farso_blend_span_h
+
+#include "farsoconfig.h"
+#include "colors.h"
+
+namespace Farso
+{
+
+/*! Blends a color into a span (a row) of 32-bit pixels, using a 
+ * coverage (usually, a FreeType gray glyph row) as source alpha.
+ *
+ * The result is byte-identical to Draw::blendColor per pixel, but 
+ * computed by a SIMD kernel (AVX2, SSE2 or NEON, with a scalar fallback) 
+ * chosen at runtime for the current CPU. */
+class BlendSpan
+{
+   public:
+      /*! Kernel implementations */
+      enum Implementation
+      {
+         IMPLEMENTATION_SCALAR = 0,
+         IMPLEMENTATION_SSE2,
+         IMPLEMENTATION_AVX2,
+         IMPLEMENTATION_NEON,
+         /*! Just to know the total number of implementations */
+         TOTAL_IMPLEMENTATIONS
+      };
+
+      /*! Byte position (0 to 3) of each channel on a 32-bit pixel */
+      struct Layout
+      {
+         int red; /**< Red byte position */
+         int green; /**< Green byte position */
+         int blue; /**< Blue byte position */
+         int alpha; /**< Alpha byte position */
+      };
+
+      /*! Constructor
+       * \param color color to blend (its alpha is ignored, as the 
+       *        coverage is used instead)
+       * \param layout target pixels layout 
+       * \param premultiplied if target pixels are in premultiplied alpha */
+      BlendSpan(const Color& color, const Layout& layout, 
+            bool premultiplied = false);
+
+      /*! Blend the color to a span of pixels.
+       * \param dst first pixel of the span
+       * \param coverage coverage of each pixel of the span
+       * \param count number of pixels on the span */
+      void blend(Uint8* dst, const Uint8* coverage, int count) const;
+
+      /*! Convert a span of pixels from straight to premultiplied alpha
+       * (ie: multiplying each color channel by alpha / 255).
+       * \param pixels first pixel of the span
+       * \param count number of pixels on the span
+       * \param layout pixels layout */
+      static void premultiply(Uint8* pixels, int count, const Layout& layout);
+
+      /*! \return implementation currently used */
+      static Implementation getImplementation();
+      /*! \return name of an implementation */
+      static const char* getImplementationName(Implementation impl);
+
+      /*! \return if an implementation is supported by the current CPU */
+      static bool isSupported(Implementation impl);
+
+      /*! Force the use of an implementation (usually to compare them).
+       * \return false if not supported (keeping the current one) */
+      static bool setImplementation(Implementation impl);
+
+   private:
+      /*! Kernel to blend a span. 
+       * \param dst first pixel of the span
+       * \param coverage coverage of each pixel 
+       * \param count number of pixels 
+       * \param color color pixel, with alpha byte at 255
+       * \param alphaMask mask of the alpha byte 
+       * \param premultiplied if target is in premultiplied alpha */
+      typedef void (*Kernel)(Uint8* dst, const Uint8* coverage, int count,
+            Uint32 color, Uint32 alphaMask, bool premultiplied);
+
+      /*! \return the best implementation for current CPU */
+      static Implementation detect();
+
+      /*! \return kernel function of an implementation */
+      static Kernel getKernel(Implementation impl);
+
+      Uint32 color; /**< Color on target layout, with alpha at 255 */
+      Uint32 alphaMask; /**< Mask of the alpha byte on target layout */
+      bool premultiplied; /**< If target is in premultiplied alpha */
+
+      static Implementation implementation; /**< Current implementation */
+      static Kernel kernel; /**< Current kernel */
+};
+
+}
+
+#endif
+
@@ -22,6 +22,7 @@
 #include "colors.h"
 #include "font.h"
 #include "widgetjsonparser.h"
+#include <kobold/keyboard.h>
 
 #include <kobold/log.h>
 
@@ -34,9 +35,9 @@ using namespace Farso;
  ***********************************************************************/
 void Controller::init(Loader* loader, Renderer* renderer,
       int screenWidth, int screenHeight, int maxCursorSize,
-      const Kobold::String& baseDir)
+      const Kobold::String& baseDir, bool premultipliedAlpha)
 {
-   mutex.lock();
+   lockMutex();
    if(!inited)
    {
       /* Define parameters */
@@ -45,6 +46,14 @@ void Controller::init(Loader* loader, Renderer* renderer,
       Controller::baseDir = baseDir;
       Controller::loader = loader;
       Controller::renderer = renderer;
+      if((premultipliedAlpha) && (!renderer->supportsPremultipliedAlpha()))
+      {
+         Kobold::Log::add(Kobold::LOG_LEVEL_ERROR,
+               "WARN: premultiplied alpha not supported by the renderer, "
+               "using straight alpha instead.");
+         premultipliedAlpha = false;
+      }
+      renderer->getDraw()->setPremultipliedAlpha(premultipliedAlpha);
 
       skin = NULL;
       activeWidget = NULL;
@@ -52,6 +61,12 @@ void Controller::init(Loader* loader, Renderer* renderer,
       renderers = new Kobold::List();
       widgets = new Kobold::List();
       toRemoveWidgets = new Kobold::List();
+      frameCount = 0;
+      lastFrameStats.clear();
+      frameStatsHistory.assign(FARSO_DEFAULT_FRAME_STATS_HISTORY, 
+            FrameStats());
+      frameStatsHistoryPos = 0;
+      frameStatsHistoryTotal = 0;
       inited = true;
       Colors::init();
       FontManager::init();
@@ -73,7 +88,7 @@ void Controller::init(Loader* loader, Renderer* renderer,
  ***********************************************************************/
 void Controller::finish()
 {
-   mutex.lock();
+   lockMutex();
 
    assert(inited);
 
@@ -84,7 +99,7 @@ void Controller::finish()
 
    if(skin)
    {
-      delete skin;
+      delete skin.load();
       skin = NULL;
    }
    if(toRemoveWidgets)
@@ -114,6 +129,12 @@ void Controller::finish()
    }
    FontManager::finish();
 
+   if(rasterPool)
+   {
+      delete rasterPool;
+      rasterPool = NULL;
+   }
+
    idMap.clear();
 
    inited = false;
@@ -144,7 +165,7 @@ void Controller::setCursor(const Kobold::String& filename)
 {
 #if KOBOLD_PLATFORM != KOBOLD_PLATFORM_ANDROID && \
     KOBOLD_PLATFORM != KOBOLD_PLATFORM_IOS
-   mutex.lock();
+   lockMutex();
       Cursor::set(getRealFilename(filename));
    mutex.unlock();
 #endif
@@ -193,12 +214,15 @@ void Controller::setSkin(Skin* skin)
 {
    if(skin != NULL)
    {
-      mutex.lock();
-      if(Controller::skin)
+      lockMutex();
+      if((Controller::skin) && (Controller::skin != skin))
       {
          /* Must unload the current one */
-         delete Controller::skin;
+         delete Controller::skin.load();
       }
+      /* Its composed elements could be from another renderer or from 
+       * a previous atlas, if reused. */
+      skin->clearCache();
       Controller::skin = skin;
       markAllDirty();
       mutex.unlock();
@@ -210,22 +234,27 @@ void Controller::setSkin(Skin* skin)
  ***********************************************************************/
 bool Controller::loadSkin(const Kobold::String& filename)
 {
-   mutex.lock();
+   FARSO_TRACE_SCOPE_DETAIL("Controller::loadSkin", filename);
+   lockMutex();
    if(skin != NULL)
    {
       /* Unload previous defined skin. */
-      delete skin;
+      delete skin.load();
+      skin = NULL;
    }
 
    bool success = true;
-   skin = new Skin();
-   if((!skin->load(filename)) ||(!skin->getSurface()))
+   Skin* loaded = new Skin();
+   if((!loaded->load(filename)) ||(!loaded->getSurface()))
    {
       /* Skin couldn't be loaded. Must not use it. */
-      delete skin;
-      skin = NULL;
+      delete loaded;
       success = false;
    }
+   else
+   {
+      skin = loaded;
+   }
 
    /* Must mark all widgets dirty (to be redraw with the new skin - or
     * the failsafe 'no-skins' mode when failed to load the skin). */
@@ -241,10 +270,10 @@ bool Controller::loadSkin(const Kobold::String& filename)
  ***********************************************************************/
 void Controller::unloadSkin()
 {
-   mutex.lock();
+   lockMutex();
    if(skin != NULL)
    {
-      delete skin;
+      delete skin.load();
       skin = NULL;
       markAllDirty();
    }
@@ -269,13 +298,7 @@ void Controller::markAllDirty()
  ***********************************************************************/
 Skin* Controller::getSkin()
 {
-   Skin* res;
-
-   mutex.lock();
-   res = skin;
-   mutex.unlock();
-
-   return res;
+   return skin.load();
 }
 
 /***********************************************************************
@@ -302,6 +325,14 @@ Draw* Controller::getDraw()
    return renderer->getDraw();
 }
 
+/***********************************************************************
+ *                          isPremultipliedAlpha                       *
+ ***********************************************************************/
+const bool Controller::isPremultipliedAlpha()
+{
+   return (renderer != NULL) && (renderer->getDraw()->isPremultipliedAlpha());
+}
+
 /***********************************************************************
  *                             getLastEvent                            *
  ***********************************************************************/
@@ -315,13 +346,13 @@ const Event Controller::getLastEvent()
  ***********************************************************************/
 void Controller::setEvent(Widget* owner, EventType type)
 {
-   mutex.lock();
+   bool locked = lockIfNotFrameOwner();
    event.set(owner, type);
    if(owner)
    {
       owner->onEvent(type);
    }
-   mutex.unlock();
+   unlockIfLocked(locked);
 }
 
 /***********************************************************************
@@ -331,7 +362,7 @@ void Controller::removeEventListener(Widget* owner,
       WidgetEventListener* listener)
 {
    assert(owner != NULL && listener != NULL);
-   mutex.lock();
+   lockMutex();
    owner->removeEventListener(listener);
    mutex.unlock();
 }
@@ -342,7 +373,7 @@ void Controller::removeEventListener(Widget* owner,
 void Controller::addEventListener(Widget* owner, WidgetEventListener* listener)
 {
    assert(owner != NULL && listener != NULL);
-   mutex.lock();
+   lockMutex();
    owner->addEventListener(listener);
    mutex.unlock();
 }
@@ -362,7 +393,7 @@ bool Controller::addWidget(Widget* widget)
       return false;
    }
 
-   mutex.lock();
+   lockMutex();
    bool res = widgets->insert(widget);
    if((widget->getWidgetRenderer() != NULL) && (widget->getParent() == NULL))
    {
@@ -378,11 +409,7 @@ bool Controller::addWidget(Widget* widget)
  ***********************************************************************/
 Widget* Controller::getActiveWidget()
 {
-   mutex.lock();
-   Widget* res = activeWidget;
-   mutex.unlock();
-
-   return res;
+   return activeWidget.load();
 }
 
 /***********************************************************************
@@ -390,10 +417,10 @@ Widget* Controller::getActiveWidget()
  ***********************************************************************/
 void Controller::setActiveWidget(Widget* widget)
 {
-   mutex.lock();
+   bool locked = lockIfNotFrameOwner();
    if(widget != activeWidget)
    {
-      Widget* lastActive = activeWidget;
+      Widget* lastActive = activeWidget.load();
       activeWidget = widget;
 
       if((widget != NULL) && (widget->getType() == Widget::WIDGET_TYPE_WINDOW))
@@ -417,7 +444,7 @@ void Controller::setActiveWidget(Widget* widget)
       }
    }
    forceBringToFrontCall = true;
-   mutex.unlock();
+   unlockIfLocked(locked);
 }
 
 /***********************************************************************
@@ -442,6 +469,7 @@ void Controller::bringFront(Widget* widget)
    {
       renderers->removeWithoutDelete(widget->getWidgetRenderer());
       renderers->insertAtBegin(widget->getWidgetRenderer());
+      WidgetRenderer::markVisualChanged();
    }
 
    if(!renderer->shouldManualRender())
@@ -472,7 +500,7 @@ void Controller::bringFront(Widget* widget)
  ***********************************************************************/
 void Controller::markToRemoveWidget(Widget* widget)
 {
-   mutex.lock();
+   lockMutex();
    toRemoveWidgets->insert(new WidgetToRemove(widget));
    mutex.unlock();
 }
@@ -495,21 +523,32 @@ bool Controller::verifyEvents(Widget* widget,
    /* Verify widget events */
    if(checkEvents)
    {
+      FARSO_TRACE_SCOPE("Widget::treat");
+      uint64_t start = FrameStats::startPhase();
       gotEvent = widget->treat(leftButtonPressed, rightButtonPressed, 
                mouseX, mouseY);
+      FrameStats::endPhase(FrameStats::PHASE_TREAT, start);
    }
 
    /* redraw the widget (and its children, if needed) */
-   if((widget->isDirty()) && (widget->isVisible()))
+   uint64_t drawStart = FrameStats::startDrawPhase();
+   if((rasterPool != NULL) && (widget->isDirty()))
    {
-      if(skin != NULL)
+      /* Will be drawn latter, in parallel with others */
+      pendingDraw.push_back(widget);
+   }
+   else if((widget->isDirty()) && (widget->isVisible()))
+   {
+      FARSO_TRACE_SCOPE_DETAIL("Widget::draw", widget->getId());
+      Skin* curSkin = skin.load();
+      if(curSkin != NULL)
       {
-         skin->getSurface()->lock();
+         curSkin->getSurface()->lock();
       }
       widget->draw();
-      if(skin != NULL)
+      if(curSkin != NULL)
       {
-         skin->getSurface()->unlock();
+         curSkin->getSurface()->unlock();
       }
    }
    /* Update the widget renderer, if needed */
@@ -517,10 +556,128 @@ bool Controller::verifyEvents(Widget* widget,
    {
       widget->getWidgetRenderer()->update();
    }
+   FrameStats::endDrawPhase(drawStart);
 
    return gotEvent;
 }
 
+/***********************************************************************
+ *                           setParallelDraw                           *
+ ***********************************************************************/
+void Controller::setParallelDraw(int threads)
+{
+   lockMutex();
+   if(rasterPool != NULL)
+   {
+      delete rasterPool;
+      rasterPool = NULL;
+   }
+   if(threads > 0)
+   {
+      rasterPool = new RasterPool(threads);
+   }
+   mutex.unlock();
+}
+
+/***********************************************************************
+ *                       getParallelDrawThreads                        *
+ ***********************************************************************/
+const int Controller::getParallelDrawThreads()
+{
+   return (rasterPool != NULL) ? rasterPool->getTotalThreads() : 0;
+}
+
+/***********************************************************************
+ *                             drawPending                             *
+ ***********************************************************************/
+void Controller::drawPending()
+{
+   assert(frameOwner.load() == std::this_thread::get_id());
+
+   FARSO_TRACE_SCOPE("Controller::drawPending");
+   uint64_t start = FrameStats::startDrawPhase();
+
+   Skin* curSkin = skin.load();
+   if(curSkin != NULL)
+   {
+      curSkin->getSurface()->lock();
+   }
+
+   /* Make sure all surfaces are created at the rendering thread, as some
+    * renderers need it. */
+   for(size_t i = 0; i < pendingDraw.size(); i++)
+   {
+      pendingDraw[i]->getWidgetRenderer()->getSurface();
+   }
+
+   /* Rasterize all of them in parallel, and upload at this thread */
+   rasterPool->rasterize(pendingDraw);
+   for(size_t i = 0; i < pendingDraw.size(); i++)
+   {
+      pendingDraw[i]->finishDraw();
+   }
+
+   if(curSkin != NULL)
+   {
+      curSkin->getSurface()->unlock();
+   }
+
+   pendingDraw.clear();
+
+   FrameStats::endDrawPhase(start);
+}
+
+/***********************************************************************
+ *                               isIdle                                *
+ ***********************************************************************/
+bool Controller::isIdle(bool leftButtonPressed, bool rightButtonPressed,
+      int mouseX, int mouseY)
+{
+   /* Pressed buttons could generate events at each check (for example,
+    * while pressing a button), the wheel scrolls without moving the 
+    * cursor and text edition isn't on mouse state. */
+   if((leftButtonPressed) || (rightButtonPressed) || 
+      (lastLeftButtonPressed) || (lastRightButtonPressed) ||
+      (mouseX != lastMouseX) || (mouseY != lastMouseY) ||
+      (Cursor::getRelativeWheel() != 0) ||
+      (Kobold::Keyboard::isEditingText()))
+   {
+      return false;
+   }
+
+   /* Renderers changed since last check (for example, a window moved by
+    * the application) could have changed what is under the cursor. */
+   if(WidgetRenderer::hasVisualChanges())
+   {
+      return false;
+   }
+
+   /* Check if any root widget need to be redrawn */
+   Widget* w = static_cast<Widget*>(widgets->getFirst());
+   for(int i = 0; i < widgets->getTotal(); i++)
+   {
+      if(w->isDirty())
+      {
+         return false;
+      }
+      w = static_cast<Widget*>(w->getNext());
+   }
+
+   /* Or if any renderer (including the ones of non-root widgets, as menus)
+    * is animating */
+   WidgetRenderer* wr = static_cast<WidgetRenderer*>(renderers->getFirst());
+   for(int i = 0; i < renderers->getTotal(); i++)
+   {
+      if(wr->needUpdate())
+      {
+         return false;
+      }
+      wr = static_cast<WidgetRenderer*>(wr->getNext());
+   }
+
+   return true;
+}
+
 /***********************************************************************
  *                            verifyEvents                             *
  ***********************************************************************/
@@ -529,8 +686,17 @@ bool Controller::verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
 {
    bool gotEvent = false;
    
-   mutex.lock();
-   mouseOverWidget = false;
+   /* Own the lock for the whole frame: accessors called from inside it
+    * (ie: by widgets' treat) won't need to lock again. */
+   lockMutex();
+   frameOwner = std::this_thread::get_id();
+
+   FARSO_TRACE_SCOPE("Controller::verifyEvents");
+   uint64_t frameStart = FrameStats::startPhase();
+   FARSO_TRACE_BEGIN(removalTrace, "Controller::removal");
+
+   /* Apply any mutation queued by other threads */
+   applyQueuedCommands();
 
    /* Enter 2d rendering mode */
    renderer->enter2dMode();
@@ -551,7 +717,7 @@ bool Controller::verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
    /* If removed and have widgets, must bring it to front */
    if((removed) && (widgets->getTotal() > 0))
    {
-      bringFront((activeWidget) ? activeWidget
+      bringFront((activeWidget) ? activeWidget.load()
                    : static_cast<Widget*>(widgets->getFirst()));
    }
 
@@ -563,37 +729,62 @@ bool Controller::verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
        * which could mess things up on the list. */
       bringFront(activeWidget);
    }
+   FrameStats::endPhase(FrameStats::PHASE_REMOVAL, frameStart);
+   FARSO_TRACE_END(removalTrace);
 
-   /* Check active widget root first, if any. */
-   Widget* activeRoot = (activeWidget) ? activeWidget->getRoot() : NULL;
-   if(activeRoot)
-   {
-      gotEvent |= verifyEvents(activeRoot, leftButtonPressed,
-            rightButtonPressed, mouseX, mouseY, !gotEvent);
-   }
+   /* When nothing changed since last check, there's no need to treat 
+    * and draw our widgets again (the results would be the same). */
+   bool idle = (!removed) && 
+      (isIdle(leftButtonPressed, rightButtonPressed, mouseX, mouseY));
 
-   /* Check all other widgets */
-   Widget* w = static_cast<Widget*>(widgets->getFirst());
-   for(int i = 0; i < widgets->getTotal(); i++)
+   if(!idle)
    {
-      if(w != activeRoot)
+      mouseOverWidget = false;
+
+      /* Check active widget root first, if any. */
+      Widget* activeRoot = (activeWidget) ? 
+         activeWidget.load()->getRoot() : NULL;
+      if(activeRoot)
       {
-         gotEvent |= verifyEvents(w, leftButtonPressed, rightButtonPressed, 
-               mouseX, mouseY, !gotEvent);
+         gotEvent |= verifyEvents(activeRoot, leftButtonPressed,
+               rightButtonPressed, mouseX, mouseY, !gotEvent);
       }
 
-      /* Verify if mouse is over any widget (note: stop checking after
-       * got that is over a widget) */
-      if((!mouseOverWidget) && (w->isVisible()))
+      /* Check all other widgets */
+      Widget* w = static_cast<Widget*>(widgets->getFirst());
+      for(int i = 0; i < widgets->getTotal(); i++)
       {
-         int relMouseX = mouseX - w->getWidgetRenderer()->getPositionX();
-         int relMouseY = mouseY - w->getWidgetRenderer()->getPositionY();
-         mouseOverWidget = w->isInner(relMouseX, relMouseY);
+         if(w != activeRoot)
+         {
+            gotEvent |= verifyEvents(w, leftButtonPressed, 
+                  rightButtonPressed, mouseX, mouseY, !gotEvent);
+         }
+
+         /* Verify if mouse is over any widget (note: stop checking after
+          * got that is over a widget) */
+         if((!mouseOverWidget) && (w->isVisible()))
+         {
+            int relMouseX = mouseX - w->getWidgetRenderer()->getPositionX();
+            int relMouseY = mouseY - w->getWidgetRenderer()->getPositionY();
+            mouseOverWidget = w->isInner(relMouseX, relMouseY);
+         }
+
+         w = static_cast<Widget*>(w->getNext());
       }
+   }
 
-      w = static_cast<Widget*>(w->getNext());
+   if(!pendingDraw.empty())
+   {
+      drawPending();
    }
 
+   lastLeftButtonPressed = leftButtonPressed;
+   lastRightButtonPressed = rightButtonPressed;
+   lastMouseX = mouseX;
+   lastMouseY = mouseY;
+
+   FARSO_TRACE_BEGIN(renderTrace, "Controller::manualRender");
+   uint64_t phaseStart = FrameStats::startPhase();
    if(renderer->shouldManualRender())
    {
       /* Most render widgets from back to front */
@@ -609,12 +800,16 @@ bool Controller::verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
          wr = static_cast<WidgetRenderer*>(wr->getPrevious());
       }
    }
+   FrameStats::endPhase(FrameStats::PHASE_MANUAL_RENDER, phaseStart);
+   FARSO_TRACE_END(renderTrace);
    
    /* Must render mouse cursor on top */
 #if KOBOLD_PLATFORM != KOBOLD_PLATFORM_ANDROID && \
     KOBOLD_PLATFORM != KOBOLD_PLATFORM_IOS
 
    /* Render cursor */
+   FARSO_TRACE_BEGIN(cursorTrace, "Controller::cursor");
+   phaseStart = FrameStats::startPhase();
    WidgetRenderer* cursorRenderer = Farso::Cursor::getRenderer();
    if( (cursorRenderer) && (cursorRenderer->isVisible()) )
    {
@@ -626,7 +821,16 @@ bool Controller::verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
       }
    }
 
-   /* Check if current tip, if any, expired */
+   /* Check if current tip, if any, expired. Note that when idle, no
+    * widget was treated to keep its tip, so we must keep it ourselves. */
+   if(!idle)
+   {
+      overMouseHint = Farso::Cursor::wasTipSet();
+   }
+   else if(overMouseHint)
+   {
+      Farso::Cursor::setTextualTip(Farso::Cursor::getTextualTip());
+   }
    Farso::Cursor::checkTipExpiration();
    
    /* Render cursor tip */
@@ -663,23 +867,101 @@ bool Controller::verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
          cursorRenderer->render();
       }
    }
+   FrameStats::endPhase(FrameStats::PHASE_CURSOR, phaseStart);
+   FARSO_TRACE_END(cursorTrace);
 
 #endif
 
    /* Restore rendering mode to previously enter 2d one. */
    renderer->restore3dMode();
 
+   /* Check if anything visually changed */
+   presentNeeded = WidgetRenderer::hasVisualChanges();
+   WidgetRenderer::resetVisualChanges();
+
+   /* Note: this frame lock is counted too */
+   lastFrameLocks = locks.exchange(0);
+
+   /* Gather this frame statistics, keeping them on history */
+   frameCount++;
+   FrameStats::collect(lastFrameStats, frameCount, frameStart);
+   if((frameStart != 0) && (!frameStatsHistory.empty()))
+   {
+      frameStatsHistory[frameStatsHistoryPos] = lastFrameStats;
+      frameStatsHistoryPos = (frameStatsHistoryPos + 1) % 
+         frameStatsHistory.size();
+      if(frameStatsHistoryTotal < frameStatsHistory.size())
+      {
+         frameStatsHistoryTotal++;
+      }
+   }
+
+   frameOwner = std::thread::id();
    mutex.unlock();
 
    return gotEvent;
 }
 
+/***********************************************************************
+ *                         setFrameStatsEnabled                        *
+ ***********************************************************************/
+void Controller::setFrameStatsEnabled(bool enable)
+{
+   FrameStats::setEnabled(enable);
+}
+
+/***********************************************************************
+ *                          getLastFrameStats                          *
+ ***********************************************************************/
+FrameStats Controller::getLastFrameStats()
+{
+   bool locked = lockIfNotFrameOwner();
+   FrameStats stats = lastFrameStats;
+   unlockIfLocked(locked);
+
+   return stats;
+}
+
+/***********************************************************************
+ *                        getFrameStatsHistory                         *
+ ***********************************************************************/
+void Controller::getFrameStatsHistory(std::vector<FrameStats>& history)
+{
+   bool locked = lockIfNotFrameOwner();
+
+   history.clear();
+   history.reserve(frameStatsHistoryTotal);
+   size_t size = frameStatsHistory.size();
+   for(size_t i = 0; i < frameStatsHistoryTotal; i++)
+   {
+      /* Oldest is just after the newest, when history is full */
+      history.push_back(frameStatsHistory[(frameStatsHistoryPos + size - 
+               frameStatsHistoryTotal + i) % size]);
+   }
+
+   unlockIfLocked(locked);
+}
+
+/***********************************************************************
+ *                      setFrameStatsHistorySize                       *
+ ***********************************************************************/
+void Controller::setFrameStatsHistorySize(int frames)
+{
+   bool locked = lockIfNotFrameOwner();
+
+   frameStatsHistory.assign((frames > 0) ? frames : 0, FrameStats());
+   frameStatsHistoryPos = 0;
+   frameStatsHistoryTotal = 0;
+
+   unlockIfLocked(locked);
+}
+
 /***********************************************************************
  *                         getTotalRootWidgets                         *
  ***********************************************************************/
 int Controller::getTotalRootWidgets()
 {
-   mutex.lock();
+   lockMutex();
    int total = widgets->getTotal();
    mutex.unlock();
 
@@ -703,13 +985,106 @@ const bool Controller::insertFromJson(const Kobold::String& jsonStr,
 }
 #endif
 
+/***********************************************************************
+ *                              lockMutex                              *
+ ***********************************************************************/
+void Controller::lockMutex()
+{
+   mutex.lock();
+   locks++;
+}
+
+/***********************************************************************
+ *                         lockIfNotFrameOwner                         *
+ ***********************************************************************/
+bool Controller::lockIfNotFrameOwner()
+{
+   if(frameOwner.load() == std::this_thread::get_id())
+   {
+      /* Already locked by this thread for the current frame */
+      return false;
+   }
+
+   lockMutex();
+   return true;
+}
+
+/***********************************************************************
+ *                           unlockIfLocked                            *
+ ***********************************************************************/
+void Controller::unlockIfLocked(bool locked)
+{
+   if(locked)
+   {
+      mutex.unlock();
+   }
+}
+
+/***********************************************************************
+ *                            queueCommand                             *
+ ***********************************************************************/
+void Controller::queueCommand(const WidgetCommand& cmd)
+{
+   commandQueue.push(cmd);
+}
+
+/***********************************************************************
+ *                        discardQueuedCommands                        *
+ ***********************************************************************/
+void Controller::discardQueuedCommands(Widget* widget)
+{
+   /* The queue has a single consumer, so must be under our lock */
+   bool locked = lockIfNotFrameOwner();
+   commandQueue.discard(widget);
+   unlockIfLocked(locked);
+}
+
+/***********************************************************************
+ *                         applyQueuedCommands                         *
+ ***********************************************************************/
+void Controller::applyQueuedCommands()
+{
+   assert(frameOwner.load() == std::this_thread::get_id());
+
+   std::vector<WidgetCommand*> cmds;
+   commandQueue.pop(cmds);
+
+   for(size_t i = 0; i < cmds.size(); i++)
+   {
+      Widget* target = cmds[i]->getWidget();
+      if(target == NULL)
+      {
+         /* Addressed by id. Note: we already have the lock here, so must
+          * search the map directly instead of calling getWidgetById. */
+         std::map<Kobold::String, Widget*>::iterator it = 
+            idMap.find(cmds[i]->getId());
+         if(it != idMap.end())
+         {
+            target = (*it).second;
+         }
+      }
+
+      if(target != NULL)
+      {
+         cmds[i]->apply(target);
+      }
+      else
+      {
+         Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+               "Error: no widget '%s' to apply queued command!",
+               cmds[i]->getId().c_str());
+      }
+      delete cmds[i];
+   }
+}
+
 /***********************************************************************
  *                           setIdReference                            *
  ***********************************************************************/
 void Controller::setIdReference(const Kobold::String& id, Widget* ref)
 {
    assert(getWidgetById(id) == NULL);
-   mutex.lock();
+   lockMutex();
    idMap[id] = ref;
    mutex.unlock();
 }
@@ -721,7 +1096,7 @@ void Controller::clearIdReference(const Kobold::String& id)
 {
    if(getWidgetById(id) != NULL)
    {
-      mutex.lock();
+      lockMutex();
       idMap[id] = NULL;
       mutex.unlock();
    }
@@ -734,13 +1109,13 @@ Widget* Controller::getWidgetById(const Kobold::String& id)
 {
    Widget* res = NULL;
 
-   mutex.lock();
+   bool locked = lockIfNotFrameOwner();
    std::map<Kobold::String, Widget*>::iterator it = idMap.find(id);
    if(it != idMap.end())
    {
       res = (*it).second;
    }
-   mutex.unlock();
+   unlockIfLocked(locked);
 
    return res;
 }
@@ -749,19 +1124,37 @@ Widget* Controller::getWidgetById(const Kobold::String& id)
  *                               Static                                *
  ***********************************************************************/
 Loader* Controller::loader = NULL;
-Skin* Controller::skin = NULL;
+std::atomic<Skin*> Controller::skin(NULL);
 Renderer* Controller::renderer = NULL;
 Kobold::List* Controller::renderers = NULL;
 Kobold::List* Controller::widgets = NULL;
 Kobold::List* Controller::toRemoveWidgets = NULL;
 bool Controller::inited = false;
-Widget* Controller::activeWidget = NULL;
+std::atomic<Widget*> Controller::activeWidget(NULL);
 Event Controller::event(NULL, EVENT_NONE);
 int Controller::width = 0;
 int Controller::height = 0;
 Kobold::String Controller::baseDir;
 bool Controller::forceBringToFrontCall = false;
 bool Controller::mouseOverWidget = false;
+bool Controller::hitTestIndexEnabled = true;
+bool Controller::lastLeftButtonPressed = false;
+bool Controller::lastRightButtonPressed = false;
+int Controller::lastMouseX = -1;
+int Controller::lastMouseY = -1;
+bool Controller::overMouseHint = false;
+bool Controller::presentNeeded = true;
+RasterPool* Controller::rasterPool = NULL;
+std::vector<Widget*> Controller::pendingDraw;
+WidgetCommandQueue Controller::commandQueue;
 Kobold::Mutex Controller::mutex;
+std::atomic<std::thread::id> Controller::frameOwner;
+std::atomic<unsigned int> Controller::locks(0);
+unsigned int Controller::lastFrameLocks = 0;
+uint64_t Controller::frameCount = 0;
+FrameStats Controller::lastFrameStats;
+std::vector<FrameStats> Controller::frameStatsHistory;
+size_t Controller::frameStatsHistoryPos = 0;
+size_t Controller::frameStatsHistoryTotal = 0;
 std::map<Kobold::String, Widget*> Controller::idMap;
 
@@ -33,12 +33,14 @@
 #include "event.h"
 #include "fileselector.h"
 #include "font.h"
+#include "framestats.h"
 #include "grid.h"
 #include "label.h"
 #include "labelledpicture.h"
 #include "menu.h"
 #include "picture.h"
 #include "progressbar.h"
+#include "rasterpool.h"
 #include "renderer.h"
 #include "scrollbar.h"
 #include "scrolltext.h"
@@ -47,15 +49,20 @@
 #include "stacktab.h"
 #include "textentry.h"
 #include "textselector.h"
+#include "trace.h"
 #include "treeview.h"
 #include "widget.h"
+#include "widgetcommand.h"
 #include "widgetjsonparser.h"
 #include "window.h"
 
 #include <kobold/list.h>
 #include <kobold/mutex.h>
 
+#include <atomic>
 #include <map>
+#include <thread>
+#include <vector>
 
 namespace Farso
 {
@@ -63,7 +70,10 @@ namespace Farso
 /*! The controller is the main access point to Farso, with all
  * current options and widgets. It's a static class, single per
  * application.
- * \note this class isn't tread safe. */
+ * \note this class isn't tread safe, except where noted. verifyEvents
+ *       holds its lock for the whole frame, so the accessors called from
+ *       inside it (getActiveWidget, getSkin, setEvent, getWidgetById, 
+ *       etc.) won't lock again. */
 class Controller
 {
    public:
@@ -77,10 +87,17 @@ class Controller
        *                Must end with a trail '/'.
        * \note baseDir is ignored on Ogre3d, in favor of its own resource 
        *               manager (thus make sure that baseDir is at a defined
-       *               resource group). */ 
+       *               resource group). 
+       * \param premultipliedAlpha if surfaces should be kept with
+       *        premultiplied alpha (loaded images are converted on load
+       *        and widgets composited with a (ONE, ONE_MINUS_SRC_ALPHA)
+       *        blend), which avoids dark fringes around translucent
+       *        edges. Colors are still defined with straight alpha.
+       *        Ignored (with a warning) if the renderer doesn't support
+       *        it (see Renderer::supportsPremultipliedAlpha). */ 
       static void init(Loader* loader, Renderer* renderer, 
             int screenWidth, int screenHeight, int maxCursorSize, 
-            const Kobold::String& baseDir); 
+            const Kobold::String& baseDir, bool premultipliedAlpha = false); 
       /*! Finish with the farso controller (usually called at exit). */
       static void finish();
 
@@ -118,6 +135,9 @@ class Controller
       /*! \return pointer to current draw interface to use */
       static Draw* getDraw();
 
+      /*! \return if surfaces are kept with premultiplied alpha */
+      static const bool isPremultipliedAlpha();
+
       /*! \return pointer to the used loader */
       static Loader* getLoader();
 
@@ -145,10 +165,20 @@ class Controller
        * \param mouseX cursor (mouse or finger) current X coordinate
        * \param mouseY cursor (mouse or finger) current Y coordinate
        * \return true if got an event, that should be accessible with
-       *         getLastEvent. */
+       *         getLastEvent. 
+       * \note when the input is the same of the last call, without any 
+       *       pressed button, and no widget is dirty nor animating, the 
+       *       widgets aren't treated nor drawn again (only rendered, for
+       *       renderers that need manual render). */
       static bool verifyEvents(bool leftButtonPressed, bool rightButtonPressed,
             int mouseX, int mouseY);
 
+      /*! \return if the visual output of Farso changed on the last call to
+       *          verifyEvents. When false, the application could skip 
+       *          presenting a new frame (for example, SDL_RenderPresent or
+       *          buffer swap) if nothing else of its own changed. */
+      static const bool needsPresent() { return presentNeeded; };
+
       /*! Set a widget to be the current active on (with focus), also
        * setting the current active one as inactive.
        * \note widget must own its renderer to be set as active. Otherwise,
@@ -191,6 +221,41 @@ class Controller
        *          verifyEvents */
       static const bool wasMouseOverWidget() { return mouseOverWidget; };
 
+      /*! Enable or disable the use of each renderer's WidgetIndex to only
+       * check widgets under the cursor when just hovering (enabled by 
+       * default). Disable only to compare or debug.
+       * \param enable true to enable, false to always check all widgets. */
+      static void setHitTestIndexEnabled(bool enable) 
+      { 
+         hitTestIndexEnabled = enable; 
+      };
+      /*! Define if dirty root widgets should be rasterized in parallel, 
+       * by a pool of threads (disabled by default). Uploads to the 
+       * renderer are still done at the rendering thread (the one calling
+       * verifyEvents).
+       * \param threads number of worker threads to use (besides the 
+       *        rendering one), up to FARSO_RASTER_MAX_THREADS. 0 to disable
+       *        the parallel rasterization.
+       * \note Must not be called while calling verifyEvents. */
+      static void setParallelDraw(int threads);
+      /*! \return number of worker threads used to rasterize dirty root 
+       *          widgets. 0 when not parallel. */
+      static const int getParallelDrawThreads();
+
+      /*! \return number of times the Controller lock was acquired by the
+       *          last verifyEvents call (including its own lock), and by 
+       *          any call from other threads since the previous one. */
+      static const unsigned int getLastFrameLockCount() 
+      { 
+         return lastFrameLocks; 
+      };
+
+      /*! \return if WidgetIndex is used for hit tests when hovering. */
+      static const bool isHitTestIndexEnabled() 
+      { 
+         return hitTestIndexEnabled; 
+      };
+
       /*! Set Widget reference for a string identifier.
        * \note id must be unique.
        * \param id string identifier
@@ -233,6 +298,42 @@ class Controller
             bool loadWindows=true);
 #endif
 
+      /*! Queue a command to mutate a widget, to be applied at the start 
+       * of next verifyEvents call. Repeated commands to the same widget
+       * property are coalesced (only the last one is applied).
+       * \note this is lock-free and could be called from any thread, 
+       *       without the need to wait for the current frame.
+       * \note commands addressed by pointer to a widget deleted before
+       *       they are applied are discarded, but none should be queued
+       *       after its deletion. Threads that don't control the widget's
+       *       lifetime should address it by id instead.
+       * \param cmd command to queue. For example:
+       *        Controller::queueCommand(WidgetCommand::setValue(bar, 10)) */
+      static void queueCommand(const WidgetCommand& cmd);
+
+      /*! Discard all queued commands addressed to a widget pointer.
+       * \note called on widget's destructor. */
+      static void discardQueuedCommands(Widget* widget);
+
+      /*! Enable or disable the per frame statistics gathering. 
+       * \note thread safe. Could be toggled at any time. */
+      static void setFrameStatsEnabled(bool enable);
+      /*! \return if gathering per frame statistics */
+      static bool isFrameStatsEnabled() { return FrameStats::isEnabled(); };
+
+      /*! \return statistics of the last verifyEvents call (zeroed if 
+       *          statistics were disabled on that frame). */
+      static FrameStats getLastFrameStats();
+
+      /*! Get the statistics of the last frames.
+       * \param history vector to put them into, from oldest to newest.
+       * \note only frames with statistics enabled are kept. */
+      static void getFrameStatsHistory(std::vector<FrameStats>& history);
+
+      /*! Set how many frames are kept on the statistics history. 
+       * \note changing it clears the current history. */
+      static void setFrameStatsHistorySize(int frames);
+
       /*! Remove an event listener from a widget, thread safelly */
       static void removeEventListener(Widget* owner, 
             WidgetEventListener* listener);
@@ -257,6 +358,27 @@ class Controller
             bool leftButtonPressed, bool rightButtonPressed,
             int mouseX, int mouseY, bool checkEvents);
 
+      /*! \return if nothing changed since last verifyEvents call, thus
+       * there's no need to treat and draw widgets again. */
+      static bool isIdle(bool leftButtonPressed, bool rightButtonPressed,
+            int mouseX, int mouseY);
+
+      /*! Acquire the lock, counting it */
+      static void lockMutex();
+      /*! Acquire the lock, if the current thread doesn't own the current
+       * frame (ie: it isn't inside verifyEvents).
+       * \return if locked (and thus should call unlockIfLocked) */
+      static bool lockIfNotFrameOwner();
+      /*! Release the lock if acquired by lockIfNotFrameOwner 
+       * \param locked lockIfNotFrameOwner return value */
+      static void unlockIfLocked(bool locked);
+
+      /*! Apply all commands queued by queueCommand. */
+      static void applyQueuedCommands();
+
+      /*! Rasterize, in parallel, all the pending to draw root widgets. */
+      static void drawPending();
+
       /*! Mark all widgets dirty. Usually called when changed skins. */
       static void markAllDirty();
 
@@ -266,7 +388,8 @@ class Controller
       static void bringFront(Widget* widget);
 
       static Loader* loader; /**< current loader */
-      static Skin* skin; /**< Current skin used, if any (null for no skins). */
+      static std::atomic<Skin*> skin; /**< Current skin used, if any 
+                                        (null for no skins). */
       static Renderer* renderer; /**< Current Renderer */
       static Kobold::List* toRemoveWidgets; /**< List with current 
                                       'first-level' widgets to be removed */
@@ -274,7 +397,7 @@ class Controller
                                      (ie: without a parent) widgets. */
       static Kobold::List* renderers; /**< List of active WidgetRenderers */
       static bool inited; /**< Inited flag.*/
-      static Widget* activeWidget; /**< Current active widget */
+      static std::atomic<Widget*> activeWidget; /**< Current active widget */
       static Event event; /**< Last event. */
 
       static bool forceBringToFrontCall; /**< When the active widget changed 
@@ -286,8 +409,32 @@ class Controller
       static Kobold::String baseDir; /**< Base directory */
 
       static bool mouseOverWidget; /**< If mouse is under any widget */
+      static bool hitTestIndexEnabled; /**< If use WidgetIndex on treat */
+
+      static RasterPool* rasterPool; /**< Pool for parallel draw, if any */
+      static std::vector<Widget*> pendingDraw; /**< Root widgets to draw */
+
+      static bool lastLeftButtonPressed; /**< Left button on last verify */
+      static bool lastRightButtonPressed; /**< Right button on last verify */
+      static int lastMouseX; /**< Mouse X coordinate on last verify */
+      static int lastMouseY; /**< Mouse Y coordinate on last verify */
+      static bool overMouseHint; /**< If cursor was over a mouse hint */
+      static bool presentNeeded; /**< If visual changed on last verify */
+
+      static WidgetCommandQueue commandQueue; /**< Queued commands */
 
       static Kobold::Mutex mutex; /**< Mutex for thread-safe use */
+      static std::atomic<std::thread::id> frameOwner; /**< Thread inside 
+                                                        verifyEvents */
+      static std::atomic<unsigned int> locks; /**< Locks since last frame */
+      static unsigned int lastFrameLocks; /**< Locks on last frame */
+
+      static uint64_t frameCount; /**< Frames since init */
+      static FrameStats lastFrameStats; /**< Last frame statistics */
+      static std::vector<FrameStats> frameStatsHistory; /**< Rolling history
+                                                          of statistics */
+      static size_t frameStatsHistoryPos; /**< Next history position */
+      static size_t frameStatsHistoryTotal; /**< Frames at the history */
 
       static std::map<Kobold::String, Widget*> idMap; /**< Map for id->widget */
 };
@@ -269,6 +269,7 @@ void Cursor::unloadUnusedCursors()
 void Cursor::setTextualTip(const Kobold::String& tip)
 {
    tipTimer.reset();
+   tipSet = !tip.empty();
 
    /* Only update tip if changed */
    if(textualTip != tip)
@@ -420,6 +421,7 @@ int Cursor::getTipHeight()
  ************************************************************************/
 void Cursor::checkTipExpiration()
 {
+   tipSet = false;
    if( (!textualTip.empty()) &&
        (tipTimer.getMilliseconds() >= CURSOR_TIP_EXPIRE_TIME) )
    {
@@ -479,6 +481,7 @@ bool Cursor::definedTipFont = false;
 Kobold::String Cursor::tipFont;
 int Cursor::tipFontSize = 0;
 Kobold::Timer Cursor::tipTimer;
+bool Cursor::tipSet = false;
 int Cursor::maxSize = 0;
 Cursor::CursorImage* Cursor::current = NULL;
 
@@ -99,6 +99,11 @@ class Cursor
       /*! Check if tip expired, if defined. */
       static void checkTipExpiration();
 
+      /*! \return if a non-empty tip was set since the last call to 
+       * checkTipExpiration (ie: if the cursor is over some widget with
+       * mouse hint). */
+      static const bool wasTipSet() { return tipSet; };
+
       /*! Set which font to use for writing tips
        * \param fontFilename font's filename 
        * \param size font's size
@@ -161,6 +166,7 @@ class Cursor
       static Kobold::String tipFont; /**< Current tip font name */
       static int tipFontSize; /**< Current tip font size */
       static Kobold::Timer tipTimer; /**< Timer of last set tip */
+      static bool tipSet; /**< If tip set since last expiration check */
       static int maxSize; /**< Maximum cursor size */
       static CursorImage* current; /**< Current cursor image, if any */
 };
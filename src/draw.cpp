@@ -31,7 +31,11 @@ using namespace Farso;
  ******************************************************************/
 Draw::Draw()
 {
-  setActiveColor(0, 0, 0, 255);
+   premultipliedAlpha = false;
+   for(int i = 0; i <= FARSO_RASTER_MAX_THREADS; i++)
+   {
+      colors[i].set(0, 0, 0, 255);
+   }
 }
 
 /******************************************************************
@@ -47,11 +51,11 @@ Draw::~Draw()
  ******************************************************************/
 void Draw::setActiveColor(Uint8 Ri, Uint8 Gi, Uint8 Bi, Uint8 Ai)
 {
-   curColor.set(Ri, Gi, Bi, Ai);
+   curColor().set(Ri, Gi, Bi, Ai);
 }
 void Draw::setActiveColor(Color color)
 {
-   curColor = color;
+   curColor() = color;
 }
 
 /******************************************************************
@@ -59,14 +63,15 @@ void Draw::setActiveColor(Color color)
  ******************************************************************/
 void Draw::getActiveColor(Uint8& Ri, Uint8& Gi, Uint8& Bi, Uint8& Ai)
 {
-   Ri = curColor.red;
-   Gi = curColor.green;
-   Bi = curColor.blue;
-   Ai = curColor.alpha;
+   const Color& color = curColor();
+   Ri = color.red;
+   Gi = color.green;
+   Bi = color.blue;
+   Ai = color.alpha;
 }
 Color Draw::getActiveColor()
 {
-   return curColor;
+   return curColor();
 }
 
 /******************************************************************
@@ -74,8 +79,8 @@ Color Draw::getActiveColor()
  ******************************************************************/
 void Draw::setPixel(Surface* surface, int x, int y)
 {
-   setPixel(surface, x, y, curColor.red, curColor.green, curColor.blue,
-         curColor.alpha);
+   Color color = getWriteColor(curColor());
+   setPixel(surface, x, y, color.red, color.green, color.blue, color.alpha);
 }
 
 /******************************************************************
@@ -92,17 +97,9 @@ void Draw::setPixel(Surface* surface, int x, int y, float bright)
    {
       factor = 1.0f;
    }
-   setPixel(surface, x, y, curColor.red * factor, curColor.green * factor, 
-            curColor.blue * factor, curColor.alpha);
-}
-
-/******************************************************************
- *                              __round                             *
- ******************************************************************/
-inline int __round(const float a)
-{
-   /* Used to the line draw function */
-   return (int)(a+0.5);
+   Color color = getWriteColor(curColor());
+   setPixel(surface, x, y, color.red * factor, color.green * factor, 
+            color.blue * factor, color.alpha);
 }
 
 /******************************************************************
@@ -110,44 +107,7 @@ inline int __round(const float a)
  ******************************************************************/
 void Draw::doLine(Surface* surface, int x1, int y1, int x2, int y2)
 {
-   /* Define deltas (width and height) */
-   int dx = x2 - x1;
-   int dy = y2 - y1;
-   int steps, k;
-   float xInc, yInc, x = x1, y = y1;
- 
-   /* Define needed steps */
-   if(abs(dx) > abs(dy))
-   {
-      steps = abs(dx);
-   }
-   else
-   {
-      steps = abs(dy);
-   }
-
-   /* Let's iterate and set each line pixel */
-   xInc = (float) (dx) / (float) (steps);
-   yInc = (float) (dy) / (float) (steps);
-
-   setPixel(surface, __round(x), __round(y));
-   for(k = 0; k < steps; k++)
-   {
-      x += xInc;
-      y += yInc;
-      setPixel(surface, __round(x), __round(y));
-   }
-}
-
-inline float fpart(const float a)
-{
-   /* Define fractional part of a */
-   return a - (int)(a);
-}
-
-inline float rfpart(const float a)
-{
-   return 1 - fpart(a);
+   rasterize(surface, Primitive(Primitive::PRIMITIVE_LINE, x1, y1, x2, y2));
 }
 
 /******************************************************************
@@ -155,82 +115,8 @@ inline float rfpart(const float a)
  ******************************************************************/
 void Draw::doAntiAliasedLine(Surface* surface, int x1, int y1, int x2, int y2)
 {
-   float dx = (float)x2 - (float)x1;
-   float dy = (float)y2 - (float)y1;
-   if( fabsf(dx) > fabsf(dy) ) 
-   {
-      if ( x2 < x1 ) 
-      {
-         int tmp = x1;
-         x1 = x2;
-         x2 = tmp;
-         tmp = y1;
-         y1 = y2;
-         y2 = tmp;
-      }
-      float gradient = dy / dx;
-      float xend = __round((float) x1);
-      float yend = y1 + gradient*(xend - x1);
-      float xgap = rfpart(x1 + 0.5f);
-      int xpxl1 = xend;
-      int ypxl1 = (int)(yend);
-      setPixel(surface, xpxl1, ypxl1, rfpart(yend)*xgap);
-      setPixel(surface, xpxl1, ypxl1+1, fpart(yend)*xgap);
-      float intery = yend + gradient;
-
-      xend = __round((float)x2);
-      yend = y2 + gradient*(xend - x2);
-      xgap = fpart(x2 + 0.5f);
-      int xpxl2 = xend;
-      int ypxl2 = (int)(yend);
-      setPixel(surface, xpxl2, ypxl2, rfpart(yend) * xgap);
-      setPixel(surface, xpxl2, ypxl2 + 1, fpart(yend) * xgap);
-
-      int x;
-      for(x=xpxl1+1; x <= (xpxl2-1); x++) 
-      {
-         setPixel(surface, x, (int)(intery), rfpart(intery));
-         setPixel(surface, x, (int)(intery) + 1, fpart(intery));
-         intery += gradient;
-      }
-   } 
-   else 
-   {
-      if ( y2 < y1 ) 
-      {
-         int tmp = x1;
-         x1 = x2;
-         x2 = tmp;
-         tmp = y1;
-         y1 = y2;
-         y2 = tmp;
-      }
-      float gradient = dx / dy;
-      float yend = __round((float) y1);
-      float xend = x1 + gradient * (yend - y1);
-      float ygap = rfpart(y1 + 0.5f);
-      int ypxl1 = yend;
-      int xpxl1 = (int)(xend);
-      setPixel(surface, xpxl1, ypxl1, rfpart(xend)*ygap);
-      setPixel(surface, xpxl1, ypxl1+1, fpart(xend)*ygap);
-      float interx = xend + gradient;
-
-      yend = __round((float)y2);
-      xend = x2 + gradient*(yend - y2);
-      ygap = fpart(y2+0.5);
-      int ypxl2 = yend;
-      int xpxl2 = (int)(xend);
-      setPixel(surface, xpxl2, ypxl2, rfpart(xend) * ygap);
-      setPixel(surface, xpxl2, ypxl2 + 1, fpart(xend) * ygap);
-
-      int y;
-      for(y=ypxl1+1; y <= (ypxl2-1); y++) 
-      {
-         setPixel(surface, (int)(interx), y, rfpart(interx));
-         setPixel(surface, (int)(interx) + 1, y, fpart(interx));
-         interx += gradient;
-      }
-   }
+   rasterize(surface, Primitive(Primitive::PRIMITIVE_ANTI_ALIASED_LINE, 
+            x1, y1, x2, y2));
 }
 
 /******************************************************************
@@ -319,88 +205,206 @@ void Draw::doTriangle(Surface* surface, int x1, int y1, int x2, int y2,
 }
 
 /******************************************************************
- *                          doTriangle                            *
+ *                        doFilledTriangle                        *
  ******************************************************************/
 void Draw::doFilledTriangle(Surface* surface, int x1, int y1, int x2, int y2, 
       int x3, int y3)
 {
+   /* Antialiased edges, with its interior filled over them */
    doTriangle(surface, x1, y1, x2, y2, x3, y3);
+   rasterize(surface, Primitive(Primitive::PRIMITIVE_FILLED_TRIANGLE, 
+            x1, y1, x2, y2, x3, y3));
+}
 
-   if(x3 < x2)
+/******************************************************************
+ *                          circle_Draw                           *
+ ******************************************************************/
+void Draw::doCircle(Surface* surface, int xC, int yC, int r)
+{
+   rasterize(surface, Primitive(Primitive::PRIMITIVE_CIRCLE, xC, yC, r, 0));
+}
+
+/******************************************************************
+ *                         doFilledCircle                         *
+ ******************************************************************/
+void Draw::doFilledCircle(Surface* surface, int xC, int yC, int r)
+{
+   rasterize(surface, Primitive(Primitive::PRIMITIVE_FILLED_CIRCLE, 
+            xC, yC, r, 0));
+}
+
+/******************************************************************
+ *                    doFilledRoundedRectangle                    *
+ ******************************************************************/
+void Draw::doFilledRoundedRectangle(Surface* surface, int x1, int y1, 
+      int x2, int y2, int radius, bool antiAliased)
+{
+   rasterize(surface, Primitive((antiAliased) ? 
+            Primitive::PRIMITIVE_ANTI_ALIASED_FILLED_ROUNDED_RECTANGLE :
+            Primitive::PRIMITIVE_FILLED_ROUNDED_RECTANGLE, 
+            x1, y1, x2, y2, radius));
+}
+
+/******************************************************************
+ *                           rasterize                            *
+ ******************************************************************/
+void Draw::rasterize(Surface* surface, const Primitive& primitive)
+{
+   SetPixelWriter writer(this, surface, getWriteColor(curColor()));
+   rasterize(writer, primitive);
+}
+
+/******************************************************************
+ *                        getWritableArea                         *
+ ******************************************************************/
+Rect Draw::getWritableArea(int surfaceWidth, int surfaceHeight) const
+{
+   Rect area(0, 0, surfaceWidth - 1, surfaceHeight - 1);
+   const Rect& clip = clipRect();
+   if(clip.isDefined())
    {
-      int tmp = x2;
-      x2 = x3;
-      x3 = tmp;
+      area = area.getIntersection(clip);
    }
-   if(y3 < y2)
+   return area;
+}
+
+/******************************************************************
+ *                         SetPixelWriter                         *
+ ******************************************************************/
+Draw::SetPixelWriter::SetPixelWriter(Draw* draw, Surface* surface, 
+      const Color& color)
+{
+   this->draw = draw;
+   this->surface = surface;
+   this->color = color;
+   this->premultiplied = draw->isPremultipliedAlpha();
+   this->clip = draw->getClipRect();
+}
+
+/******************************************************************
+ *                            setPixel                            *
+ ******************************************************************/
+void Draw::SetPixelWriter::setPixel(int x, int y)
+{
+   draw->setPixel(surface, x, y, color.red, color.green, color.blue, 
+         color.alpha);
+}
+
+/******************************************************************
+ *                            setPixel                            *
+ ******************************************************************/
+void Draw::SetPixelWriter::setPixel(int x, int y, float bright)
+{
+   float factor = bright;
+   if(factor < 0.1f)
    {
-      int tmp = y2;
-      y2 = y3;
-      y3 = tmp;
+      factor = 0.1f;
    }
-   
-   if(x2 == x3)
+   if(factor > 1.0f)
    {
-      int delta = 1;
-      if(x1 > x2)
-      {
-         delta = -1;
-      }
-      for(int y = y2 + 1; y < y3; y++)
-      {
-         doLine(surface, x1 + delta, y1, x2 - delta, y);
-      }
+      factor = 1.0f;
+   }
+   draw->setPixel(surface, x, y, color.red * factor, color.green * factor, 
+            color.blue * factor, color.alpha);
+}
 
+/******************************************************************
+ *                           coverPixel                           *
+ ******************************************************************/
+void Draw::SetPixelWriter::coverPixel(int x, int y, Uint8 coverage)
+{
+   if(coverage == 255)
+   {
+      /* Fully covered: just like the spans */
+      setPixel(x, y);
+      return;
    }
-   else if(y2 == y3)
+
+   /* Source color, with its alpha (and its channels, if premultiplied) 
+    * multiplied by the coverage */
+   Uint8 sa = (color.alpha * coverage + 127) / 255;
+   Uint8 sr = color.red;
+   Uint8 sg = color.green;
+   Uint8 sb = color.blue;
+   if(premultiplied)
    {
-      int delta = 1;
-      if(y1 > y2)
-      {
-         delta = -1;
-      }
+      sr = (color.red * coverage + 127) / 255;
+      sg = (color.green * coverage + 127) / 255;
+      sb = (color.blue * coverage + 127) / 255;
+   }
+
+   /* Blend it over the current pixel (note: getPixel won't change them
+    * outside the surface, where setPixel won't write either). */
+   Uint8 tr = 0, tg = 0, tb = 0, ta = 0;
+   draw->getPixel(surface, x, y, tr, tg, tb, ta);
+   draw->blendColor(sr, sg, sb, sa, tr, tg, tb, ta);
+   draw->setPixel(surface, x, y, tr, tg, tb, ta);
+}
 
-      for(int x = x2 + 1; x < x3; x++)
+/******************************************************************
+ *                             hSpan                              *
+ ******************************************************************/
+void Draw::SetPixelWriter::hSpan(int x1, int x2, int y)
+{
+   if(x1 > x2)
+   {
+      int tmp = x1;
+      x1 = x2;
+      x2 = tmp;
+   }
+
+   /* Clip the span once, instead of each of its pixels */
+   if(clip.isDefined())
+   {
+      if((y < clip.getY1()) || (y > clip.getY2()))
       {
-         doLine(surface, x1, y1 + delta, x, y2 - delta);
+         return;
       }
+      x1 = (x1 < clip.getX1()) ? clip.getX1() : x1;
+      x2 = (x2 > clip.getX2()) ? clip.getX2() : x2;
    }
-   else
+
+   for(int x = x1; x <= x2; x++)
    {
-      //TODO.
+      setPixel(x, y);
    }
-
 }
 
 /******************************************************************
- *                          circle_Draw                           *
+ *                             vSpan                              *
  ******************************************************************/
-void Draw::doCircle(Surface* surface, int xC, int yC, int r)
+void Draw::SetPixelWriter::vSpan(int x, int y1, int y2)
 {
-   int x=0, y=r,u=1,v=2*r-1,E=0;
-   while(x < y)
+   if(y1 > y2)
    {
-     setPixel(surface, xC+x, yC+y);
-     setPixel(surface, xC+y, yC-x);
-     setPixel(surface, xC-x, yC-y);
-     setPixel(surface, xC-y, yC+x);
-     x++; E+= u; u+=2;
-     if (v < 2 * E)
-     {
-         y--;
-         E -= v;
-         v -= 2;
-      }
-      /* Must check if not done. */
-      if (x > y)
+      int tmp = y1;
+      y1 = y2;
+      y2 = tmp;
+   }
+
+   /* Clip the span once, instead of each of its pixels */
+   if(clip.isDefined())
+   {
+      if((x < clip.getX1()) || (x > clip.getX2()))
       {
-         break;
+         return;
       }
-      setPixel(surface, xC+y, yC+x);
-      setPixel(surface, xC+x, yC-y);
-      setPixel(surface, xC-y, yC-x);
-      setPixel(surface, xC-x, yC+y);
+      y1 = (y1 < clip.getY1()) ? clip.getY1() : y1;
+      y2 = (y2 > clip.getY2()) ? clip.getY2() : y2;
    }
+
+   for(int y = y1; y <= y2; y++)
+   {
+      setPixel(x, y);
+   }
+}
+
+/******************************************************************
+ *                     setPremultipliedAlpha                      *
+ ******************************************************************/
+void Draw::setPremultipliedAlpha(bool premultiplied)
+{
+   premultipliedAlpha = premultiplied;
 }
 
 /******************************************************************
@@ -416,12 +420,84 @@ int Draw::smallestPowerOfTwo(int num)
    return(i);
 }
 
+/******************************************************************
+ *                          setClipRect                           *
+ ******************************************************************/
+void Draw::setClipRect(const Rect& area)
+{
+   clipRect() = area;
+}
+
+/******************************************************************
+ *                         clearClipRect                          *
+ ******************************************************************/
+void Draw::clearClipRect()
+{
+   clipRect() = Rect();
+}
+
+/******************************************************************
+ *                          pushClipRect                          *
+ ******************************************************************/
+bool Draw::pushClipRect(const Rect& area)
+{
+   Rect& clip = clipRect();
+   clipStacks[RasterPool::getCurrentSlot()].push_back(clip);
+
+   if(clip.isDefined())
+   {
+      clip = clip.getIntersection(area);
+   }
+   else
+   {
+      clip = area;
+   }
+
+   if((!clip.isDefined()) || (clip.getX1() > clip.getX2()) || 
+      (clip.getY1() > clip.getY2()))
+   {
+      /* Nothing left: keep a defined, but empty, clip rectangle, as an 
+       * undefined one would mean not clipping at all. */
+      clip = Rect(0, 0, -1, -1);
+      return false;
+   }
+
+   return true;
+}
+
+/******************************************************************
+ *                          popClipRect                           *
+ ******************************************************************/
+void Draw::popClipRect()
+{
+   std::vector<Rect>& stack = clipStacks[RasterPool::getCurrentSlot()];
+   if(stack.empty())
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: popClipRect without a pushClipRect!");
+      return;
+   }
+
+   clipRect() = stack.back();
+   stack.pop_back();
+}
+
 /******************************************************************
  *                          blendColor                            *
  ******************************************************************/
 void Draw::blendColor(Uint8 sr, Uint8 sg, Uint8 sb, Uint8 sa, 
                       Uint8& tr, Uint8& tg, Uint8& tb, Uint8& ta)
 {
+   if(premultipliedAlpha)
+   {
+      /* Just a multiply-add per channel */
+      tr = blendPremultiplied(sr, tr, sa);
+      tg = blendPremultiplied(sg, tg, sa);
+      tb = blendPremultiplied(sb, tb, sa);
+      ta = blendPremultiplied(sa, ta, sa);
+      return;
+   }
+
    if(ta == 0)
    {
       /* Must use just the source */
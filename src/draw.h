@@ -26,10 +26,15 @@
 #include "farsoconfig.h"
 #include "surface.h"
 #include "colors.h"
+#include "rect.h"
+#include "rasterpool.h"
+#include "pixelwriter.h"
 
 #include <ft2build.h>
 #include FT_IMAGE_H
 
+#include <vector>
+
 
 namespace Farso
 {
@@ -153,7 +158,7 @@ class Draw
             int x3, int y3);
 
       /*! Draw a filled triangle with edges (x1,y1) (x2, y2) and (x3, y3) 
-       * to a surface. */
+       * to a surface (of any shape, filled by scanlines). */
       void doFilledTriangle(Surface* surface, int x1, int y1, int x2, int y2, 
             int x3, int y3);
 
@@ -164,6 +169,27 @@ class Draw
        * \param r  -> circle radius */
       void doCircle(Surface* surface, int xC, int yC, int r);
 
+      /*! Draw a filled circle to the surface
+       * \param surface -> surface where draw the cricle
+       * \param xC -> circle X center coordinate
+       * \param yC -> circle Y center coordinate
+       * \param r  -> circle radius */
+      void doFilledCircle(Surface* surface, int xC, int yC, int r);
+
+      /*! Draw and fill a rectangle with rounded corners on surface
+       * \param surface -> bitmap to draw to
+       * \param x1 -> x initial coordinate
+       * \param y1 -> y initial coordinate
+       * \param x2 -> x final coordinate
+       * \param y2 -> y final coordinate
+       * \param radius -> corners radius
+       * \param antiAliased -> if true, corner edge pixels will have their 
+       *        alpha proportional to how much of them is inside the 
+       *        corner (as any primitive, they overwrite the surface 
+       *        pixels, thus this is meant for surfaces to be composited). */
+      void doFilledRoundedRectangle(Surface* surface, int x1, int y1, 
+            int x2, int y2, int radius, bool antiAliased = false);
+
       /*! Stamp the source surface rectangle (sx1, sy1, sx2, sy2) at 
        * target's rectangle(tx1, ty1, tx2, ty2), repeating the source 
        * rectangle if necessary (ie: source rectangle < target rectangle).
@@ -193,12 +219,166 @@ class Draw
       virtual void doFreeTypeStamp(Surface* target, int x, int y, 
             FT_Bitmap* bitmap, int left, int top) = 0;
 
+      /*! Define a clip rectangle: any draw primitive will only affect
+       * pixels inside it, until a clearClipRect call.
+       * \param area clip rectangle, in surface coordinates. 
+       * \note it replaces the current one, ignoring pushed ones. Use 
+       *       pushClipRect to restrict it instead. */
+      void setClipRect(const Rect& area);
+
+      /*! Clear the current clip rectangle, if any */
+      void clearClipRect();
+
+      /*! \return current clip rectangle. Undefined if not clipping. */
+      const Rect& getClipRect() const { return clipRect(); };
+
+      /*! Push a clip rectangle, intersecting it with the current one.
+       * Primitives, stamps and glyphs are clipped to it (once, before 
+       * drawing) until its popClipRect call.
+       * \param area clip rectangle, in surface coordinates.
+       * \return if any pixel is still drawable (ie: the intersection
+       *         isn't empty). 
+       * \note each push must be paired with a popClipRect call, even
+       *       when returning false. */
+      bool pushClipRect(const Rect& area);
+
+      /*! Restore the clip rectangle active before the last pushClipRect */
+      void popClipRect();
+
+      /*! Define if surfaces are kept in premultiplied alpha (ie: color 
+       * channels already multiplied by alpha). Colors are still defined
+       * as straight alpha, being converted when written.
+       * \note usually only set by Controller::init, as all surfaces 
+       *       must be created and loaded with the same option. */
+      void setPremultipliedAlpha(bool premultiplied);
+      /*! \return if surfaces are kept in premultiplied alpha */
+      const bool isPremultipliedAlpha() const { return premultipliedAlpha; };
+
       /*! Return the smallest power of two greater or equal to the number
        * \param num -> bases number 
        * \return -> smallest power of two greater or equal to the number */
       int smallestPowerOfTwo(int num);
 
    protected:
+      /*! A primitive, drawn with the active color */
+      class Primitive
+      {
+         public:
+            /*! Primitive types */
+            enum PrimitiveType
+            {
+               PRIMITIVE_LINE = 0,
+               PRIMITIVE_ANTI_ALIASED_LINE,
+               /*! A circle at (x1, y1), with radius x2 */
+               PRIMITIVE_CIRCLE,
+               PRIMITIVE_FILLED_TRIANGLE,
+               /*! A filled circle at (x1, y1), with radius x2 */
+               PRIMITIVE_FILLED_CIRCLE,
+               /*! A filled rectangle with corners of radius x3 */
+               PRIMITIVE_FILLED_ROUNDED_RECTANGLE,
+               /*! A filled rectangle with antialiased corners of 
+                * radius x3 */
+               PRIMITIVE_ANTI_ALIASED_FILLED_ROUNDED_RECTANGLE
+            };
+
+            /*! Constructor */
+            Primitive(PrimitiveType type, int x1, int y1, int x2, int y2,
+                  int x3 = 0, int y3 = 0)
+            {
+               this->type = type;
+               this->x1 = x1;
+               this->y1 = y1;
+               this->x2 = x2;
+               this->y2 = y2;
+               this->x3 = x3;
+               this->y3 = y3;
+            };
+
+            PrimitiveType type; /**< Primitive type */
+            int x1; /**< First x coordinate */
+            int y1; /**< First y coordinate */
+            int x2; /**< Second x coordinate (or radius) */
+            int y2; /**< Second y coordinate */
+            int x3; /**< Third x coordinate (or radius) */
+            int y3; /**< Third y coordinate */
+      };
+
+      /*! Writer of pixels through the virtual setPixel. Used when the
+       * implementation has no specialized writer for the surface. */
+      class SetPixelWriter
+      {
+         public:
+            /*! Constructor */
+            SetPixelWriter(Draw* draw, Surface* surface, const Color& color);
+            /*! Set a pixel with the color */
+            void setPixel(int x, int y);
+            /*! Set a pixel with the color multiplied by bright */
+            void setPixel(int x, int y, float bright);
+            /*! Blend the color, its alpha multiplied by coverage, over a
+             * pixel */
+            void coverPixel(int x, int y, Uint8 coverage);
+            /*! Set all pixels of an horizontal span */
+            void hSpan(int x1, int x2, int y);
+            /*! Set all pixels of a vertical span */
+            void vSpan(int x, int y1, int y2);
+
+         private:
+            Draw* draw; /**< Draw used */
+            Surface* surface; /**< Surface to draw to */
+            Color color; /**< Color to use (as written) */
+            bool premultiplied; /**< If using premultiplied alpha */
+            Rect clip; /**< Clip rectangle when created */
+      };
+
+      /*! Rasterize a primitive with the active color. Implementations 
+       * should override it to use a PackedPixelWriter for their surface
+       * format, mapping the color just once per primitive.
+       * \param surface surface to draw to
+       * \param primitive primitive to rasterize */
+      virtual void rasterize(Surface* surface, const Primitive& primitive);
+
+      /*! Rasterize a primitive with a pixel writer */
+      template<class Writer> static void rasterize(Writer& writer, 
+            const Primitive& primitive)
+      {
+         switch(primitive.type)
+         {
+            case Primitive::PRIMITIVE_LINE:
+               PrimitiveRaster<Writer>::line(writer, primitive.x1, 
+                     primitive.y1, primitive.x2, primitive.y2);
+            break;
+            case Primitive::PRIMITIVE_ANTI_ALIASED_LINE:
+               PrimitiveRaster<Writer>::antiAliasedLine(writer, primitive.x1,
+                     primitive.y1, primitive.x2, primitive.y2);
+            break;
+            case Primitive::PRIMITIVE_CIRCLE:
+               PrimitiveRaster<Writer>::circle(writer, primitive.x1, 
+                     primitive.y1, primitive.x2);
+            break;
+            case Primitive::PRIMITIVE_FILLED_TRIANGLE:
+               PrimitiveRaster<Writer>::filledTriangle(writer, primitive.x1,
+                     primitive.y1, primitive.x2, primitive.y2, 
+                     primitive.x3, primitive.y3);
+            break;
+            case Primitive::PRIMITIVE_FILLED_CIRCLE:
+               PrimitiveRaster<Writer>::filledCircle(writer, primitive.x1, 
+                     primitive.y1, primitive.x2);
+            break;
+            case Primitive::PRIMITIVE_FILLED_ROUNDED_RECTANGLE:
+            case Primitive::PRIMITIVE_ANTI_ALIASED_FILLED_ROUNDED_RECTANGLE:
+               PrimitiveRaster<Writer>::filledRoundedRectangle(writer,
+                     primitive.x1, primitive.y1, primitive.x2, primitive.y2,
+                     primitive.x3, primitive.type == 
+                     Primitive::PRIMITIVE_ANTI_ALIASED_FILLED_ROUNDED_RECTANGLE);
+            break;
+         }
+      };
+
+      /*! \return area of a surface where primitives could write to (its 
+       *          area intersected with the current clip rectangle).
+       *          Undefined if none. */
+      Rect getWritableArea(int surfaceWidth, int surfaceHeight) const;
+
       /*! Set the surface (x,y) pixel color.
        * \param surface -> bitmap to draw
        * \param x -> x coordinate of the pixel
@@ -213,13 +393,66 @@ class Draw
       /*! Set pixel, with bright component, for antialiased lines */
       void setPixel(Surface* surface, int x, int y, float bright);
 
-      /*! Blend two colors, and saving the blend on the second one */
+      /*! \return if the pixel (x, y) is inside current clip rectangle
+       *          (always true if no clip rectangle is defined). */
+      const bool isInsideClip(int x, int y) const
+      {
+         const Rect& clip = clipRect();
+         return (!clip.isDefined()) || (clip.isInner(x, y));
+      };
+
+      /*! \return the active color of the current thread */
+      Color& curColor() { return colors[RasterPool::getCurrentSlot()]; };
+      /*! \return the clip rectangle of the current thread */
+      Rect& clipRect() { return clipRects[RasterPool::getCurrentSlot()]; };
+      const Rect& clipRect() const 
+      { 
+         return clipRects[RasterPool::getCurrentSlot()]; 
+      };
+
+      /*! \return the color as written to surfaces (ie: premultiplied, 
+       *          if using premultiplied alpha). */
+      Color getWriteColor(const Color& color) const
+      {
+         if(!premultipliedAlpha)
+         {
+            return color;
+         }
+         return Color(div255(color.red * color.alpha),
+               div255(color.green * color.alpha),
+               div255(color.blue * color.alpha), color.alpha);
+      };
+
+      /*! Blend two colors, and saving the blend on the second one.
+       * \note with premultiplied alpha, both are expected as such. */
       void blendColor(Uint8 sr, Uint8 sg, Uint8 sb, Uint8 sa, 
                       Uint8& tr, Uint8& tg, Uint8& tb, Uint8& ta);
+
+      /*! Blend a premultiplied source over a premultiplied target 
+       * channel: t = s + t * (255 - sa) / 255 */
+      static Uint8 blendPremultiplied(Uint8 s, Uint8 t, Uint8 sa)
+      {
+         return s + div255(t * (255 - sa));
+      };
+
+      /*! \return x / 255, rounded down (exact for x <= 255 * 255) */
+      static Uint8 div255(int x)
+      {
+         return (Uint8) ((x + 1 + (x >> 8)) >> 8);
+      };
    
    protected:
       
-      Color curColor;  /**< Active color. */
+      /* Note: as different threads could draw at the same time (to 
+       * different surfaces), each RasterPool slot has its own state. */
+      Color colors[FARSO_RASTER_MAX_THREADS + 1]; /**< Active colors */
+      Rect clipRects[FARSO_RASTER_MAX_THREADS + 1]; /**< Current clip 
+                                                  rectangles (undefined for
+                                                  none) */
+      std::vector<Rect> clipStacks[FARSO_RASTER_MAX_THREADS + 1]; /**< 
+                               Clip rectangles saved by pushClipRect, 
+                               per thread slot */
+      bool premultipliedAlpha; /**< If surfaces are premultiplied */
 
 };
 
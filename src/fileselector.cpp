@@ -536,7 +536,7 @@ void FileSelector::doDraw(const Rect& pBody)
       while(labels.size() > 0)
       {
          /* Remove label from grid (it's its child) */
-         grid->remove(labels[labels.size() - 1]);
+         grid->removeChild(labels[labels.size() - 1]);
          /* Remove from the vector */
          labels.pop_back();
       }
@@ -145,6 +145,7 @@ FT_Library FontManager::freeTypeLib;
 std::map<Kobold::String, Font*> FontManager::fonts;
 Kobold::String FontManager::defaultFont;
 Kobold::Mutex FontManager::mutex;
+Kobold::Mutex Font::freeTypeMutex;
 
 /***********************************************************************
  *                             Constructor                             *
@@ -190,10 +191,12 @@ Font::CachedGlyph* Font::FaceInfo::getGlyph(Uint16 c, int outline,
        (cache[index].getOutline() == outline) )
    {
       /* Already in cache, let's just use it. */
+      FrameStats::count(FrameStats::COUNTER_GLYPH_CACHE_HITS);
       return &cache[index];
    }
 
    /* Cache miss: must load the character to the cache */
+   FrameStats::count(FrameStats::COUNTER_GLYPH_CACHE_MISSES);
 
    if(outline == 0)
    {
@@ -214,6 +217,7 @@ Font::CachedGlyph* Font::FaceInfo::getGlyph(Uint16 c, int outline,
       {
          return NULL;
       }
+      freeTypeMutex.lock();
       FT_Stroker stroker;
       FT_Stroker_New((*freeTypeLib), &stroker);
       FT_Stroker_Set(stroker, (int)(outline * 64), FT_STROKER_LINECAP_ROUND,
@@ -233,6 +237,7 @@ Font::CachedGlyph* Font::FaceInfo::getGlyph(Uint16 c, int outline,
          FT_Done_Glyph(glyph);
       }
       FT_Stroker_Done(stroker);
+      freeTypeMutex.unlock();
    }
 
    /* Return the just loaded glyph on the cache */
@@ -311,9 +316,16 @@ Font::Font(const Kobold::String& filename, FT_Library* lib)
    this->data = NULL;
    this->dataSize = 0;
    this->freeTypeLib = lib;
-   this->curTextSize = 0;
-   this->curFace = NULL;
-   this->curAlign = TEXT_LEFT;
+}
+
+/***********************************************************************
+ *                             ThreadState                             *
+ ***********************************************************************/
+Font::ThreadState::ThreadState()
+{
+   textSize = 0;
+   face = NULL;
+   align = TEXT_LEFT;
 }
 
 /***********************************************************************
@@ -322,12 +334,16 @@ Font::Font(const Kobold::String& filename, FT_Library* lib)
 Font::~Font()
 {
    /* Free all loaded faces */
-   for(std::map<int, FaceInfo*>::iterator it = faces.begin(); 
-       it != faces.end(); ++it)
+   for(int i = 0; i <= FARSO_RASTER_MAX_THREADS; i++)
    {
-      delete it->second;
+      std::map<int, FaceInfo*>& faces = states[i].faces;
+      for(std::map<int, FaceInfo*>::iterator it = faces.begin(); 
+          it != faces.end(); ++it)
+      {
+         delete it->second;
+      }
+      faces.clear();
    }
-   faces.clear();
 
    /* Free the font data loaded, if defined */
    if(data != NULL)
@@ -350,6 +366,8 @@ bool Font::load()
  ***********************************************************************/
 bool Font::load(Kobold::FileReader& fileReader)
 {
+   FARSO_TRACE_SCOPE_DETAIL("Font::load", filename);
+
    /* try to open file */
    if(!fileReader.open(Controller::getRealFilename(filename)))
    {
@@ -383,11 +401,14 @@ bool Font::load(Kobold::FileReader& fileReader)
  ***********************************************************************/
 Font::FaceInfo* Font::getFace(int size)
 {
+   std::map<int, FaceInfo*>& faces = getState().faces;
    std::map<int, FaceInfo*>::iterator it = faces.find(size);
 
    if(it == faces.end())
    {
-      /* No Face exists for the desired size yet, must create it */
+      /* No Face exists for the desired size yet, must create it. Note
+       * that the FreeType library usage must be serialized. */
+      freeTypeMutex.lock();
       FT_Face* face = new FT_Face();
       int error = FT_New_Memory_Face((*freeTypeLib), data, dataSize, 0, face);
       if(error)
@@ -398,6 +419,7 @@ Font::FaceInfo* Font::getFace(int size)
             filename.c_str(), error, dataSize);
          
          delete face;
+         freeTypeMutex.unlock();
          return NULL;
       }
       /* Set the size */
@@ -410,8 +432,11 @@ Font::FaceInfo* Font::getFace(int size)
          
          FT_Done_Face(*face);
          delete face;
+         freeTypeMutex.unlock();
          return NULL;
       }
+      freeTypeMutex.unlock();
+
       /* Add to map and done */
       Font::FaceInfo* faceInfo = new Font::FaceInfo(face, size);
       faces[size] = faceInfo;
@@ -427,22 +452,23 @@ Font::FaceInfo* Font::getFace(int size)
  ***********************************************************************/
 void Font::setSize(int pt)
 {
-   if((curTextSize != pt) && (pt > 0))
+   ThreadState& state = getState();
+   if((state.textSize != pt) && (pt > 0))
    {
       /* Set the new text size, and retrieve (or load) the respective face. */
-      curTextSize = pt;
-      curFace = getFace(pt);
-      if(curFace == NULL)
+      state.textSize = pt;
+      state.face = getFace(pt);
+      if(state.face == NULL)
       {
          /* Couldn't define the text size, so must revert to 0. */
-         curTextSize = 0;
+         state.textSize = 0;
       }
    }
    else if(pt <= 0)
    {
       /* No render. */
-      curTextSize = 0;
-      curFace = NULL;
+      state.textSize = 0;
+      state.face = NULL;
    }
 }
 
@@ -451,7 +477,7 @@ void Font::setSize(int pt)
  ***********************************************************************/
 const int Font::getSize() const
 {
-   return curTextSize;
+   return getState().textSize;
 }
 
 /***********************************************************************
@@ -459,7 +485,7 @@ const int Font::getSize() const
  ***********************************************************************/
 void Font::setAlignment(const Font::Alignment& align)
 {
-   curAlign = align;
+   getState().align = align;
 }
 
 /***********************************************************************
@@ -467,7 +493,7 @@ void Font::setAlignment(const Font::Alignment& align)
  ***********************************************************************/
 const Font::Alignment& Font::getAlignment() const
 {
-   return curAlign;
+   return getState().align;
 }
 
 /***********************************************************************
@@ -476,6 +502,8 @@ const Font::Alignment& Font::getAlignment() const
 int Font::getHeight(int areaWidth, const Kobold::String& text, 
       bool breakOnSpace)
 {
+   FaceInfo* curFace = getState().face;
+
    if(curFace == NULL)
    {
       return 0;
@@ -520,6 +548,8 @@ int Font::getHeight(int areaWidth, const Kobold::String& text,
  ***********************************************************************/
 const int Font::getDefaultHeight() const
 {
+   FaceInfo* curFace = getState().face;
+
    if(curFace == NULL)
    {
       return 0;
@@ -532,6 +562,8 @@ const int Font::getDefaultHeight() const
  ***********************************************************************/
 int Font::getWidth(const Kobold::String& text, int outline)
 {
+   FaceInfo* curFace = getState().face;
+
    int curSize = 0;
    const Uint8* utf8 = (Uint8*) text.c_str();
    size_t texlen = strlen((char*) utf8);
@@ -558,6 +590,8 @@ int Font::getWidth(const Kobold::String& text, int outline)
 int Font::getWhileFits(const Kobold::String& text, Kobold::String& fit,
       Kobold::String& wontFit, int width, bool& brokeOnSpace)
 {
+   FaceInfo* curFace = getState().face;
+
    int curSize = 0;
    const Uint8* utf8 = (Uint8*) text.c_str();
    size_t fulllen = strlen((char*) utf8);
@@ -627,6 +661,8 @@ int Font::write(Surface* surface, int x, int y, const Rect& area,
 int Font::write(Surface* surface, const Rect& area, const Kobold::String& text,
       int outline)
 {
+   FaceInfo* curFace = getState().face;
+
    if(curFace == NULL)
    {
       return 0;
@@ -663,6 +699,8 @@ int Font::write(Surface* surface, const Rect& area, const Kobold::String& text,
 int Font::writeBreakingOnSpaces(Surface* surface, const Rect& area, 
       const Kobold::String& text, const Color& outlineColor, int outline)
 {
+   FaceInfo* curFace = getState().face;
+
    Kobold::String wontFit = text;
    Kobold::String fit;
    Kobold::String curText = text;
@@ -726,6 +764,10 @@ bool Font::willGlyphFits(int x, int y, const Rect& area, CachedGlyph* glyph)
 int Font::write(Surface* surface, int x, int y, const Rect& area, 
       const Uint8* utf8, int outline)
 {
+   FARSO_TRACE_SCOPE("Font::write");
+   const ThreadState& state = getState();
+   FaceInfo* curFace = state.face;
+
    /* make sure surface is valid */
    assert(surface != NULL);
    /* make sure rectangle area is inside the surface */
@@ -739,7 +781,7 @@ int Font::write(Surface* surface, int x, int y, const Rect& area,
       return 0;
    }
 
-   if((curAlign == TEXT_RIGHT) || (curAlign == TEXT_CENTERED))
+   if((state.align == TEXT_RIGHT) || (state.align == TEXT_CENTERED))
    {
       return centeredOrRightWrite(surface, x, y, area, utf8, outline);
    }
@@ -797,6 +839,9 @@ int Font::write(Surface* surface, int x, int y, const Rect& area,
 void Font::flushLine(Surface* surface, int x, int y, Uint16* chars, 
       int lastIndex, int areaWidth, int textWidth, int outline)
 {
+   const ThreadState& state = getState();
+   FaceInfo* curFace = state.face;
+
    if(lastIndex < 0)
    {
       /* Nothing to flush */
@@ -804,11 +849,11 @@ void Font::flushLine(Surface* surface, int x, int y, Uint16* chars,
    }
 
    /* Define initial position */
-   if(curAlign == TEXT_RIGHT)
+   if(state.align == TEXT_RIGHT)
    {
       x += areaWidth - textWidth - FONT_HORIZONTAL_DELTA;
    }
-   else if(curAlign == TEXT_CENTERED)
+   else if(state.align == TEXT_CENTERED)
    {
       x += ((areaWidth - textWidth - FONT_HORIZONTAL_DELTA) / 2);
    }
@@ -833,6 +878,8 @@ void Font::flushLine(Surface* surface, int x, int y, Uint16* chars,
 int Font::centeredOrRightWrite(Surface* surface, int x, int y, 
       const Rect& area, const Uint8* utf8, int outline)
 {
+   FaceInfo* curFace = getState().face;
+
    int renderedChars = 0;
    size_t texlen = strlen((char*) utf8);
 
@@ -35,6 +35,7 @@
 #include "surface.h"
 #include "colors.h"
 #include "loader.h"
+#include "rasterpool.h"
 
 namespace Farso
 {
@@ -43,7 +44,10 @@ namespace Farso
 /*! Delta for min horizontal distance to keep from write area X axys border. */
 #define FONT_HORIZONTAL_DELTA   2
 
-/*! A single font representation. */
+/*! A single font representation. 
+ * \note its current size and alignment (and its glyphs caches) are kept
+ *       for each RasterPool slot, thus different threads of the pool
+ *       could write with the same font at the same time. */
 class Font
 {
    public:
@@ -204,6 +208,29 @@ class Font
             int size; /**< Text size of the font for this face. */
       };
 
+      /*! The font state for a single thread (RasterPool slot) */
+      class ThreadState
+      {
+         public:
+            /*! Constructor */
+            ThreadState();
+
+            std::map<int, FaceInfo*> faces; /**< Faces for each size */
+            int textSize;  /**< Current text size to use on write */
+            FaceInfo* face; /**< Current face (of textSize) to use. */
+            Alignment align; /**< Alignment to use */
+      };
+
+      /*! \return state for the current thread */
+      ThreadState& getState() 
+      { 
+         return states[RasterPool::getCurrentSlot()]; 
+      };
+      const ThreadState& getState() const 
+      { 
+         return states[RasterPool::getCurrentSlot()]; 
+      };
+
       /*! Get (if already exists) or create a new face for the font
        * for desired font size (in points). 
        * \param size desired font size (in points)
@@ -230,15 +257,16 @@ class Font
       /*! Check if the glyph will fits inside the area at current position */
       bool willGlyphFits(int x, int y, const Rect& area, CachedGlyph* glyph);
 
-      std::map<int, FaceInfo*> faces; /**< Map of font faces for each size */
       Kobold::String filename; /**< Filename of the font used */
       FT_Byte* data; /**< the font data loaded from file. */
       size_t dataSize; /**< the data font size */
       FT_Library* freeTypeLib; /**< The FreeType context to use */
 
-      int curTextSize;  /**< Current text size to use on write */
-      FaceInfo* curFace; /**< Current face (of curTextSize size) to use. */
-      Alignment curAlign; /**< Alignment to use */
+      ThreadState states[FARSO_RASTER_MAX_THREADS + 1]; /**< States for
+                                                             each slot */
+
+      static Kobold::Mutex freeTypeMutex; /**< Mutex for the shared 
+                                               FreeType library usage */
 };
 
 /*! Farso's font manager: manages the creation and load of fonts, and also
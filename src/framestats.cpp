@@ -0,0 +1,215 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "framestats.h"
+
+#include <chrono>
+
+using namespace Farso;
+
+/***********************************************************************
+ *                              FrameStats                             *
+ ***********************************************************************/
+FrameStats::FrameStats()
+{
+   clear();
+}
+
+/***********************************************************************
+ *                                clear                                *
+ ***********************************************************************/
+void FrameStats::clear()
+{
+   frame = 0;
+   frameTime = 0.0;
+   for(int i = 0; i < TOTAL_COUNTERS; i++)
+   {
+      counters[i] = 0;
+   }
+   for(int i = 0; i < TOTAL_PHASES; i++)
+   {
+      phaseTimes[i] = 0.0;
+   }
+}
+
+/***********************************************************************
+ *                            getCounterName                           *
+ ***********************************************************************/
+const char* FrameStats::getCounterName(Counter counter)
+{
+   switch(counter)
+   {
+      case COUNTER_WIDGETS_TREATED:
+         return "widgets_treated";
+      case COUNTER_WIDGETS_DRAWN:
+         return "widgets_drawn";
+      case COUNTER_PIXELS_CLEARED:
+         return "pixels_cleared";
+      case COUNTER_SURFACES_UPLOADED:
+         return "surfaces_uploaded";
+      case COUNTER_BYTES_UPLOADED:
+         return "bytes_uploaded";
+      case COUNTER_GLYPH_CACHE_HITS:
+         return "glyph_cache_hits";
+      case COUNTER_GLYPH_CACHE_MISSES:
+         return "glyph_cache_misses";
+      case COUNTER_SKIN_STAMPS:
+         return "skin_stamps";
+      case COUNTER_SKIN_CACHE_HITS:
+         return "skin_cache_hits";
+      case COUNTER_SKIN_CACHE_MISSES:
+         return "skin_cache_misses";
+      case COUNTER_DRAW_CALLS:
+         return "draw_calls";
+      default:
+      break;
+   }
+   return "unknown";
+}
+
+/***********************************************************************
+ *                             getPhaseName                            *
+ ***********************************************************************/
+const char* FrameStats::getPhaseName(Phase phase)
+{
+   switch(phase)
+   {
+      case PHASE_REMOVAL:
+         return "removal";
+      case PHASE_TREAT:
+         return "treat";
+      case PHASE_DRAW:
+         return "draw";
+      case PHASE_UPLOAD:
+         return "upload";
+      case PHASE_MANUAL_RENDER:
+         return "manual_render";
+      case PHASE_CURSOR:
+         return "cursor";
+      default:
+      break;
+   }
+   return "unknown";
+}
+
+/***********************************************************************
+ *                              setEnabled                             *
+ ***********************************************************************/
+void FrameStats::setEnabled(bool enable)
+{
+   enabled.store(enable, std::memory_order_relaxed);
+}
+
+/***********************************************************************
+ *                              startPhase                             *
+ ***********************************************************************/
+uint64_t FrameStats::startPhase()
+{
+   if(!isEnabled())
+   {
+      return 0;
+   }
+
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***********************************************************************
+ *                               endPhase                              *
+ ***********************************************************************/
+void FrameStats::endPhase(Phase phase, uint64_t start)
+{
+   if(start == 0)
+   {
+      /* Wasn't enabled when started */
+      return;
+   }
+
+   uint64_t end = startPhase();
+   if(end > start)
+   {
+      currentPhases[phase].value.fetch_add(end - start, 
+            std::memory_order_relaxed);
+      if((phase == PHASE_UPLOAD) && (drawDepth > 0))
+      {
+         currentDrawUploads.value.fetch_add(end - start, 
+               std::memory_order_relaxed);
+      }
+   }
+}
+
+/***********************************************************************
+ *                            startDrawPhase                           *
+ ***********************************************************************/
+uint64_t FrameStats::startDrawPhase()
+{
+   /* Note: must be kept even if disabled, to match endDrawPhase */
+   drawDepth++;
+   return startPhase();
+}
+
+/***********************************************************************
+ *                             endDrawPhase                            *
+ ***********************************************************************/
+void FrameStats::endDrawPhase(uint64_t start)
+{
+   drawDepth--;
+   endPhase(PHASE_DRAW, start);
+}
+
+/***********************************************************************
+ *                               collect                               *
+ ***********************************************************************/
+void FrameStats::collect(FrameStats& stats, uint64_t frame, 
+      uint64_t frameStart)
+{
+   uint64_t end = startPhase();
+
+   stats.frame = frame;
+   stats.frameTime = ((frameStart != 0) && (end > frameStart)) ? 
+      (end - frameStart) / 1000000.0 : 0.0;
+
+   for(int i = 0; i < TOTAL_COUNTERS; i++)
+   {
+      stats.counters[i] = current[i].value.exchange(0, 
+            std::memory_order_relaxed);
+   }
+   for(int i = 0; i < TOTAL_PHASES; i++)
+   {
+      stats.phaseTimes[i] = currentPhases[i].value.exchange(0, 
+            std::memory_order_relaxed) / 1000000.0;
+   }
+
+   /* Keep the draw phase without the uploads done while drawing (but
+    * not others, like the cursor's ones) */
+   stats.phaseTimes[PHASE_DRAW] -= currentDrawUploads.value.exchange(0,
+         std::memory_order_relaxed) / 1000000.0;
+   if(stats.phaseTimes[PHASE_DRAW] < 0.0)
+   {
+      stats.phaseTimes[PHASE_DRAW] = 0.0;
+   }
+}
+
+std::atomic<bool> FrameStats::enabled(false);
+FrameStats::SharedCounter FrameStats::current[FrameStats::TOTAL_COUNTERS];
+FrameStats::SharedCounter FrameStats::currentPhases[FrameStats::TOTAL_PHASES];
+FrameStats::SharedCounter FrameStats::currentDrawUploads;
+thread_local int FrameStats::drawDepth = 0;
+
@@ -0,0 +1,202 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_frame_stats_h
+#define _farso_frame_stats_h
+
+#include "farsoconfig.h"
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace Farso
+{
+
+/*! Default number of frames kept at Controller's statistics history */
+#define FARSO_DEFAULT_FRAME_STATS_HISTORY   120
+
+/*! Statistics of a single Controller::verifyEvents call (a frame).
+ *
+ * The counters are incremented from where the work is done (including 
+ * parallel rasterization threads) and collected by the Controller at the 
+ * end of each frame. When disabled (see setEnabled), counting costs a 
+ * single relaxed load, thus could be kept on release builds.
+ *
+ * \note times are in milliseconds. The draw phase time doesn't include
+ *       the uploads done while drawing (which are at the upload phase). */
+class FrameStats
+{
+   public:
+      /*! Counters per frame */
+      enum Counter
+      {
+         /*! Widgets treated for events */
+         COUNTER_WIDGETS_TREATED = 0,
+         /*! Widget draws (a widget redrawn on N damaged areas counts N) */
+         COUNTER_WIDGETS_DRAWN,
+         /*! Pixels cleared before redraw */
+         COUNTER_PIXELS_CLEARED,
+         /*! Surfaces uploaded to their textures */
+         COUNTER_SURFACES_UPLOADED,
+         /*! Bytes uploaded to textures */
+         COUNTER_BYTES_UPLOADED,
+         /*! Glyphs found on font's cache */
+         COUNTER_GLYPH_CACHE_HITS,
+         /*! Glyphs loaded (and rendered) by FreeType */
+         COUNTER_GLYPH_CACHE_MISSES,
+         /*! Skin elements stamped */
+         COUNTER_SKIN_STAMPS,
+         /*! Skin elements stamped from the composed elements cache */
+         COUNTER_SKIN_CACHE_HITS,
+         /*! Skin elements composed to the cache */
+         COUNTER_SKIN_CACHE_MISSES,
+         /*! Draw calls issued to composite widget renderers (only 
+          * counted by renderers that composite by themselves) */
+         COUNTER_DRAW_CALLS,
+         /*! Just to know the total number of counters */
+         TOTAL_COUNTERS
+      };
+
+      /*! Phases of a frame */
+      enum Phase
+      {
+         /*! Removal of widgets (and applying queued commands) */
+         PHASE_REMOVAL = 0,
+         /*! Widgets' event treatment */
+         PHASE_TREAT,
+         /*! Widgets' draw */
+         PHASE_DRAW,
+         /*! Surfaces upload to textures */
+         PHASE_UPLOAD,
+         /*! Manual render of the widgets (for renderers that need it) */
+         PHASE_MANUAL_RENDER,
+         /*! Mouse cursor and its tip */
+         PHASE_CURSOR,
+         /*! Just to know the total number of phases */
+         TOTAL_PHASES
+      };
+
+      /*! Constructor */
+      FrameStats();
+
+      /*! Zero all counters and times */
+      void clear();
+
+      /*! \return frame number (since Controller::init) */
+      const uint64_t getFrame() const { return frame; };
+
+      /*! \return value of a counter at this frame */
+      const uint64_t getCounter(Counter counter) const 
+      { 
+         return counters[counter]; 
+      };
+
+      /*! \return time, in milliseconds, spent at a phase on this frame */
+      const double getPhaseTime(Phase phase) const
+      {
+         return phaseTimes[phase];
+      };
+
+      /*! \return the whole frame time, in milliseconds */
+      const double getFrameTime() const { return frameTime; };
+
+      /*! \return name of a counter (for reports) */
+      static const char* getCounterName(Counter counter);
+      /*! \return name of a phase (for reports) */
+      static const char* getPhaseName(Phase phase);
+
+      /*! Enable or disable the statistics gathering.
+       * \note could be called at any time. The frame when it is changed
+       *       will have partial statistics. */
+      static void setEnabled(bool enable);
+
+      /*! \return if statistics are being gathered */
+      static bool isEnabled() 
+      { 
+         return enabled.load(std::memory_order_relaxed); 
+      };
+
+      /*! Add to a counter of current frame.
+       * \note thread safe. */
+      static void count(Counter counter, uint64_t amount = 1)
+      {
+         if(isEnabled())
+         {
+            current[counter].value.fetch_add(amount, 
+                  std::memory_order_relaxed);
+         }
+      };
+
+      /*! \return current time, in nanoseconds, to measure a phase, or 0
+       *          when disabled. */
+      static uint64_t startPhase();
+
+      /*! Add the time elapsed since startPhase to a phase of current frame.
+       * \param phase phase to add time to
+       * \param start value returned by startPhase.
+       * \note thread safe. */
+      static void endPhase(Phase phase, uint64_t start);
+
+      /*! As startPhase, but for the draw phase: uploads done by the 
+       * calling thread until endDrawPhase are excluded from its time.
+       * \return as startPhase */
+      static uint64_t startDrawPhase();
+
+      /*! As endPhase(PHASE_DRAW, start), for a startDrawPhase call.
+       * \param start value returned by startDrawPhase. */
+      static void endDrawPhase(uint64_t start);
+
+      /*! Collect (and reset) the current frame counters and times.
+       * \param stats where to put the collected statistics
+       * \param frame number of the frame 
+       * \param frameStart startPhase return at frame start */
+      static void collect(FrameStats& stats, uint64_t frame, uint64_t frameStart);
+
+   private:
+      /*! A counter on its own cache line, as they could be incremented
+       * by multiple raster threads at once. */
+      struct alignas(64) SharedCounter
+      {
+         std::atomic<uint64_t> value; /**< Current value */
+      };
+
+      uint64_t frame; /**< Frame number */
+      uint64_t counters[TOTAL_COUNTERS]; /**< Counters values */
+      double phaseTimes[TOTAL_PHASES]; /**< Phase times, in ms */
+      double frameTime; /**< Whole frame time, in ms */
+
+      static std::atomic<bool> enabled; /**< If gathering statistics */
+      static SharedCounter current[TOTAL_COUNTERS]; /**< Current frame 
+                                                       counters */
+      static SharedCounter currentPhases[TOTAL_PHASES]; /**< Current frame
+                                                          phase times, in
+                                                          nanoseconds */
+      static SharedCounter currentDrawUploads; /**< Current frame upload
+                                                 time done while drawing,
+                                                 in nanoseconds */
+      static thread_local int drawDepth; /**< Draw phases the current
+                                           thread is in */
+};
+
+}
+
+#endif
+
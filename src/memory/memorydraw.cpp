@@ -0,0 +1,274 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memorydraw.h"
+#include "memorysurface.h"
+#include "../blendspan.h"
+
+#include <kobold/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Farso;
+
+/************************************************************************
+ *                              MemoryDraw                              *
+ ************************************************************************/
+MemoryDraw::MemoryDraw()
+{
+}
+
+/************************************************************************
+ *                             ~MemoryDraw                              *
+ ************************************************************************/
+MemoryDraw::~MemoryDraw()
+{
+}
+
+/************************************************************************
+ *                           getDrawableArea                            *
+ ************************************************************************/
+Rect MemoryDraw::getDrawableArea(MemorySurface* surface, 
+      int x1, int y1, int x2, int y2)
+{
+   Rect area = Rect(x1, y1, x2, y2).getIntersection(Rect(0, 0, 
+            surface->getRealWidth() - 1, surface->getRealHeight() - 1));
+
+   const Rect& clip = clipRect();
+   if((area.isDefined()) && (clip.isDefined()))
+   {
+      area = area.getIntersection(clip);
+   }
+
+   return area;
+}
+
+/************************************************************************
+ *                                setPixel                              *
+ ************************************************************************/
+void MemoryDraw::setPixel(Surface* surface, int x, int y, 
+      Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha)
+{
+   MemorySurface* memSurf = static_cast<MemorySurface*>(surface);
+
+   /* Verify Limits */
+   if((x > memSurf->getRealWidth() - 1) || 
+      (y > memSurf->getRealHeight() - 1) || (x < 0) || (y < 0) ||
+      (!isInsideClip(x, y)))
+   {
+      return;
+   }
+
+   Uint8* p = memSurf->getPixel(x, y);
+   p[0] = red;
+   p[1] = green;
+   p[2] = blue;
+   p[3] = alpha;
+}
+
+/************************************************************************
+ *                               rasterize                              *
+ ************************************************************************/
+void MemoryDraw::rasterize(Surface* surface, const Primitive& primitive)
+{
+   MemorySurface* memSurf = static_cast<MemorySurface*>(surface);
+
+   /* Our pixels are R, G, B and A bytes, thus its packing as an Uint32
+    * depends on the machine endianness. */
+   Uint32 one = 1;
+   bool bigEndian = (*((Uint8*) &one) == 0);
+   PixelPacking packing;
+   packing.redShift = (bigEndian) ? 24 : 0;
+   packing.greenShift = (bigEndian) ? 16 : 8;
+   packing.blueShift = (bigEndian) ? 8 : 16;
+   packing.alphaShift = (bigEndian) ? 0 : 24;
+   packing.redMask = 0xFFu << packing.redShift;
+   packing.greenMask = 0xFFu << packing.greenShift;
+   packing.blueMask = 0xFFu << packing.blueShift;
+   packing.alphaMask = 0xFFu << packing.alphaShift;
+   packing.redLoss = 0;
+   packing.greenLoss = 0;
+   packing.blueLoss = 0;
+   packing.alphaLoss = 0;
+
+   PackedPixelWriter<4> writer(memSurf->getPixels(), memSurf->getPitch(),
+         getWritableArea(memSurf->getRealWidth(), memSurf->getRealHeight()),
+         packing, getWriteColor(curColor()), isPremultipliedAlpha());
+   Draw::rasterize(writer, primitive);
+}
+
+/************************************************************************
+ *                                getPixel                              *
+ ************************************************************************/
+void MemoryDraw::getPixel(Surface* surface, int x, int y, 
+      Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha)
+{
+   MemorySurface* memSurf = static_cast<MemorySurface*>(surface);
+
+   /* Verify Limits */
+   if((x > memSurf->getRealWidth() - 1) || 
+      (y > memSurf->getRealHeight() - 1) || (x < 0) || (y < 0))
+   {
+      return;
+   }
+
+   Uint8* p = memSurf->getPixel(x, y);
+   red = p[0];
+   green = p[1];
+   blue = p[2];
+   alpha = p[3];
+}
+
+/************************************************************************
+ *                          doFilledRectangle                           *
+ ************************************************************************/
+void MemoryDraw::doFilledRectangle(Surface* surface, int x1, int y1, 
+      int x2, int y2)
+{
+   MemorySurface* memSurf = static_cast<MemorySurface*>(surface);
+   Rect area = getDrawableArea(memSurf, x1, y1, x2, y2);
+   if(!area.isDefined())
+   {
+      return;
+   }
+
+   /* Fill the first line pixel by pixel... */
+   Color cur = getWriteColor(curColor());
+   Uint8* first = memSurf->getPixel(area.getX1(), area.getY1());
+   Uint8* p = first;
+   for(int x = area.getX1(); x <= area.getX2(); x++)
+   {
+      p[0] = cur.red;
+      p[1] = cur.green;
+      p[2] = cur.blue;
+      p[3] = cur.alpha;
+      p += 4;
+   }
+
+   /* ...and just copy it to the others */
+   size_t lineBytes = area.getWidth() * 4;
+   for(int y = area.getY1() + 1; y <= area.getY2(); y++)
+   {
+      memcpy(memSurf->getPixel(area.getX1(), y), first, lineBytes);
+   }
+}
+
+/************************************************************************
+ *                              doStampFill                             *
+ ************************************************************************/
+void MemoryDraw::doStampFill(Surface* target, int tx1, int ty1,
+      int tx2, int ty2, Surface* source, int sx1, int sy1,
+      int sx2, int sy2, StampFillType stampType)
+{
+   MemorySurface* targetMem = static_cast<MemorySurface*>(target);
+   MemorySurface* sourceMem = static_cast<MemorySurface*>(source);
+
+   if(sourceMem->getPixels() == NULL)
+   {
+      /* Failed to load source image */
+      return;
+   }
+
+   Rect area = getDrawableArea(targetMem, tx1, ty1, tx2, ty2);
+   if(!area.isDefined())
+   {
+      return;
+   }
+
+   int sourceWidth = (sx2 - sx1) + 1;
+   int sourceHeight = (sy2 - sy1) + 1;
+
+   for(int y = area.getY1(); y <= area.getY2(); y++)
+   {
+      /* Source line, repeating the source rectangle if needed */
+      int sy = sy1 + ((y - ty1) % sourceHeight);
+      if((sy < 0) || (sy >= sourceMem->getRealHeight()))
+      {
+         continue;
+      }
+
+      Uint8* pTgt = targetMem->getPixel(area.getX1(), y);
+      for(int x = area.getX1(); x <= area.getX2(); x++, pTgt += 4)
+      {
+         int sx = sx1 + ((x - tx1) % sourceWidth);
+         if((sx < 0) || (sx >= sourceMem->getRealWidth()))
+         {
+            continue;
+         }
+         Uint8* pSrc = sourceMem->getPixel(sx, sy);
+
+         if(stampType == STAMP_TYPE_COPY)
+         {
+            pTgt[0] = pSrc[0];
+            pTgt[1] = pSrc[1];
+            pTgt[2] = pSrc[2];
+            pTgt[3] = pSrc[3];
+         }
+         else if(pSrc[3] != 0)
+         {
+            blendColor(pSrc[0], pSrc[1], pSrc[2], pSrc[3],
+                  pTgt[0], pTgt[1], pTgt[2], pTgt[3]);
+         }
+      }
+   }
+}
+
+/************************************************************************
+ *                          doFreeTypeStamp                             *
+ ************************************************************************/
+void MemoryDraw::doFreeTypeStamp(Surface* target, int x, int y, 
+      FT_Bitmap* bitmap, int left, int top)
+{
+   if(bitmap->pixel_mode != FT_PIXEL_MODE_GRAY)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+            "WARN: unsupported glyph bitmap format: %d", bitmap->pixel_mode);
+      return;
+   }
+
+   MemorySurface* targetMem = static_cast<MemorySurface*>(target);
+
+   /* Glyph area on target */
+   int gx1 = x + left;
+   int gy1 = y - top;
+   Rect area = getDrawableArea(targetMem, gx1, gy1, 
+         gx1 + bitmap->width - 1, gy1 + bitmap->rows - 1);
+   if(!area.isDefined())
+   {
+      return;
+   }
+
+   const BlendSpan::Layout layout = { 0, 1, 2, 3 };
+   BlendSpan span(curColor(), layout, isPremultipliedAlpha());
+
+   for(int ty = area.getY1(); ty <= area.getY2(); ty++)
+   {
+      /* Note: a negative pitch means the bitmap lines are stored from 
+       * bottom to top. */
+      int line = (bitmap->pitch >= 0) ? (ty - gy1) : 
+                 (bitmap->rows - 1 - (ty - gy1));
+      Uint8* pSrc = bitmap->buffer + line * abs(bitmap->pitch) + 
+                    (area.getX1() - gx1);
+      span.blend(targetMem->getPixel(area.getX1(), ty), pSrc, 
+            area.getWidth());
+   }
+}
+
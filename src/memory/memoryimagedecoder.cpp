@@ -0,0 +1,104 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memoryimagedecoder.h"
+
+#include <kobold/platform.h>
+#include <kobold/log.h>
+
+#include <SDL2/SDL.h>
+
+#if FARSO_HAS_OPENGL == 1
+
+#if KOBOLD_PLATFORM == KOBOLD_PLATFORM_MACOS
+   #include <SDL2_Image/SDL_image.h>
+#else 
+   #include <SDL2/SDL_image.h>
+#endif
+
+#endif
+
+#include <string.h>
+
+using namespace Farso;
+
+/******************************************************************
+ *                            Destructor                          *
+ ******************************************************************/
+SDLImageDecoder::~SDLImageDecoder()
+{
+}
+
+/******************************************************************
+ *                              decode                            *
+ ******************************************************************/
+Uint8* SDLImageDecoder::decode(const Kobold::String& filename, 
+      int& width, int& height)
+{
+#if FARSO_HAS_OPENGL == 1
+   SDL_Surface* loaded = IMG_Load(filename.c_str());
+#else
+   SDL_Surface* loaded = SDL_LoadBMP(filename.c_str());
+#endif
+   if(!loaded)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Can't open image: '%s'", filename.c_str());
+      return NULL;
+   }
+
+   /* Convert it to our byte order: red, green, blue, alpha */
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+   Uint32 pixelFormat = SDL_PIXELFORMAT_RGBA8888;
+#else
+   Uint32 pixelFormat = SDL_PIXELFORMAT_ABGR8888;
+#endif
+   SDL_Surface* converted = SDL_ConvertSurfaceFormat(loaded, pixelFormat, 0);
+   SDL_FreeSurface(loaded);
+   if(!converted)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Can't convert image: '%s'", filename.c_str());
+      return NULL;
+   }
+
+   width = converted->w;
+   height = converted->h;
+
+   /* Copy it, line by line (to remove any pitch padding) */
+   Uint8* pixels = new Uint8[width * height * 4];
+   if(SDL_MUSTLOCK(converted))
+   {
+      SDL_LockSurface(converted);
+   }
+   for(int y = 0; y < height; y++)
+   {
+      memcpy(pixels + y * width * 4, 
+             (Uint8*) converted->pixels + y * converted->pitch, width * 4);
+   }
+   if(SDL_MUSTLOCK(converted))
+   {
+      SDL_UnlockSurface(converted);
+   }
+   SDL_FreeSurface(converted);
+
+   return pixels;
+}
+
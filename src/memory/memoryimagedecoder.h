@@ -0,0 +1,66 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_memory_image_decoder_h
+#define _farso_memory_image_decoder_h
+
+#include <kobold/kstring.h>
+#include "../colors.h"
+
+namespace Farso
+{
+
+/*! Decoder of image files to plain memory pixels, used by MemoryRenderer
+ * to load images. Implement it to use any image library (or to feed 
+ * fixed images for regression tests). */
+class MemoryImageDecoder
+{
+   public:
+      /*! Destructor */
+      virtual ~MemoryImageDecoder() {};
+
+      /*! Decode an image file.
+       * \param filename name of the image file to decode.
+       * \param width will receive the image width
+       * \param height will receive the image height
+       * \return new[] allocated buffer with width * height pixels, each 
+       *         one as 4 bytes in red, green, blue and alpha order, with
+       *         no padding between lines, or NULL if couldn't decode. The
+       *         caller is responsible to delete[] it. */
+      virtual Uint8* decode(const Kobold::String& filename, 
+            int& width, int& height) = 0;
+};
+
+/*! Default MemoryImageDecoder, using SDL_image (when available) or 
+ * SDL's BMP loader. */
+class SDLImageDecoder : public MemoryImageDecoder
+{
+   public:
+      /*! Destructor */
+      ~SDLImageDecoder();
+
+      Uint8* decode(const Kobold::String& filename, 
+            int& width, int& height) override;
+};
+
+}
+
+#endif
+
@@ -0,0 +1,174 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memoryrenderer.h"
+#include "memorydraw.h"
+#include "memorysurface.h"
+#include "memorywidgetrenderer.h"
+#include "../controller.h"
+
+#include <string.h>
+
+namespace Farso
+{
+
+/**************************************************************************
+ *                              Constructor                               *
+ **************************************************************************/
+MemoryRenderer::MemoryRenderer(bool composite, MemoryImageDecoder* decoder)
+{
+   this->draw = new MemoryDraw();
+   this->decoder = (decoder != NULL) ? decoder : new SDLImageDecoder();
+   this->compositing = composite;
+   this->framebuffer = NULL;
+   this->fbWidth = 0;
+   this->fbHeight = 0;
+}
+
+/**************************************************************************
+ *                               Destructor                               *
+ **************************************************************************/
+MemoryRenderer::~MemoryRenderer()
+{
+   delete decoder;
+   if(framebuffer != NULL)
+   {
+      delete[] framebuffer;
+   }
+}
+
+/**************************************************************************
+ *                          createWidgetRenderer                          *
+ **************************************************************************/
+WidgetRenderer* MemoryRenderer::createWidgetRenderer(int width, int height)
+{
+   return new MemoryWidgetRenderer(width, height);
+}
+
+/**************************************************************************
+ *                              enter2dMode                               *
+ **************************************************************************/
+void MemoryRenderer::enter2dMode()
+{
+   if(!compositing)
+   {
+      return;
+   }
+
+   /* Make sure the framebuffer has current dimensions */
+   int width = Controller::getWidth();
+   int height = Controller::getHeight();
+   if((framebuffer == NULL) || (width != fbWidth) || (height != fbHeight))
+   {
+      if(framebuffer != NULL)
+      {
+         delete[] framebuffer;
+      }
+      fbWidth = width;
+      fbHeight = height;
+      framebuffer = new Uint8[fbWidth * fbHeight * 4];
+   }
+
+   /* All widgets are rendered on each frame, so start a new one */
+   memset(framebuffer, 0, fbWidth * fbHeight * 4);
+}
+
+/**************************************************************************
+ *                               composite                                *
+ **************************************************************************/
+void MemoryRenderer::composite(const Uint8* pixels, int pitch, 
+      int width, int height, int x, int y)
+{
+   if(framebuffer == NULL)
+   {
+      return;
+   }
+
+   /* Limit to the framebuffer */
+   int x1 = (x < 0) ? 0 : x;
+   int y1 = (y < 0) ? 0 : y;
+   int x2 = (x + width > fbWidth) ? fbWidth : x + width;
+   int y2 = (y + height > fbHeight) ? fbHeight : y + height;
+
+   bool premultiplied = Controller::isPremultipliedAlpha();
+
+   for(int fy = y1; fy < y2; fy++)
+   {
+      const Uint8* pSrc = pixels + (fy - y) * pitch + (x1 - x) * 4;
+      Uint8* pTgt = framebuffer + (fy * fbWidth + x1) * 4;
+      for(int fx = x1; fx < x2; fx++, pSrc += 4, pTgt += 4)
+      {
+         int sa = pSrc[3];
+         if(sa == 255)
+         {
+            memcpy(pTgt, pSrc, 4);
+         }
+         else if((sa != 0) && (premultiplied))
+         {
+            /* Premultiplied source over target */
+            for(int c = 0; c < 4; c++)
+            {
+               pTgt[c] = pSrc[c] + pTgt[c] * (255 - sa) / 255;
+            }
+         }
+         else if(sa != 0)
+         {
+            /* Source over target */
+            for(int c = 0; c < 3; c++)
+            {
+               pTgt[c] = (pSrc[c] * sa + pTgt[c] * (255 - sa)) / 255;
+            }
+            pTgt[3] = sa + pTgt[3] * (255 - sa) / 255;
+         }
+      }
+   }
+}
+
+/**************************************************************************
+ *                          loadImageToSurface                            *
+ **************************************************************************/
+Surface* MemoryRenderer::loadImageToSurface(const Kobold::String& filename) 
+{
+   return new MemorySurface(filename, decoder);
+}
+
+/**************************************************************************
+ *                             createSurface                              *
+ **************************************************************************/
+Surface* MemoryRenderer::createSurface(const Kobold::String& name, 
+      int width, int height)
+{
+   return new MemorySurface(name, width, height);
+}
+
+/**************************************************************************
+ *                            setImageDecoder                             *
+ **************************************************************************/
+void MemoryRenderer::setImageDecoder(MemoryImageDecoder* decoder)
+{
+   if((decoder != NULL) && (decoder != this->decoder))
+   {
+      delete this->decoder;
+      this->decoder = decoder;
+   }
+}
+
+}
+
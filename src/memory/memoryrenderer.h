@@ -0,0 +1,98 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_memory_renderer_h
+#define _farso_memory_renderer_h
+
+#include "../renderer.h"
+#include "memoryimagedecoder.h"
+
+namespace Farso
+{
+
+/*! Headless Renderer implementation: all surfaces are plain CPU memory
+ * buffers, without any need of a window or GPU context. Useful for 
+ * benchmarks and pixel-exact regression tests. Optionally, all visible 
+ * widgets could be composited, on each Controller::verifyEvents call, 
+ * into an in-memory framebuffer with Controller's dimensions. */
+class MemoryRenderer : public Renderer
+{
+   public:
+      /*! Constructor 
+       * \param composite if should composite the widgets into the 
+       *        framebuffer (false to just draw and upload them).
+       * \param decoder decoder to load images with. Its ownership is 
+       *        taken by the renderer. If NULL, a SDLImageDecoder is used.*/
+      MemoryRenderer(bool composite=false, MemoryImageDecoder* decoder=NULL);
+      /*! Destructor */
+      virtual ~MemoryRenderer();
+
+      /*! \return new MemoryWidgetRenderer */
+      WidgetRenderer* createWidgetRenderer(int width, int height) override;
+
+      /*! Clear the framebuffer, if compositing */
+      void enter2dMode() override;
+      void restore3dMode() override {};
+      const bool shouldManualRender() const override { return true; };
+      Surface* loadImageToSurface(const Kobold::String& filename) override;
+      Surface* createSurface(const Kobold::String& name, 
+            int width, int height) override;
+
+      /*! Define the decoder to load images with.
+       * \param decoder decoder to use. Its ownership is taken by the 
+       *        renderer, and the previous one is deleted. */
+      void setImageDecoder(MemoryImageDecoder* decoder);
+
+      /*! \return if compositing the widgets into the framebuffer */
+      const bool isCompositing() const { return compositing; };
+
+      /*! \return the framebuffer pixels (4 bytes per pixel, in red, green,
+       *          blue and alpha order, without line padding). NULL if not
+       *          compositing or before the first Controller::verifyEvents
+       *          call. */
+      const Uint8* getFramebuffer() const { return framebuffer; };
+      /*! \return the framebuffer width */
+      const int getFramebufferWidth() const { return fbWidth; };
+      /*! \return the framebuffer height */
+      const int getFramebufferHeight() const { return fbHeight; };
+
+      /*! Blend pixels over the framebuffer.
+       * \param pixels pixels to blend, with the same format of the 
+       *        framebuffer.
+       * \param pitch bytes per line of pixels
+       * \param width width of the area to blend
+       * \param height height of the area to blend
+       * \param x framebuffer X coordinate where to blend to
+       * \param y framebuffer Y coordinate where to blend to */
+      void composite(const Uint8* pixels, int pitch, int width, int height,
+            int x, int y);
+
+   private:
+      MemoryImageDecoder* decoder; /**< Decoder used to load images */
+      bool compositing; /**< If compositing to the framebuffer */
+      Uint8* framebuffer; /**< The framebuffer, when compositing */
+      int fbWidth; /**< Framebuffer width */
+      int fbHeight; /**< Framebuffer height */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,112 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memorysurface.h"
+#include "memoryimagedecoder.h"
+#include "../controller.h"
+#include "../blendspan.h"
+
+#include <string.h>
+
+using namespace Farso;
+
+/******************************************************************
+ *                           Constructor                          *
+ ******************************************************************/
+MemorySurface::MemorySurface(const Kobold::String& name, int width, 
+      int height)
+              :Surface(name, width, height)
+{
+   Draw* draw = Controller::getDraw();
+
+   /* Define power of two dimensions */
+   realWidth = draw->smallestPowerOfTwo(width);
+   realHeight = draw->smallestPowerOfTwo(height);
+   pitch = realWidth * 4;
+
+   /* Create it already cleared */
+   pixels = new Uint8[pitch * realHeight];
+   memset(pixels, 0, pitch * realHeight);
+}
+
+/******************************************************************
+ *                           Constructor                          *
+ ******************************************************************/
+MemorySurface::MemorySurface(const Kobold::String& filename, 
+      MemoryImageDecoder* decoder)
+              :Surface(filename)
+{
+   int w = 0, h = 0;
+   pixels = (decoder != NULL) ? decoder->decode(filename, w, h) : NULL;
+
+   setDimensions(w, h);
+   realWidth = w;
+   realHeight = h;
+   pitch = w * 4;
+
+   /* Convert to premultiplied alpha, if surfaces are so */
+   if((pixels != NULL) && (Controller::isPremultipliedAlpha()))
+   {
+      const BlendSpan::Layout layout = { 0, 1, 2, 3 };
+      BlendSpan::premultiply(pixels, w * h, layout);
+   }
+}
+
+/******************************************************************
+ *                            Destructor                          *
+ ******************************************************************/
+MemorySurface::~MemorySurface()
+{
+   if(pixels != NULL)
+   {
+      delete[] pixels;
+   }
+}
+
+/******************************************************************
+ *                                lock                            *
+ ******************************************************************/
+void MemorySurface::lock()
+{
+}
+
+/******************************************************************
+ *                               unlock                           *
+ ******************************************************************/
+void MemorySurface::unlock()
+{
+}
+
+/******************************************************************
+ *                            getRealWidth                        *
+ ******************************************************************/
+int MemorySurface::getRealWidth()
+{
+   return realWidth;
+}
+
+/******************************************************************
+ *                           getRealHeight                        *
+ ******************************************************************/
+int MemorySurface::getRealHeight()
+{
+   return realHeight;
+}
+
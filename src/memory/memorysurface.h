@@ -0,0 +1,77 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_memory_surface_h
+#define _farso_memory_surface_h
+
+#include "../surface.h"
+#include "../colors.h"
+
+namespace Farso
+{
+
+class MemoryImageDecoder;
+
+/*! Surface implementation for MemoryRenderer: a plain buffer of 32 bits
+ * per pixel, in red, green, blue and alpha byte order. */
+class MemorySurface : public Surface
+{
+   public:
+      /*! Constructor, for a new empty drawable surface.
+       * \param name -> name of the drawable surface (must be unique). 
+       * \param width -> width of the surface.
+       * \param height -> height of the surface. */
+      MemorySurface(const Kobold::String& name, int width, int height);
+      /*! Constructor to load an image from file and use it as a surface.
+       * \param filename -> filename of the image file to load 
+       * \param decoder -> decoder to use to load the image */
+      MemorySurface(const Kobold::String& filename, 
+            MemoryImageDecoder* decoder);
+      /*! Destructor */
+      ~MemorySurface();
+
+      /*! Nothing to lock on plain memory buffers */
+      void lock();
+      /*! Nothing to unlock on plain memory buffers */
+      void unlock();
+
+      int getRealWidth();
+      int getRealHeight();
+
+      /*! \return the pixels buffer. NULL if image load failed. */
+      Uint8* getPixels() { return pixels; };
+
+      /*! \return bytes per line of the pixels buffer */
+      const int getPitch() const { return pitch; };
+
+      /*! \return pointer to the pixel (x, y). No bounds check is done. */
+      Uint8* getPixel(int x, int y) { return pixels + y * pitch + x * 4; };
+
+   private:
+      Uint8* pixels; /**< The pixels buffer */
+      int realWidth; /**< Width as power of two */
+      int realHeight; /**< Height as power of two */
+      int pitch; /**< Bytes per line */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,144 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memorywidgetrenderer.h"
+#include "memoryrenderer.h"
+#include "memorysurface.h"
+#include "../controller.h"
+
+#include <string.h>
+
+using namespace Farso;
+
+/***********************************************************************
+ *                         MemoryWidgetRenderer                        *
+ ***********************************************************************/
+MemoryWidgetRenderer::MemoryWidgetRenderer(int width, int height)
+       : WidgetRenderer(width, height)
+{
+   this->texture = NULL;
+   this->texWidth = 0;
+   this->texHeight = 0;
+   this->posX = 0;
+   this->posY = 0;
+}
+
+/***********************************************************************
+ *                        ~MemoryWidgetRenderer                        *
+ ***********************************************************************/
+MemoryWidgetRenderer::~MemoryWidgetRenderer()
+{
+   if(texture != NULL)
+   {
+      delete[] texture;
+   }
+}
+
+/***********************************************************************
+ *                             createSurface                           *
+ ***********************************************************************/
+void MemoryWidgetRenderer::createSurface()
+{
+   this->surface = new MemorySurface(name, width, height);
+
+   /* Texture must follow surface's size */
+   if((texture == NULL) || (texWidth != surface->getRealWidth()) ||
+      (texHeight != surface->getRealHeight()))
+   {
+      if(texture != NULL)
+      {
+         delete[] texture;
+      }
+      texWidth = surface->getRealWidth();
+      texHeight = surface->getRealHeight();
+      texture = new Uint8[texWidth * texHeight * 4];
+      memset(texture, 0, texWidth * texHeight * 4);
+   }
+}
+
+/***********************************************************************
+ *                           doUploadSurface                           *
+ ***********************************************************************/
+size_t MemoryWidgetRenderer::doUploadSurface(const std::list<Rect>& areas)
+{
+   MemorySurface* memSurf = static_cast<MemorySurface*>(surface);
+   Rect limits(0, 0, texWidth - 1, texHeight - 1);
+   size_t bytes = 0;
+
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      Rect area = (*it).getIntersection(limits);
+      if(!area.isDefined())
+      {
+         continue;
+      }
+
+      size_t lineBytes = area.getWidth() * 4;
+      for(int y = area.getY1(); y <= area.getY2(); y++)
+      {
+         memcpy(texture + (y * texWidth + area.getX1()) * 4,
+                memSurf->getPixel(area.getX1(), y), lineBytes);
+      }
+
+      bytes += lineBytes * area.getHeight();
+   }
+
+   return bytes;
+}
+
+/***********************************************************************
+ *                            doSetPosition                            *
+ ***********************************************************************/
+void MemoryWidgetRenderer::doSetPosition(float x, float y)
+{
+   this->posX = x;
+   this->posY = y;
+}
+
+/***********************************************************************
+ *                                doHide                               *
+ ***********************************************************************/
+void MemoryWidgetRenderer::doHide()
+{
+}
+
+/***********************************************************************
+ *                                doShow                               *
+ ***********************************************************************/
+void MemoryWidgetRenderer::doShow()
+{
+}
+
+/***********************************************************************
+ *                               doRender                              *
+ ***********************************************************************/
+void MemoryWidgetRenderer::doRender()
+{
+   MemoryRenderer* renderer = static_cast<MemoryRenderer*>(
+         Controller::getRenderer());
+   if((texture != NULL) && (renderer->isCompositing()))
+   {
+      int w = (width < texWidth) ? width : texWidth;
+      int h = (height < texHeight) ? height : texHeight;
+      renderer->composite(texture, texWidth * 4, w, h, posX, posY);
+   }
+}
+
@@ -0,0 +1,58 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_memory_widget_renderer_h
+#define _farso_memory_widget_renderer_h
+
+#include "../widgetrenderer.h"
+#include "../colors.h"
+
+namespace Farso
+{
+   /*! WidgetRenderer for MemoryRenderer. Uploads copy the surface areas
+    * to a texture-like buffer, which is composited on render (if the 
+    * MemoryRenderer is compositing). */
+   class MemoryWidgetRenderer : public WidgetRenderer
+   {
+      public:
+         MemoryWidgetRenderer(int width, int height); 
+         ~MemoryWidgetRenderer();
+
+         void setRenderQueueSubGroup(int renderQueueId){};
+
+      protected:
+         void createSurface();
+         void doSetPosition(float x, float y);
+         void doHide();
+         void doShow();
+         void doRender();
+         size_t doUploadSurface(const std::list<Rect>& areas);
+
+      private:
+         Uint8* texture;  /**< Uploaded pixels */
+         int texWidth;    /**< Texture width */
+         int texHeight;   /**< Texture height */
+         int posX;        /**< current X position on screen */
+         int posY;        /**< current Y position on screen */
+   };
+}
+
+#endif
+
@@ -121,6 +121,10 @@ OgreRenderer::OgreRenderer(Ogre::SceneManager* sceneManager,
    ogreWidgetMovableFactory = new OgreWidgetMovableFactory();
    Ogre::Root::getSingleton().addMovableObjectFactory(
          ogreWidgetMovableFactory);
+
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+   stagingRing = new OgreStagingRing(renderSystem->getTextureGpuManager());
+#endif
 }
 
 /**************************************************************************
@@ -128,6 +132,14 @@ OgreRenderer::OgreRenderer(Ogre::SceneManager* sceneManager,
  **************************************************************************/
 OgreRenderer::~OgreRenderer()
 {
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+   if(stagingRing)
+   {
+      delete stagingRing;
+      stagingRing = NULL;
+   }
+#endif
+
    /* Unregister our widget's movable factory */
    if(ogreWidgetMovableFactory)
    {
@@ -146,6 +158,17 @@ WidgetRenderer* OgreRenderer::createWidgetRenderer(int width, int height)
    return new OgreWidgetRenderer(width, height);
 }
 
+/**************************************************************************
+ *                             restore3dMode                              *
+ **************************************************************************/
+void OgreRenderer::restore3dMode()
+{
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+   /* Upload all surfaces changed on this frame at once */
+   stagingRing->flush();
+#endif
+}
+
 /**************************************************************************
  *                          loadImageToSurface                            *
  **************************************************************************/
@@ -155,6 +178,15 @@ Surface* OgreRenderer::loadImageToSurface(const Kobold::String& filename)
          Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME); 
 }
 
+/**************************************************************************
+ *                             createSurface                              *
+ **************************************************************************/
+Surface* OgreRenderer::createSurface(const Kobold::String& name, 
+      int width, int height)
+{
+   return new OgreSurface(name, width, height);
+}
+
 #if OGRE_VERSION_MAJOR == 1 
 /*************************************************************************
  *                       getVertexProgramName                            *
@@ -28,6 +28,7 @@
 
 #include <OGRE/OgreSceneManager.h>
 #include "ogrewidgetmovable.h"
+#include "ogrestagingring.h"
 
 #if OGRE_VERSION_MAJOR == 1
    #include <OGRE/OgreHighLevelGpuProgramManager.h>
@@ -55,15 +56,23 @@ class OgreRenderer : public Renderer
       WidgetRenderer* createWidgetRenderer(int width, int height) override;
 
       void enter2dMode() override {};
-      void restore3dMode() override {};
+      void restore3dMode() override;
       const bool shouldManualRender() const override { return false; };
       Surface* loadImageToSurface(const Kobold::String& filename) override;
+      Surface* createSurface(const Kobold::String& name, 
+            int width, int height) override;
 
       /*! \return pointer to the used Ogre::SceneManager */
       Ogre::SceneManager* getSceneManager() { return sceneManager; };
       /*! \return pointer to the used Ogre::RenderSystem */
       Ogre::RenderSystem* getRenderSystem() { return renderSystem; };
 
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+      /*! \return ring used to upload widget renderers' surfaces, flushed
+       *          at restore3dMode. */
+      OgreStagingRing* getStagingRing() { return stagingRing; };
+#endif
+
 #if OGRE_VERSION_MAJOR == 1 
       /*! \return name of the loaded vertex program */
       Ogre::String getVertexProgramName();
@@ -81,6 +90,10 @@ class OgreRenderer : public Renderer
 #endif
 
       OgreWidgetMovableFactory* ogreWidgetMovableFactory;
+
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+      OgreStagingRing* stagingRing; /**< Ring for surface uploads */
+#endif
 };
 
 }
@@ -0,0 +1,262 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ogrestagingring.h"
+
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+
+#include "ogresurface.h"
+#include <kobold/log.h>
+#include <algorithm>
+
+using namespace Farso;
+
+/************************************************************************
+ *                           OgreStagingRing                            *
+ ************************************************************************/
+OgreStagingRing::OgreStagingRing(Ogre::TextureGpuManager* textureManager,
+      int totalSlots)
+{
+   this->textureManager = textureManager;
+
+   Slot slot;
+   slot.staging = NULL;
+   slot.width = 0;
+   slot.height = 0;
+   slot.format = Ogre::PFG_UNKNOWN;
+   slots.assign((totalSlots > 0) ? totalSlots : 1, slot);
+   next = 0;
+}
+
+/************************************************************************
+ *                          ~OgreStagingRing                            *
+ ************************************************************************/
+OgreStagingRing::~OgreStagingRing()
+{
+   for(size_t i = 0; i < slots.size(); i++)
+   {
+      if(slots[i].staging != NULL)
+      {
+         textureManager->removeStagingTexture(slots[i].staging);
+      }
+   }
+}
+
+/************************************************************************
+ *                                queue                                 *
+ ************************************************************************/
+void OgreStagingRing::queue(Ogre::TextureGpu* texture, OgreSurface* surface,
+      const std::list<Rect>& areas)
+{
+   Pending p;
+   p.texture = texture;
+   p.surface = surface;
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      p.area = *it;
+      pending.push_back(p);
+   }
+}
+
+/************************************************************************
+ *                                cancel                                *
+ ************************************************************************/
+void OgreStagingRing::cancel(Ogre::TextureGpu* texture)
+{
+   size_t cur = 0;
+   for(size_t i = 0; i < pending.size(); i++)
+   {
+      if(pending[i].texture != texture)
+      {
+         pending[cur] = pending[i];
+         cur++;
+      }
+   }
+   pending.resize(cur);
+}
+
+/************************************************************************
+ *                               acquire                                *
+ ************************************************************************/
+OgreStagingRing::Slot& OgreStagingRing::acquire(Ogre::uint32 width, 
+      Ogre::uint32 height, Ogre::PixelFormatGpu format)
+{
+   /* Find one already consumed by the GPU. If none, the oldest one is 
+    * used, with Ogre waiting for it at map (only when uploading more 
+    * batches than our ring size in frames). */
+   size_t index = next;
+   for(size_t i = 0; i < slots.size(); i++)
+   {
+      size_t cur = (next + i) % slots.size();
+      if((slots[cur].staging == NULL) || 
+         (!slots[cur].staging->uploadWillStall()))
+      {
+         index = cur;
+         break;
+      }
+   }
+   next = (index + 1) % slots.size();
+
+   Slot& slot = slots[index];
+   if((slot.staging != NULL) && 
+      ((slot.width < width) || (slot.height < height) || 
+       (slot.format != format)))
+   {
+      /* Too small (or incompatible): must get a new one */
+      textureManager->removeStagingTexture(slot.staging);
+      slot.staging = NULL;
+   }
+
+   if(slot.staging == NULL)
+   {
+      /* Keep it as big as the biggest batch it ever had */
+      if(slot.format != format)
+      {
+         slot.width = 0;
+         slot.height = 0;
+      }
+      slot.width = std::max(slot.width, width);
+      slot.height = std::max(slot.height, height);
+      slot.format = format;
+      slot.staging = textureManager->getStagingTexture(slot.width, 
+            slot.height, 1u, 1u, format);
+   }
+
+   return slot;
+}
+
+/************************************************************************
+ *                             uploadBatch                              *
+ ************************************************************************/
+size_t OgreStagingRing::uploadBatch(size_t first)
+{
+   const size_t bpp = 4;
+   Ogre::PixelFormatGpu format = pending[first].texture->getPixelFormat();
+
+   /* Define the batch: areas are stacked vertically on the staging 
+    * texture, while of the same format and under our max height. */
+   Ogre::uint32 width = 0;
+   Ogre::uint32 height = 0;
+   size_t last = first;
+   while(last < pending.size())
+   {
+      const Pending& p = pending[last];
+      Ogre::uint32 h = static_cast<Ogre::uint32>(p.area.getHeight());
+      if((last != first) && 
+         ((p.texture->getPixelFormat() != format) ||
+          (height + h > FARSO_MAX_STAGING_HEIGHT)))
+      {
+         break;
+      }
+      width = std::max(width, 
+            static_cast<Ogre::uint32>(p.area.getWidth()));
+      height += h;
+      last++;
+   }
+
+   /* Copy all areas to a single staging map */
+   Slot& slot = acquire(width, height, format);
+   std::vector<Ogre::TextureBox> boxes;
+   boxes.reserve(last - first);
+
+   slot.staging->startMapRegion();
+   for(size_t i = first; i < last; i++)
+   {
+      const Pending& p = pending[i];
+      Ogre::uint32 w = static_cast<Ogre::uint32>(p.area.getWidth());
+      Ogre::uint32 h = static_cast<Ogre::uint32>(p.area.getHeight());
+
+      Ogre::TextureBox box = slot.staging->mapRegion(w, h, 1u, 1u, format);
+      if(box.data == NULL)
+      {
+         /* No more space: the remaining go to the next batch */
+         last = i;
+         break;
+      }
+
+      SDL_Surface* sdlSurf = p.surface->getSurface();
+      p.surface->lock();
+      Ogre::uint8* pixels = static_cast<Ogre::uint8*>(sdlSurf->pixels) +
+            p.area.getY1() * sdlSurf->pitch + p.area.getX1() * bpp;
+      box.copyFrom(pixels, w, h, sdlSurf->pitch);
+      p.surface->unlock();
+
+      boxes.push_back(box);
+   }
+   slot.staging->stopMapRegion();
+
+   /* Now we should upload each to its area position on its texture. */
+   for(size_t i = 0; i < boxes.size(); i++)
+   {
+      const Pending& p = pending[first + i];
+      Ogre::TextureBox dstBox = p.texture->getEmptyBox(0);
+      dstBox.x = p.area.getX1();
+      dstBox.y = p.area.getY1();
+      dstBox.width = boxes[i].width;
+      dstBox.height = boxes[i].height;
+      slot.staging->upload(boxes[i], p.texture, 0, NULL, &dstBox, false);
+
+      if(std::find(uploaded.begin(), uploaded.end(), p.texture) == 
+         uploaded.end())
+      {
+         uploaded.push_back(p.texture);
+      }
+   }
+
+   if(boxes.empty())
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR,
+            "Error: couldn't map a staging texture for a %dx%d area!",
+            pending[first].area.getWidth(), 
+            pending[first].area.getHeight());
+      return first + 1;
+   }
+
+   return last;
+}
+
+/************************************************************************
+ *                                flush                                 *
+ ************************************************************************/
+void OgreStagingRing::flush()
+{
+   if(pending.empty())
+   {
+      return;
+   }
+
+   uploaded.clear();
+   size_t cur = 0;
+   while(cur < pending.size())
+   {
+      cur = uploadBatch(cur);
+   }
+   pending.clear();
+
+   /* Notify data is ready to display */
+   for(size_t i = 0; i < uploaded.size(); i++)
+   {
+      uploaded[i]->notifyDataIsReady();
+   }
+}
+
+#endif
+
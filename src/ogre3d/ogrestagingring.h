@@ -0,0 +1,120 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_ogre_staging_ring_h
+#define _farso_ogre_staging_ring_h
+
+#include <OGRE/Ogre.h>
+
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
+
+#include <OGRE/OgreTextureGpu.h>
+#include <OGRE/OgreTextureGpuManager.h>
+#include <OGRE/OgreStagingTexture.h>
+
+#include "../rect.h"
+#include <list>
+#include <vector>
+
+/*! Default number of staging textures of the ring (Ogre's usual number of
+ * frames in flight) */
+#define FARSO_DEFAULT_STAGING_RING_SIZE     3
+/*! Max height of a single staging texture. Bigger batches are split. */
+#define FARSO_MAX_STAGING_HEIGHT         4096
+
+namespace Farso
+{
+
+class OgreSurface;
+
+/*! A ring of staging textures, kept between frames, used to upload widget
+ * renderer surfaces on Ogre 2.2+.
+ *
+ * Uploads are queued during the frame and done all at once at flush, 
+ * through a single map of a staging texture (which grows to the biggest 
+ * batch seen). A staging texture is only reused when Ogre tells its
+ * last upload was already consumed by the GPU. */
+class OgreStagingRing
+{
+   public:
+      /*! Constructor
+       * \param textureManager manager to get staging textures from
+       * \param totalSlots number of staging textures on the ring */
+      OgreStagingRing(Ogre::TextureGpuManager* textureManager,
+            int totalSlots = FARSO_DEFAULT_STAGING_RING_SIZE);
+      /*! Destructor */
+      ~OgreStagingRing();
+
+      /*! Queue the upload of surface areas to a texture, done at the next
+       * flush (with the surface contents at that time).
+       * \param texture texture to upload to
+       * \param surface surface to upload from. Must outlive the flush or
+       *        the cancel call.
+       * \param areas areas (of both the surface and the texture) */
+      void queue(Ogre::TextureGpu* texture, OgreSurface* surface, 
+            const std::list<Rect>& areas);
+
+      /*! Remove all queued uploads to a texture (ie: before deleting it) */
+      void cancel(Ogre::TextureGpu* texture);
+
+      /*! Upload all queued areas */
+      void flush();
+
+   private:
+      /*! A queued upload */
+      struct Pending
+      {
+         Ogre::TextureGpu* texture; /**< Texture to upload to */
+         OgreSurface* surface; /**< Surface to upload from */
+         Rect area; /**< Area to upload */
+      };
+
+      /*! A staging texture of the ring */
+      struct Slot
+      {
+         Ogre::StagingTexture* staging; /**< Staging texture, if any */
+         Ogre::uint32 width; /**< Width requested for it */
+         Ogre::uint32 height; /**< Height requested for it */
+         Ogre::PixelFormatGpu format; /**< Its pixel format */
+      };
+
+      /*! Get a staging texture, not in use by the GPU, at least as big as
+       * width x height. \return the slot with it. */
+      Slot& acquire(Ogre::uint32 width, Ogre::uint32 height,
+            Ogre::PixelFormatGpu format);
+
+      /*! Upload pending areas from first to the last one that fits on a
+       * single staging texture.
+       * \return index of the first pending area not uploaded */
+      size_t uploadBatch(size_t first);
+
+      Ogre::TextureGpuManager* textureManager; /**< Manager used */
+      std::vector<Slot> slots; /**< The ring */
+      size_t next; /**< Next slot to try */
+      std::vector<Pending> pending; /**< Uploads queued for next flush */
+      std::vector<Ogre::TextureGpu*> uploaded; /**< Textures at a flush */
+};
+
+}
+
+#endif
+
+#endif
+
@@ -77,6 +77,8 @@ bool OgreSurface::load(Kobold::String filename, Kobold::String group)
    ogreDraw->doOgreImageCopy(this, &ogreImage);
    this->unlock();
 
+   premultiplyAlpha();
+
    return true;
 }
 
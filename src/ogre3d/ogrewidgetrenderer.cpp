@@ -218,6 +218,7 @@ void OgreWidgetRenderer::deleteSurface()
          static_cast<OgreRenderer*>(Controller::getRenderer());
       Ogre::TextureGpuManager* textureMgr = 
          renderer->getRenderSystem()->getTextureGpuManager();
+      renderer->getStagingRing()->cancel(texture);
       textureMgr->destroyTexture(texture);
 #endif
    }
@@ -278,7 +279,15 @@ void OgreWidgetRenderer::defineTexture()
    texState->setTexture(texture);
    texState->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
    
-   tech->getPass(0)->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+   if(Controller::isPremultipliedAlpha())
+   {
+      tech->getPass(0)->setSceneBlending(Ogre::SBF_ONE, 
+            Ogre::SBF_ONE_MINUS_SOURCE_ALPHA);
+   }
+   else
+   {
+      tech->getPass(0)->setSceneBlending(Ogre::SBT_TRANSPARENT_ALPHA);
+   }
    tech->getPass(0)->setDepthWriteEnabled(false);
    tech->getPass(0)->setDepthCheckEnabled(false);
    tech->getPass(0)->setLightingEnabled(false);
@@ -364,27 +373,23 @@ void OgreWidgetRenderer::doRender()
 }
 
 /***********************************************************************
- *                             uploadSurface                           *
+ *                            doUploadSurface                          *
  ***********************************************************************/
-void OgreWidgetRenderer::uploadSurface()
+size_t OgreWidgetRenderer::doUploadSurface(const std::list<Rect>& areas)
 {
    /* The idea here is similar to the opengl implementation: we just update
     * the texture with the contents of the rendering surface (represented
-    * by it PixelBox bellow). */
+    * by it PixelBox bellow), but only at the changed areas. */
    OgreSurface* ogreSurface = static_cast<OgreSurface*>(surface);
+   const size_t bpp = 4;
+   size_t bytes = 0;
 
-   ogreSurface->lock();
 #if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR >= 2
 
    /* As Ogre 2.2+ uses a parallell upload to GPU proccess, the work
     * is a bit more complicated. */
    OgreRenderer* renderer = 
          static_cast<OgreRenderer*>(Controller::getRenderer());
-   Ogre::TextureGpuManager* textureManager = 
-      renderer->getRenderSystem()->getTextureGpuManager();
-
-   /* Define our sizes */
-   const size_t bytesPerRow = texture->_getSysRamCopyBytesPerRow(0);
 
    /* Tell texture we are going resident, if not already */
    if(texture->getResidencyStatus() != Ogre::GpuResidency::Resident)
@@ -393,38 +398,33 @@ void OgreWidgetRenderer::uploadSurface()
       texture->_setNextResidencyStatus(Ogre::GpuResidency::Resident);
    }
 
-   Ogre::StagingTexture* stagingTexture = textureManager->getStagingTexture(
-         texture->getWidth(), texture->getHeight(), texture->getDepth(),
-         texture->getNumSlices(), texture->getPixelFormat());
-
-   /* Let's map it, for the whole texture */
-   stagingTexture->startMapRegion();
-   Ogre::TextureBox texBox = stagingTexture->mapRegion(texture->getWidth(), 
-         texture->getHeight(), texture->getDepth(), texture->getNumSlices(),
-         texture->getPixelFormat());
-
-   /* Copy the contents */
-   texBox.copyFrom(ogreSurface->getSurface()->pixels, 
-         texture->getWidth(), texture->getHeight(), bytesPerRow);
-
-   /* Done with map */
-   stagingTexture->stopMapRegion();
-
-   /* Now we should upload it. */
-   stagingTexture->upload(texBox, texture, 0, NULL, NULL, false);
-
-   /* No more needed the staging texture */
-   textureManager->removeStagingTexture( stagingTexture );
-   stagingTexture = 0;
-
-   /* Notify data is ready to display */
-   texture->notifyDataIsReady();
+   /* The areas are copied to a staging texture shared with all other 
+    * widget renderers changed on this frame, and uploaded at once at
+    * the end of it (see OgreStagingRing). */
+   renderer->getStagingRing()->queue(texture, ogreSurface, areas);
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      bytes += (*it).getWidth() * (*it).getHeight() * bpp;
+   }
 
 #else
    /* Previously to 2.2, Ogre should just lock the rendering pipeline */
-   texture->getBuffer()->blitFromMemory(pixelBox);
-#endif
+   ogreSurface->lock();
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      const Rect& area = *it;
+      Ogre::Box box(area.getX1(), area.getY1(), 
+                    area.getX2() + 1, area.getY2() + 1);
+      texture->getBuffer()->blitFromMemory(pixelBox.getSubVolume(box), box);
+
+      bytes += area.getWidth() * area.getHeight() * bpp;
+   }
    ogreSurface->unlock();
+#endif
+
+   return bytes;
 }
 
 }
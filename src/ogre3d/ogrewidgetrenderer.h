@@ -68,9 +68,6 @@ class OgreWidgetRenderer : public WidgetRenderer
       /*! Destructor */
       ~OgreWidgetRenderer();
 
-      /*! Not needed for Ogre3D */
-      void uploadSurface();
-      
       /*! Set render queue subgroup to render */
       void setRenderQueueSubGroup(int renderQueueId);
 
@@ -94,6 +91,9 @@ class OgreWidgetRenderer : public WidgetRenderer
        * by the engine itself) */
       void doRender();
 
+      /*! Upload the changed areas of the surface to the texture */
+      size_t doUploadSurface(const std::list<Rect>& areas);
+
       /*! Update the texture renderer of this widget. */
       void defineTexture();
 
@@ -0,0 +1,208 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opengl3functions.h"
+#include <kobold/log.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace Farso;
+
+/*! Load a function, failing the whole load if not found */
+#define FARSO_GL3_LOAD(var, type, name) \
+   var = (type) SDL_GL_GetProcAddress(name); \
+   if(var == NULL) \
+   { \
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, \
+            "Error: OpenGL function '%s' not found!", name); \
+      ok = false; \
+   }
+
+/************************************************************************
+ *                                 load                                 *
+ ************************************************************************/
+bool OpenGL3Functions::load()
+{
+   if(loaded)
+   {
+      return true;
+   }
+
+   GLint major = 0, minor = 0;
+   glGetIntegerv(GL_MAJOR_VERSION, &major);
+   glGetIntegerv(GL_MINOR_VERSION, &minor);
+   if((major < 3) || ((major == 3) && (minor < 3)))
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: OpenGL 3.3 needed, but context is %d.%d", major, minor);
+      return false;
+   }
+
+   bool ok = true;
+   FARSO_GL3_LOAD(genVertexArrays, PFNGLGENVERTEXARRAYSPROC, 
+         "glGenVertexArrays");
+   FARSO_GL3_LOAD(deleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC, 
+         "glDeleteVertexArrays");
+   FARSO_GL3_LOAD(bindVertexArray, PFNGLBINDVERTEXARRAYPROC, 
+         "glBindVertexArray");
+   FARSO_GL3_LOAD(genBuffers, PFNGLGENBUFFERSPROC, "glGenBuffers");
+   FARSO_GL3_LOAD(deleteBuffers, PFNGLDELETEBUFFERSPROC, "glDeleteBuffers");
+   FARSO_GL3_LOAD(bindBuffer, PFNGLBINDBUFFERPROC, "glBindBuffer");
+   FARSO_GL3_LOAD(bufferData, PFNGLBUFFERDATAPROC, "glBufferData");
+   FARSO_GL3_LOAD(bufferSubData, PFNGLBUFFERSUBDATAPROC, "glBufferSubData");
+   FARSO_GL3_LOAD(mapBufferRange, PFNGLMAPBUFFERRANGEPROC, 
+         "glMapBufferRange");
+   FARSO_GL3_LOAD(unmapBuffer, PFNGLUNMAPBUFFERPROC, "glUnmapBuffer");
+   FARSO_GL3_LOAD(fenceSync, PFNGLFENCESYNCPROC, "glFenceSync");
+   FARSO_GL3_LOAD(clientWaitSync, PFNGLCLIENTWAITSYNCPROC, 
+         "glClientWaitSync");
+   FARSO_GL3_LOAD(deleteSync, PFNGLDELETESYNCPROC, "glDeleteSync");
+   FARSO_GL3_LOAD(vertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC,
+         "glVertexAttribPointer");
+   FARSO_GL3_LOAD(enableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC,
+         "glEnableVertexAttribArray");
+   FARSO_GL3_LOAD(createShader, PFNGLCREATESHADERPROC, "glCreateShader");
+   FARSO_GL3_LOAD(shaderSource, PFNGLSHADERSOURCEPROC, "glShaderSource");
+   FARSO_GL3_LOAD(compileShader, PFNGLCOMPILESHADERPROC, "glCompileShader");
+   FARSO_GL3_LOAD(getShaderiv, PFNGLGETSHADERIVPROC, "glGetShaderiv");
+   FARSO_GL3_LOAD(getShaderInfoLog, PFNGLGETSHADERINFOLOGPROC, 
+         "glGetShaderInfoLog");
+   FARSO_GL3_LOAD(deleteShader, PFNGLDELETESHADERPROC, "glDeleteShader");
+   FARSO_GL3_LOAD(createProgram, PFNGLCREATEPROGRAMPROC, "glCreateProgram");
+   FARSO_GL3_LOAD(attachShader, PFNGLATTACHSHADERPROC, "glAttachShader");
+   FARSO_GL3_LOAD(bindAttribLocation, PFNGLBINDATTRIBLOCATIONPROC,
+         "glBindAttribLocation");
+   FARSO_GL3_LOAD(linkProgram, PFNGLLINKPROGRAMPROC, "glLinkProgram");
+   FARSO_GL3_LOAD(getProgramiv, PFNGLGETPROGRAMIVPROC, "glGetProgramiv");
+   FARSO_GL3_LOAD(getProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC, 
+         "glGetProgramInfoLog");
+   FARSO_GL3_LOAD(deleteProgram, PFNGLDELETEPROGRAMPROC, "glDeleteProgram");
+   FARSO_GL3_LOAD(useProgram, PFNGLUSEPROGRAMPROC, "glUseProgram");
+   FARSO_GL3_LOAD(getUniformLocation, PFNGLGETUNIFORMLOCATIONPROC,
+         "glGetUniformLocation");
+   FARSO_GL3_LOAD(uniform1i, PFNGLUNIFORM1IPROC, "glUniform1i");
+   FARSO_GL3_LOAD(uniform2f, PFNGLUNIFORM2FPROC, "glUniform2f");
+   FARSO_GL3_LOAD(activeTexture, PFNGLACTIVETEXTUREPROC, "glActiveTexture");
+   FARSO_GL3_LOAD(blendFuncSeparate, PFNGLBLENDFUNCSEPARATEPROC,
+         "glBlendFuncSeparate");
+   FARSO_GL3_LOAD(blendEquationSeparate, PFNGLBLENDEQUATIONSEPARATEPROC,
+         "glBlendEquationSeparate");
+   FARSO_GL3_LOAD(bindSampler, PFNGLBINDSAMPLERPROC, "glBindSampler");
+   FARSO_GL3_LOAD(getStringi, PFNGLGETSTRINGIPROC, "glGetStringi");
+
+   if(!ok)
+   {
+      return false;
+   }
+
+   /* Immutable storage is optional (not core until 4.2). Note that we
+    * must check for it, as some platforms return a function pointer even
+    * for unsupported functions. */
+   texStorage2D = NULL;
+   if((major > 4) || ((major == 4) && (minor >= 2)) ||
+      (hasExtension("GL_ARB_texture_storage")))
+   {
+      texStorage2D = (PFNGLTEXSTORAGE2DPROC) 
+         SDL_GL_GetProcAddress("glTexStorage2D");
+   }
+
+   loaded = true;
+   return true;
+}
+
+/************************************************************************
+ *                             isSupported                              *
+ ************************************************************************/
+bool OpenGL3Functions::isSupported()
+{
+   /* Note: GL_MAJOR_VERSION is an invalid enum before OpenGL 3.0, so we
+    * must parse the version string instead (also failing for ES ones). */
+   const char* version = (const char*) glGetString(GL_VERSION);
+   int major = 0, minor = 0;
+   if((version == NULL) || (sscanf(version, "%d.%d", &major, &minor) != 2))
+   {
+      return false;
+   }
+   return (major > 3) || ((major == 3) && (minor >= 3));
+}
+
+/************************************************************************
+ *                             hasExtension                             *
+ ************************************************************************/
+bool OpenGL3Functions::hasExtension(const char* name)
+{
+   GLint total = 0;
+   glGetIntegerv(GL_NUM_EXTENSIONS, &total);
+   for(GLint i = 0; i < total; i++)
+   {
+      const char* ext = (const char*) getStringi(GL_EXTENSIONS, i);
+      if((ext != NULL) && (strcmp(ext, name) == 0))
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+/************************************************************************
+ *                                Static                                *
+ ************************************************************************/
+bool OpenGL3Functions::loaded = false;
+PFNGLGENVERTEXARRAYSPROC OpenGL3Functions::genVertexArrays = NULL;
+PFNGLDELETEVERTEXARRAYSPROC OpenGL3Functions::deleteVertexArrays = NULL;
+PFNGLBINDVERTEXARRAYPROC OpenGL3Functions::bindVertexArray = NULL;
+PFNGLGENBUFFERSPROC OpenGL3Functions::genBuffers = NULL;
+PFNGLDELETEBUFFERSPROC OpenGL3Functions::deleteBuffers = NULL;
+PFNGLBINDBUFFERPROC OpenGL3Functions::bindBuffer = NULL;
+PFNGLBUFFERDATAPROC OpenGL3Functions::bufferData = NULL;
+PFNGLBUFFERSUBDATAPROC OpenGL3Functions::bufferSubData = NULL;
+PFNGLMAPBUFFERRANGEPROC OpenGL3Functions::mapBufferRange = NULL;
+PFNGLUNMAPBUFFERPROC OpenGL3Functions::unmapBuffer = NULL;
+PFNGLFENCESYNCPROC OpenGL3Functions::fenceSync = NULL;
+PFNGLCLIENTWAITSYNCPROC OpenGL3Functions::clientWaitSync = NULL;
+PFNGLDELETESYNCPROC OpenGL3Functions::deleteSync = NULL;
+PFNGLVERTEXATTRIBPOINTERPROC OpenGL3Functions::vertexAttribPointer = NULL;
+PFNGLENABLEVERTEXATTRIBARRAYPROC 
+   OpenGL3Functions::enableVertexAttribArray = NULL;
+PFNGLCREATESHADERPROC OpenGL3Functions::createShader = NULL;
+PFNGLSHADERSOURCEPROC OpenGL3Functions::shaderSource = NULL;
+PFNGLCOMPILESHADERPROC OpenGL3Functions::compileShader = NULL;
+PFNGLGETSHADERIVPROC OpenGL3Functions::getShaderiv = NULL;
+PFNGLGETSHADERINFOLOGPROC OpenGL3Functions::getShaderInfoLog = NULL;
+PFNGLDELETESHADERPROC OpenGL3Functions::deleteShader = NULL;
+PFNGLCREATEPROGRAMPROC OpenGL3Functions::createProgram = NULL;
+PFNGLATTACHSHADERPROC OpenGL3Functions::attachShader = NULL;
+PFNGLBINDATTRIBLOCATIONPROC OpenGL3Functions::bindAttribLocation = NULL;
+PFNGLLINKPROGRAMPROC OpenGL3Functions::linkProgram = NULL;
+PFNGLGETPROGRAMIVPROC OpenGL3Functions::getProgramiv = NULL;
+PFNGLGETPROGRAMINFOLOGPROC OpenGL3Functions::getProgramInfoLog = NULL;
+PFNGLDELETEPROGRAMPROC OpenGL3Functions::deleteProgram = NULL;
+PFNGLUSEPROGRAMPROC OpenGL3Functions::useProgram = NULL;
+PFNGLGETUNIFORMLOCATIONPROC OpenGL3Functions::getUniformLocation = NULL;
+PFNGLUNIFORM1IPROC OpenGL3Functions::uniform1i = NULL;
+PFNGLUNIFORM2FPROC OpenGL3Functions::uniform2f = NULL;
+PFNGLACTIVETEXTUREPROC OpenGL3Functions::activeTexture = NULL;
+PFNGLBLENDFUNCSEPARATEPROC OpenGL3Functions::blendFuncSeparate = NULL;
+PFNGLBLENDEQUATIONSEPARATEPROC 
+   OpenGL3Functions::blendEquationSeparate = NULL;
+PFNGLBINDSAMPLERPROC OpenGL3Functions::bindSampler = NULL;
+PFNGLGETSTRINGIPROC OpenGL3Functions::getStringi = NULL;
+PFNGLTEXSTORAGE2DPROC OpenGL3Functions::texStorage2D = NULL;
+
@@ -0,0 +1,103 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_opengl3_functions_h
+#define _farso_opengl3_functions_h
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+
+namespace Farso
+{
+
+/*! The OpenGL 3.3 core profile functions used by OpenGL3Renderer. They 
+ * are loaded at runtime (through SDL), as most platforms' OpenGL 
+ * libraries only export the OpenGL 1.x ones.
+ * \note must be loaded with the OpenGL context current. */
+class OpenGL3Functions
+{
+   public:
+      /*! Load the functions from the current context (if not yet loaded)
+       * \return false if any required function is missing (or the context
+       *         isn't at least OpenGL 3.3). */
+      static bool load();
+
+      /*! \return if the current context is at least OpenGL 3.3, checked 
+       *          without generating errors on older contexts (where 
+       *          load would always fail). */
+      static bool isSupported();
+
+      /*! \return if already loaded */
+      static const bool isLoaded() { return loaded; };
+
+      /*! \return if immutable texture storage (glTexStorage2D, from
+       *          OpenGL 4.2 or ARB_texture_storage) is available */
+      static const bool hasTextureStorage() { return texStorage2D != NULL; };
+
+      static PFNGLGENVERTEXARRAYSPROC genVertexArrays;
+      static PFNGLDELETEVERTEXARRAYSPROC deleteVertexArrays;
+      static PFNGLBINDVERTEXARRAYPROC bindVertexArray;
+      static PFNGLGENBUFFERSPROC genBuffers;
+      static PFNGLDELETEBUFFERSPROC deleteBuffers;
+      static PFNGLBINDBUFFERPROC bindBuffer;
+      static PFNGLBUFFERDATAPROC bufferData;
+      static PFNGLBUFFERSUBDATAPROC bufferSubData;
+      static PFNGLMAPBUFFERRANGEPROC mapBufferRange;
+      static PFNGLUNMAPBUFFERPROC unmapBuffer;
+      static PFNGLFENCESYNCPROC fenceSync;
+      static PFNGLCLIENTWAITSYNCPROC clientWaitSync;
+      static PFNGLDELETESYNCPROC deleteSync;
+      static PFNGLVERTEXATTRIBPOINTERPROC vertexAttribPointer;
+      static PFNGLENABLEVERTEXATTRIBARRAYPROC enableVertexAttribArray;
+      static PFNGLCREATESHADERPROC createShader;
+      static PFNGLSHADERSOURCEPROC shaderSource;
+      static PFNGLCOMPILESHADERPROC compileShader;
+      static PFNGLGETSHADERIVPROC getShaderiv;
+      static PFNGLGETSHADERINFOLOGPROC getShaderInfoLog;
+      static PFNGLDELETESHADERPROC deleteShader;
+      static PFNGLCREATEPROGRAMPROC createProgram;
+      static PFNGLATTACHSHADERPROC attachShader;
+      static PFNGLBINDATTRIBLOCATIONPROC bindAttribLocation;
+      static PFNGLLINKPROGRAMPROC linkProgram;
+      static PFNGLGETPROGRAMIVPROC getProgramiv;
+      static PFNGLGETPROGRAMINFOLOGPROC getProgramInfoLog;
+      static PFNGLDELETEPROGRAMPROC deleteProgram;
+      static PFNGLUSEPROGRAMPROC useProgram;
+      static PFNGLGETUNIFORMLOCATIONPROC getUniformLocation;
+      static PFNGLUNIFORM1IPROC uniform1i;
+      static PFNGLUNIFORM2FPROC uniform2f;
+      static PFNGLACTIVETEXTUREPROC activeTexture;
+      static PFNGLBLENDFUNCSEPARATEPROC blendFuncSeparate;
+      static PFNGLBLENDEQUATIONSEPARATEPROC blendEquationSeparate;
+      static PFNGLBINDSAMPLERPROC bindSampler;
+      static PFNGLGETSTRINGIPROC getStringi;
+      static PFNGLTEXSTORAGE2DPROC texStorage2D; /**< NULL if unsupported */
+
+   private:
+      /*! \return if the context has an extension */
+      static bool hasExtension(const char* name);
+
+      static bool loaded; /**< If functions were loaded */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,452 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opengl3renderer.h"
+#include "opengl3widgetrenderer.h"
+#include "opengldraw.h"
+#include "openglsurface.h"
+#include "../controller.h"
+#include "../framestats.h"
+#include "../trace.h"
+
+#include <kobold/log.h>
+#include <stddef.h>
+
+namespace Farso
+{
+
+/*! Vertex shader: screen coordinates (top left origin) to clip space */
+static const char* farsoGL3VertexShader =
+   "#version 330 core\n"
+   "layout(location = 0) in vec2 position;\n"
+   "layout(location = 1) in vec2 texCoord;\n"
+   "uniform vec2 screenSize;\n"
+   "out vec2 uv;\n"
+   "void main()\n"
+   "{\n"
+   "   uv = texCoord;\n"
+   "   gl_Position = vec4(position.x * 2.0 / screenSize.x - 1.0,\n"
+   "                      1.0 - position.y * 2.0 / screenSize.y,\n"
+   "                      0.0, 1.0);\n"
+   "}\n";
+
+/*! Fragment shader: just the widget surface texel */
+static const char* farsoGL3FragmentShader =
+   "#version 330 core\n"
+   "in vec2 uv;\n"
+   "uniform sampler2D surface;\n"
+   "out vec4 color;\n"
+   "void main()\n"
+   "{\n"
+   "   color = texture(surface, uv);\n"
+   "}\n";
+
+/**************************************************************************
+ *                              Constructor                               *
+ **************************************************************************/
+OpenGL3Renderer::OpenGL3Renderer()
+{
+   this->draw = new OpenGLDraw();
+   program = 0;
+   screenSizeUniform = -1;
+   surfaceUniform = -1;
+   vertexArray = 0;
+   vertexBuffer = 0;
+   bufferCapacity = 0;
+   in2dMode = false;
+
+   if(OpenGL3Functions::load())
+   {
+      State state;
+      state.save();
+      if(!createObjects())
+      {
+         Kobold::Log::add(Kobold::LOG_LEVEL_ERROR,
+               "Error: couldn't initialize the OpenGL 3 renderer!");
+      }
+      state.restore();
+   }
+}
+
+/**************************************************************************
+ *                               Destructor                               *
+ **************************************************************************/
+OpenGL3Renderer::~OpenGL3Renderer()
+{
+   if(!OpenGL3Functions::isLoaded())
+   {
+      return;
+   }
+   if(vertexBuffer != 0)
+   {
+      OpenGL3Functions::deleteBuffers(1, &vertexBuffer);
+   }
+   if(vertexArray != 0)
+   {
+      OpenGL3Functions::deleteVertexArrays(1, &vertexArray);
+   }
+   if(program != 0)
+   {
+      OpenGL3Functions::deleteProgram(program);
+   }
+}
+
+/**************************************************************************
+ *                             compileShader                              *
+ **************************************************************************/
+GLuint OpenGL3Renderer::compileShader(GLenum type, const char* source)
+{
+   GLuint shader = OpenGL3Functions::createShader(type);
+   OpenGL3Functions::shaderSource(shader, 1, &source, NULL);
+   OpenGL3Functions::compileShader(shader);
+
+   GLint status = GL_FALSE;
+   OpenGL3Functions::getShaderiv(shader, GL_COMPILE_STATUS, &status);
+   if(status != GL_TRUE)
+   {
+      char log[1024];
+      OpenGL3Functions::getShaderInfoLog(shader, sizeof(log), NULL, log);
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't compile Farso's shader: %s", log);
+      OpenGL3Functions::deleteShader(shader);
+      return 0;
+   }
+
+   return shader;
+}
+
+/**************************************************************************
+ *                             createObjects                              *
+ **************************************************************************/
+bool OpenGL3Renderer::createObjects()
+{
+   /* Program */
+   GLuint vertex = compileShader(GL_VERTEX_SHADER, farsoGL3VertexShader);
+   GLuint fragment = compileShader(GL_FRAGMENT_SHADER, 
+         farsoGL3FragmentShader);
+   if((vertex == 0) || (fragment == 0))
+   {
+      if(vertex != 0)
+      {
+         OpenGL3Functions::deleteShader(vertex);
+      }
+      if(fragment != 0)
+      {
+         OpenGL3Functions::deleteShader(fragment);
+      }
+      return false;
+   }
+
+   GLuint prog = OpenGL3Functions::createProgram();
+   OpenGL3Functions::attachShader(prog, vertex);
+   OpenGL3Functions::attachShader(prog, fragment);
+   OpenGL3Functions::linkProgram(prog);
+   /* Note: shaders are only really deleted with the program */
+   OpenGL3Functions::deleteShader(vertex);
+   OpenGL3Functions::deleteShader(fragment);
+
+   GLint status = GL_FALSE;
+   OpenGL3Functions::getProgramiv(prog, GL_LINK_STATUS, &status);
+   if(status != GL_TRUE)
+   {
+      char log[1024];
+      OpenGL3Functions::getProgramInfoLog(prog, sizeof(log), NULL, log);
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't link Farso's shader program: %s", log);
+      OpenGL3Functions::deleteProgram(prog);
+      return false;
+   }
+   screenSizeUniform = OpenGL3Functions::getUniformLocation(prog, 
+         "screenSize");
+   surfaceUniform = OpenGL3Functions::getUniformLocation(prog, "surface");
+
+   /* Vertex array with the layout of our (single) vertex buffer */
+   OpenGL3Functions::genVertexArrays(1, &vertexArray);
+   OpenGL3Functions::genBuffers(1, &vertexBuffer);
+   OpenGL3Functions::bindVertexArray(vertexArray);
+   OpenGL3Functions::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+   OpenGL3Functions::enableVertexAttribArray(0);
+   OpenGL3Functions::vertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 
+         sizeof(Vertex), (const void*) offsetof(Vertex, x));
+   OpenGL3Functions::enableVertexAttribArray(1);
+   OpenGL3Functions::vertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 
+         sizeof(Vertex), (const void*) offsetof(Vertex, u));
+
+   /* Only set as valid when everything is created */
+   program = prog;
+   return true;
+}
+
+/**************************************************************************
+ *                          createWidgetRenderer                          *
+ **************************************************************************/
+WidgetRenderer* OpenGL3Renderer::createWidgetRenderer(int width, int height)
+{
+   return new OpenGL3WidgetRenderer(width, height);
+}
+
+/*************************************************************************
+ *                              enter2dMode                              *
+ *************************************************************************/
+void OpenGL3Renderer::enter2dMode()
+{
+   hostState.save();
+   in2dMode = true;
+   setUnpackState();
+}
+
+/*************************************************************************
+ *                             restore3dMode                             *
+ *************************************************************************/
+void OpenGL3Renderer::restore3dMode()
+{
+   flush();
+   hostState.restore();
+   in2dMode = false;
+}
+
+/*************************************************************************
+ *                              beginUpload                              *
+ *************************************************************************/
+void OpenGL3Renderer::beginUpload()
+{
+   if(!in2dMode)
+   {
+      uploadState.save();
+      setUnpackState();
+   }
+}
+
+/*************************************************************************
+ *                               endUpload                               *
+ *************************************************************************/
+void OpenGL3Renderer::endUpload()
+{
+   if(!in2dMode)
+   {
+      uploadState.restore();
+   }
+}
+
+/*************************************************************************
+ *                            setUnpackState                             *
+ *************************************************************************/
+void OpenGL3Renderer::setUnpackState()
+{
+   /* Uploads are from our client memory, at texture unit 0 */
+   OpenGL3Functions::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   OpenGL3Functions::activeTexture(GL_TEXTURE0);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+   glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+   glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+}
+
+/*************************************************************************
+ *                                addQuad                                *
+ *************************************************************************/
+void OpenGL3Renderer::addQuad(GLuint texture, int x, int y, int width, 
+      int height, float u2, float v2)
+{
+   Vertex v[4];
+   v[0].x = x;         v[0].y = y;          v[0].u = 0.0f; v[0].v = 0.0f;
+   v[1].x = x + width; v[1].y = y;          v[1].u = u2;   v[1].v = 0.0f;
+   v[2].x = x + width; v[2].y = y + height; v[2].u = u2;   v[2].v = v2;
+   v[3].x = x;         v[3].y = y + height; v[3].u = 0.0f; v[3].v = v2;
+
+   /* Two triangles per quad */
+   vertices.push_back(v[0]);
+   vertices.push_back(v[1]);
+   vertices.push_back(v[2]);
+   vertices.push_back(v[0]);
+   vertices.push_back(v[2]);
+   vertices.push_back(v[3]);
+
+   textures.push_back(texture);
+}
+
+/*************************************************************************
+ *                                 flush                                 *
+ *************************************************************************/
+void OpenGL3Renderer::flush()
+{
+   if((textures.empty()) || (program == 0))
+   {
+      vertices.clear();
+      textures.clear();
+      return;
+   }
+   FARSO_TRACE_SCOPE("OpenGL3Renderer::flush");
+
+   OpenGL3Functions::useProgram(program);
+   OpenGL3Functions::uniform2f(screenSizeUniform, 
+         (float) Controller::getWidth(), (float) Controller::getHeight());
+   OpenGL3Functions::uniform1i(surfaceUniform, 0);
+
+   /* Send the batch, orphaning the previous buffer storage */
+   OpenGL3Functions::bindVertexArray(vertexArray);
+   OpenGL3Functions::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+   if(vertices.size() > bufferCapacity)
+   {
+      bufferCapacity = vertices.size();
+   }
+   OpenGL3Functions::bufferData(GL_ARRAY_BUFFER, 
+         bufferCapacity * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+   OpenGL3Functions::bufferSubData(GL_ARRAY_BUFFER, 0, 
+         vertices.size() * sizeof(Vertex), &vertices[0]);
+
+   /* State for all quads */
+   glEnable(GL_BLEND);
+   if(Controller::isPremultipliedAlpha())
+   {
+      OpenGL3Functions::blendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
+            GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+   }
+   else
+   {
+      OpenGL3Functions::blendFuncSeparate(GL_SRC_ALPHA, 
+            GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+   }
+   OpenGL3Functions::blendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+   glDisable(GL_DEPTH_TEST);
+   glDisable(GL_STENCIL_TEST);
+   glDisable(GL_SCISSOR_TEST);
+   glDisable(GL_CULL_FACE);
+   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+   OpenGL3Functions::activeTexture(GL_TEXTURE0);
+   OpenGL3Functions::bindSampler(0, 0);
+
+   /* A draw call per run of quads with the same texture */
+   int drawCalls = 0;
+   size_t start = 0;
+   for(size_t i = 1; i <= textures.size(); i++)
+   {
+      if((i == textures.size()) || (textures[i] != textures[start]))
+      {
+         glBindTexture(GL_TEXTURE_2D, textures[start]);
+         glDrawArrays(GL_TRIANGLES, start * 6, (i - start) * 6);
+         drawCalls++;
+         start = i;
+      }
+   }
+   FrameStats::count(FrameStats::COUNTER_DRAW_CALLS, drawCalls);
+
+   vertices.clear();
+   textures.clear();
+}
+
+/**************************************************************************
+ *                          loadImageToSurface                            *
+ **************************************************************************/
+Surface* OpenGL3Renderer::loadImageToSurface(const Kobold::String& filename) 
+{
+   return new OpenGLSurface(filename);
+}
+
+/**************************************************************************
+ *                             createSurface                              *
+ **************************************************************************/
+Surface* OpenGL3Renderer::createSurface(const Kobold::String& name, 
+      int width, int height)
+{
+   return new OpenGLSurface(name, width, height);
+}
+
+/**************************************************************************
+ *                              State::save                               *
+ **************************************************************************/
+void OpenGL3Renderer::State::save()
+{
+   glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+   glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+   glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+   glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+   glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+   OpenGL3Functions::activeTexture(GL_TEXTURE0);
+   glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+   glGetIntegerv(GL_SAMPLER_BINDING, &sampler);
+   OpenGL3Functions::activeTexture(activeTexture);
+
+   blend = glIsEnabled(GL_BLEND);
+   depthTest = glIsEnabled(GL_DEPTH_TEST);
+   stencilTest = glIsEnabled(GL_STENCIL_TEST);
+   scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+   cullFace = glIsEnabled(GL_CULL_FACE);
+   glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+
+   glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrcRgb);
+   glGetIntegerv(GL_BLEND_DST_RGB, &blendDstRgb);
+   glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrcAlpha);
+   glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDstAlpha);
+   glGetIntegerv(GL_BLEND_EQUATION_RGB, &blendEquationRgb);
+   glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blendEquationAlpha);
+
+   glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+   glGetIntegerv(GL_UNPACK_ROW_LENGTH, &unpackRowLength);
+   glGetIntegerv(GL_UNPACK_SKIP_PIXELS, &unpackSkipPixels);
+   glGetIntegerv(GL_UNPACK_SKIP_ROWS, &unpackSkipRows);
+}
+
+/**************************************************************************
+ *                             State::restore                             *
+ **************************************************************************/
+/*! Enable or disable a capability */
+static void setCapability(GLenum cap, GLboolean enabled)
+{
+   if(enabled)
+   {
+      glEnable(cap);
+   }
+   else
+   {
+      glDisable(cap);
+   }
+}
+
+void OpenGL3Renderer::State::restore()
+{
+   OpenGL3Functions::useProgram(program);
+   OpenGL3Functions::bindVertexArray(vertexArray);
+   OpenGL3Functions::bindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+   OpenGL3Functions::bindBuffer(GL_PIXEL_UNPACK_BUFFER, unpackBuffer);
+   OpenGL3Functions::activeTexture(GL_TEXTURE0);
+   glBindTexture(GL_TEXTURE_2D, texture);
+   OpenGL3Functions::bindSampler(0, sampler);
+   OpenGL3Functions::activeTexture(activeTexture);
+
+   setCapability(GL_BLEND, blend);
+   setCapability(GL_DEPTH_TEST, depthTest);
+   setCapability(GL_STENCIL_TEST, stencilTest);
+   setCapability(GL_SCISSOR_TEST, scissorTest);
+   setCapability(GL_CULL_FACE, cullFace);
+   glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+
+   OpenGL3Functions::blendFuncSeparate(blendSrcRgb, blendDstRgb, 
+         blendSrcAlpha, blendDstAlpha);
+   OpenGL3Functions::blendEquationSeparate(blendEquationRgb, 
+         blendEquationAlpha);
+
+   glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, unpackRowLength);
+   glPixelStorei(GL_UNPACK_SKIP_PIXELS, unpackSkipPixels);
+   glPixelStorei(GL_UNPACK_SKIP_ROWS, unpackSkipRows);
+}
+
+}
+
@@ -0,0 +1,157 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_opengl3_renderer_h
+#define _farso_opengl3_renderer_h
+
+#include "../renderer.h"
+#include "opengl3functions.h"
+
+#include <vector>
+
+namespace Farso
+{
+
+/*! Renderer for OpenGL 3.3 core profile contexts. Widget renderers are 
+ * textures (with immutable storage, when available) composited in batch
+ * by a tiny shader program from a single vertex buffer, without any 
+ * fixed-function state. 
+ *
+ * All OpenGL state changed by Farso (program, vertex array, buffer and
+ * texture bindings, blending, depth, stencil, scissor and culling tests,
+ * color mask and pixel unpack parameters) is saved at enter2dMode (and 
+ * before uploads done outside it) and restored at restore3dMode, thus
+ * the host application state isn't disturbed.
+ *
+ * \note as it only needs OpenGL 3.3 core features, it runs on software
+ *       implementations too (for example, Mesa's llvmpipe, with
+ *       LIBGL_ALWAYS_SOFTWARE=1).
+ * \note must be created with the OpenGL context current. */
+class OpenGL3Renderer : public Renderer
+{
+   public:
+      /*! Constructor */ 
+      OpenGL3Renderer();
+      /*! Destructor */
+      virtual ~OpenGL3Renderer();
+
+      /*! \return if the renderer was successfully initialized (ie: the
+       *          context has the needed functions and our shaders were 
+       *          compiled). */
+      const bool isValid() const { return program != 0; };
+
+      /*! \return new OpenGL3WidgetRenderer */
+      WidgetRenderer* createWidgetRenderer(int width, int height) override;
+
+      void enter2dMode() override;
+      void restore3dMode() override;
+      const bool shouldManualRender() const override { return true; };
+      Surface* loadImageToSurface(const Kobold::String& filename) override;
+      Surface* createSurface(const Kobold::String& name, 
+            int width, int height) override;
+
+      /*! Add a widget renderer quad to the frame batch.
+       * \param texture texture to use
+       * \param x left screen coordinate
+       * \param y top screen coordinate
+       * \param width quad width
+       * \param height quad height
+       * \param u2 right texture coordinate
+       * \param v2 bottom texture coordinate */
+      void addQuad(GLuint texture, int x, int y, int width, int height,
+            float u2, float v2);
+
+      /*! Prepare the state for a texture upload, saving the current one 
+       * if outside enter2dMode. Must be followed by an endUpload call. */
+      void beginUpload();
+      /*! Restore the state changed by an upload, if outside enter2dMode */
+      void endUpload();
+
+   private:
+      /*! OpenGL state changed by us */
+      struct State
+      {
+         /*! Save the current state */
+         void save();
+         /*! Restore the saved state */
+         void restore();
+
+         GLint program; /**< Current program */
+         GLint vertexArray; /**< Bound vertex array */
+         GLint arrayBuffer; /**< Bound array buffer */
+         GLint unpackBuffer; /**< Bound pixel unpack buffer */
+         GLint activeTexture; /**< Active texture unit */
+         GLint texture; /**< 2D texture bound at unit 0 */
+         GLint sampler; /**< Sampler bound at unit 0 */
+         GLboolean blend; /**< If blend is enabled */
+         GLboolean depthTest; /**< If depth test is enabled */
+         GLboolean stencilTest; /**< If stencil test is enabled */
+         GLboolean scissorTest; /**< If scissor test is enabled */
+         GLboolean cullFace; /**< If face culling is enabled */
+         GLboolean colorMask[4]; /**< Color write mask */
+         GLint blendSrcRgb; /**< Blend function */
+         GLint blendDstRgb; /**< Blend function */
+         GLint blendSrcAlpha; /**< Blend function */
+         GLint blendDstAlpha; /**< Blend function */
+         GLint blendEquationRgb; /**< Blend equation */
+         GLint blendEquationAlpha; /**< Blend equation */
+         GLint unpackAlignment; /**< Pixel unpack alignment */
+         GLint unpackRowLength; /**< Pixel unpack row length */
+         GLint unpackSkipPixels; /**< Pixel unpack skip pixels */
+         GLint unpackSkipRows; /**< Pixel unpack skip rows */
+      };
+
+      /*! A vertex of the batch */
+      struct Vertex
+      {
+         GLfloat x; /**< Screen coordinate */
+         GLfloat y; /**< Screen coordinate */
+         GLfloat u; /**< Texture coordinate */
+         GLfloat v; /**< Texture coordinate */
+      };
+
+      /*! Compile a shader. \return shader or 0 on error */
+      GLuint compileShader(GLenum type, const char* source);
+      /*! Create our program, vertex array and buffer */
+      bool createObjects();
+      /*! Set the pixel unpack state for our uploads */
+      void setUnpackState();
+      /*! Draw the frame batch */
+      void flush();
+
+      GLuint program; /**< Shader program */
+      GLint screenSizeUniform; /**< Location of the screen size uniform */
+      GLint surfaceUniform; /**< Location of the sampler uniform */
+      GLuint vertexArray; /**< Vertex array object */
+      GLuint vertexBuffer; /**< Vertex buffer object */
+      size_t bufferCapacity; /**< Vertex buffer capacity, in vertices */
+
+      std::vector<Vertex> vertices; /**< Frame batch vertices, 6 per quad */
+      std::vector<GLuint> textures; /**< Texture of each quad */
+
+      bool in2dMode; /**< If between enter2dMode and restore3dMode */
+      State hostState; /**< Host state saved at enter2dMode */
+      State uploadState; /**< Host state saved at beginUpload */
+};
+
+}
+
+#endif
+
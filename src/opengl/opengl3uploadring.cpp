@@ -0,0 +1,178 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opengl3uploadring.h"
+#include <string.h>
+
+using namespace Farso;
+
+/************************************************************************
+ *                          OpenGL3UploadRing                           *
+ ************************************************************************/
+OpenGL3UploadRing::OpenGL3UploadRing(int totalBuffers)
+{
+   Buffer buffer;
+   buffer.id = 0;
+   buffer.capacity = 0;
+   buffer.fence = NULL;
+   buffers.assign((totalBuffers > 0) ? totalBuffers : 1, buffer);
+   next = 0;
+}
+
+/************************************************************************
+ *                         ~OpenGL3UploadRing                           *
+ ************************************************************************/
+OpenGL3UploadRing::~OpenGL3UploadRing()
+{
+   for(size_t i = 0; i < buffers.size(); i++)
+   {
+      if(buffers[i].fence != NULL)
+      {
+         OpenGL3Functions::deleteSync(buffers[i].fence);
+      }
+      if(buffers[i].id != 0)
+      {
+         OpenGL3Functions::deleteBuffers(1, &buffers[i].id);
+      }
+   }
+}
+
+/************************************************************************
+ *                               isFree                                 *
+ ************************************************************************/
+bool OpenGL3UploadRing::isFree(Buffer& buffer)
+{
+   if(buffer.fence == NULL)
+   {
+      return true;
+   }
+
+   /* Just poll: we never wait for the GPU here */
+   GLenum res = OpenGL3Functions::clientWaitSync(buffer.fence, 0, 0);
+   if(res == GL_TIMEOUT_EXPIRED)
+   {
+      return false;
+   }
+
+   /* Signaled (or failed, when it won't be ever signaled) */
+   OpenGL3Functions::deleteSync(buffer.fence);
+   buffer.fence = NULL;
+   return true;
+}
+
+/************************************************************************
+ *                               upload                                 *
+ ************************************************************************/
+size_t OpenGL3UploadRing::upload(SDL_Surface* surface, 
+      const std::list<Rect>& areas, int x, int y)
+{
+   int bpp = surface->format->BytesPerPixel;
+   size_t bytes = 0;
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      bytes += (*it).getWidth() * (*it).getHeight() * bpp;
+   }
+   if(bytes == 0)
+   {
+      return 0;
+   }
+
+   /* Find the next buffer not in use */
+   Buffer* buffer = NULL;
+   for(size_t i = 0; (i < buffers.size()) && (buffer == NULL); i++)
+   {
+      size_t index = (next + i) % buffers.size();
+      if(isFree(buffers[index]))
+      {
+         buffer = &buffers[index];
+         next = (index + 1) % buffers.size();
+      }
+   }
+   if(buffer == NULL)
+   {
+      return 0;
+   }
+
+   if(buffer->id == 0)
+   {
+      OpenGL3Functions::genBuffers(1, &buffer->id);
+   }
+   OpenGL3Functions::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->id);
+   if(buffer->capacity < bytes)
+   {
+      OpenGL3Functions::bufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL,
+            GL_STREAM_DRAW);
+      buffer->capacity = bytes;
+   }
+
+   /* Note: it's safe to map unsynchronized, as its fence was signaled */
+   Uint8* mapped = (Uint8*) OpenGL3Functions::mapBufferRange(
+         GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | 
+         GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+   if(mapped == NULL)
+   {
+      OpenGL3Functions::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      return 0;
+   }
+
+   /* Write each area, tightly packed */
+   size_t offset = 0;
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      const Rect& area = *it;
+      size_t rowBytes = area.getWidth() * bpp;
+      Uint8* src = (Uint8*) surface->pixels + 
+                   area.getY1() * surface->pitch + area.getX1() * bpp;
+      for(int y = 0; y < area.getHeight(); y++)
+      {
+         memcpy(mapped + offset, src, rowBytes);
+         src += surface->pitch;
+         offset += rowBytes;
+      }
+   }
+   if(OpenGL3Functions::unmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE)
+   {
+      /* Contents were lost (ie: video mode change) */
+      OpenGL3Functions::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      return 0;
+   }
+
+   /* Update the texture from it: returns without waiting the copy */
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+   offset = 0;
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      const Rect& area = *it;
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x + area.getX1(), 
+            y + area.getY1(), area.getWidth(), area.getHeight(), GL_RGBA, 
+            GL_UNSIGNED_BYTE, (const void*) offset);
+      offset += area.getWidth() * area.getHeight() * bpp;
+   }
+   buffer->fence = OpenGL3Functions::fenceSync(
+         GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+   OpenGL3Functions::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+   return bytes;
+}
+
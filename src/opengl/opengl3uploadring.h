@@ -0,0 +1,85 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_opengl3_upload_ring_h
+#define _farso_opengl3_upload_ring_h
+
+#include "opengl3functions.h"
+#include "../rect.h"
+
+#include <list>
+#include <vector>
+
+/*! Default number of pixel buffers of a ring: one being written by us
+ * while the previous frame's one is still read by the GPU */
+#define FARSO_DEFAULT_UPLOAD_RING_SIZE   2
+
+namespace Farso
+{
+
+/*! A ring of pixel unpack buffers to stream texture updates without
+ * stalling the CPU on the driver's copy from client memory.
+ *
+ * Dirty areas are written (tightly packed) into a mapped buffer, and the
+ * texture update is issued from it, thus done by the GPU asynchronously.
+ * A fence is inserted after each use: a buffer still being read is
+ * never overwritten, the next free one being used instead (or none, 
+ * letting the caller upload from client memory). 
+ * \note must be used with the OpenGL context current. */
+class OpenGL3UploadRing
+{
+   public:
+      /*! Constructor
+       * \param totalBuffers number of buffers on the ring */
+      OpenGL3UploadRing(int totalBuffers = FARSO_DEFAULT_UPLOAD_RING_SIZE);
+      /*! Destructor */
+      ~OpenGL3UploadRing();
+
+      /*! Upload areas of a surface to the texture currently bound at
+       * GL_TEXTURE_2D, through the next free buffer of the ring.
+       * \param surface RGBA surface to upload from
+       * \param areas areas to upload
+       * \param x offset of the surface on the texture
+       * \param y offset of the surface on the texture
+       * \return bytes uploaded or 0 if no buffer was available (all still
+       *         in use by the GPU), in which case nothing was done. */
+      size_t upload(SDL_Surface* surface, const std::list<Rect>& areas,
+            int x = 0, int y = 0);
+
+   private:
+      /*! A pixel buffer of the ring */
+      struct Buffer
+      {
+         GLuint id; /**< Buffer object (0 if not yet created) */
+         size_t capacity; /**< Allocated bytes */
+         GLsync fence; /**< Fence after its last use, if any */
+      };
+
+      /*! \return if the buffer isn't in use by the GPU anymore */
+      bool isFree(Buffer& buffer);
+
+      std::vector<Buffer> buffers; /**< The buffers */
+      size_t next; /**< Index of the next buffer to use */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,213 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opengl3widgetrenderer.h"
+#include "opengl3renderer.h"
+#include "opengl3uploadring.h"
+#include "openglsurface.h"
+#include "../controller.h"
+
+using namespace Farso;
+
+/************************************************************************
+ *                        OpenGL3WidgetRenderer                         *
+ ************************************************************************/
+OpenGL3WidgetRenderer::OpenGL3WidgetRenderer(int width, int height)
+                      :WidgetRenderer(width, height)
+{
+   posX = 0;
+   posY = 0;
+   propX = 0.0f;
+   propY = 0.0f;
+   texture = 0;
+   textureWidth = 0;
+   textureHeight = 0;
+   uploadRing = NULL;
+}
+
+/************************************************************************
+ *                       ~OpenGL3WidgetRenderer                         *
+ ************************************************************************/
+OpenGL3WidgetRenderer::~OpenGL3WidgetRenderer()
+{
+   if(uploadRing != NULL)
+   {
+      delete uploadRing;
+   }
+   if(texture != 0)
+   {
+      glDeleteTextures(1, &texture);
+   }
+   if(surface)
+   {
+      deleteSurface();
+   }
+}
+
+/************************************************************************
+ *                            createSurface                             *
+ ************************************************************************/
+void OpenGL3WidgetRenderer::createSurface()
+{
+   this->surface = new OpenGLSurface(name, realWidth, realHeight);
+
+   /* Calculate its max coordinate, as size may not equal (as powerOfTwo) */
+   propX = (float) (width) / (float) this->realWidth;
+   propY = (float) (height) / (float) this->realHeight;
+}
+
+/************************************************************************
+ *                          doUploadSurface                             *
+ ************************************************************************/
+size_t OpenGL3WidgetRenderer::doUploadSurface(const std::list<Rect>& areas)
+{
+   OpenGL3Renderer* renderer = static_cast<OpenGL3Renderer*>(
+         Controller::getRenderer());
+   if(!renderer->isValid())
+   {
+      return 0;
+   }
+
+   SDL_Surface* sdlSurf = ((OpenGLSurface*) getSurface())->getSurface();
+   size_t bytes = 0;
+
+   renderer->beginUpload();
+   if((texture == 0) || (textureWidth != sdlSurf->w) || 
+      (textureHeight != sdlSurf->h))
+   {
+      /* Texture not yet created (or surface was recreated with a new 
+       * size). Immutable storage can't be resized, so always a new one. */
+      if(texture != 0)
+      {
+         glDeleteTextures(1, &texture);
+      }
+      glGenTextures(1, &texture);
+      glBindTexture(GL_TEXTURE_2D, texture);
+      textureWidth = sdlSurf->w;
+      textureHeight = sdlSurf->h;
+
+      if(OpenGL3Functions::hasTextureStorage())
+      {
+         OpenGL3Functions::texStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 
+               textureWidth, textureHeight);
+      }
+      else
+      {
+         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureWidth, 
+               textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+      }
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+      /* Fresh storage: must receive the whole surface */
+      std::list<Rect> all;
+      all.push_back(Rect(0, 0, textureWidth - 1, textureHeight - 1));
+      bytes = uploadAreas(all);
+   }
+   else
+   {
+      /* Storage already allocated: just update the changed areas,
+       * streaming them through our ring, if any buffer is free. */
+      glBindTexture(GL_TEXTURE_2D, texture);
+      if(uploadRing == NULL)
+      {
+         uploadRing = new OpenGL3UploadRing();
+      }
+      bytes = uploadRing->upload(sdlSurf, areas);
+      if(bytes == 0)
+      {
+         bytes = uploadAreas(areas);
+      }
+   }
+   renderer->endUpload();
+
+   return bytes;
+}
+
+/************************************************************************
+ *                             uploadAreas                              *
+ ************************************************************************/
+size_t OpenGL3WidgetRenderer::uploadAreas(const std::list<Rect>& areas)
+{
+   SDL_Surface* sdlSurf = ((OpenGLSurface*) getSurface())->getSurface();
+   int bpp = sdlSurf->format->BytesPerPixel;
+
+   /* Read from our surface with its full row length */
+   size_t bytes = 0;
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, sdlSurf->pitch / bpp);
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      const Rect& area = *it;
+      Uint8* pixels = (Uint8*) sdlSurf->pixels + 
+                      area.getY1() * sdlSurf->pitch + area.getX1() * bpp;
+      glTexSubImage2D(GL_TEXTURE_2D, 0, area.getX1(), area.getY1(),
+            area.getWidth(), area.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE,
+            pixels);
+
+      bytes += area.getWidth() * area.getHeight() * bpp;
+   }
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+   return bytes;
+}
+
+/************************************************************************
+ *                            doSetPosition                             *
+ ************************************************************************/
+void OpenGL3WidgetRenderer::doSetPosition(float x, float y)
+{
+   /* Note: our shader already uses a top left origin */
+   posX = (int) x;
+   posY = (int) y;
+}
+
+/************************************************************************
+ *                               doHide                                 *
+ ************************************************************************/
+void OpenGL3WidgetRenderer::doHide()
+{
+}
+
+/************************************************************************
+ *                               doShow                                 *
+ ************************************************************************/
+void OpenGL3WidgetRenderer::doShow()
+{
+}
+
+/************************************************************************
+ *                              doRender                                *
+ ************************************************************************/
+void OpenGL3WidgetRenderer::doRender()
+{
+   if(texture == 0)
+   {
+      /* Not yet uploaded */
+      return;
+   }
+
+   static_cast<OpenGL3Renderer*>(Controller::getRenderer())->addQuad(
+         texture, posX, posY, width, height, propX, propY);
+}
+
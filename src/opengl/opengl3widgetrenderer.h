@@ -0,0 +1,75 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_opengl3_widget_renderer_h
+#define _farso_opengl3_widget_renderer_h
+
+#include "../widgetrenderer.h"
+#include "opengl3functions.h"
+
+namespace Farso
+{
+
+class OpenGL3UploadRing;
+
+/*! The WidgetRenderer for OpenGL 3.3 core profile (see OpenGL3Renderer).
+ * \note partial updates (ie: from a constantly changing widget) are 
+ *       streamed through a ring of pixel buffers, created at its first
+ *       partial update. */
+class OpenGL3WidgetRenderer: public WidgetRenderer
+{
+   public:
+      /*! Constructor
+       * \param width renderer width 
+       * \param height renderer height */
+      OpenGL3WidgetRenderer(int width, int height); 
+      ~OpenGL3WidgetRenderer();
+
+      /* not used.  */
+      void setRenderQueueSubGroup(int renderQueueId){};
+
+   protected:
+      
+      void createSurface();
+      void doSetPosition(float x, float y);
+      void doHide();
+      void doShow();
+      void doRender();
+      size_t doUploadSurface(const std::list<Rect>& areas);
+
+   private:
+      /*! Upload areas of the surface to our (already bound) texture
+       * \return bytes uploaded */
+      size_t uploadAreas(const std::list<Rect>& areas);
+
+      int posX;        /**< current X position on screen */
+      int posY;        /**< current Y position on screen */
+      GLuint texture;  /**< GL texture for the renderer */
+      int textureWidth;  /**< Width of the allocated texture storage */
+      int textureHeight; /**< Height of the allocated texture storage */
+      float propX;     /**< Proportional texture coordinate */
+      float propY;     /**< Proportional texture coordinate */
+      OpenGL3UploadRing* uploadRing; /**< Ring for partial updates */
+};
+
+}
+
+#endif
+
@@ -0,0 +1,119 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "openglcompositor.h"
+#include "openglwidgetrenderer.h"
+#include "../framestats.h"
+#include "../trace.h"
+
+using namespace Farso;
+
+/************************************************************************
+ *                           OpenGLCompositor                           *
+ ************************************************************************/
+OpenGLCompositor::OpenGLCompositor()
+{
+   lastDrawCalls = 0;
+}
+
+/************************************************************************
+ *                          ~OpenGLCompositor                           *
+ ************************************************************************/
+OpenGLCompositor::~OpenGLCompositor()
+{
+}
+
+/************************************************************************
+ *                               addQuad                                *
+ ************************************************************************/
+void OpenGLCompositor::addQuad(GLuint texture, float x1, float y1, 
+      float x2, float y2, float u1, float v1, float u2, float v2)
+{
+   /* Same vertex order of the immediate mode quad */
+   Vertex vert;
+   vert.u = u1; vert.v = v2; vert.x = x1; vert.y = y1;
+   vertices.push_back(vert);
+   vert.u = u1; vert.v = v1; vert.x = x1; vert.y = y2;
+   vertices.push_back(vert);
+   vert.u = u2; vert.v = v1; vert.x = x2; vert.y = y2;
+   vertices.push_back(vert);
+   vert.u = u2; vert.v = v2; vert.x = x2; vert.y = y1;
+   vertices.push_back(vert);
+
+   textures.push_back(texture);
+}
+
+/************************************************************************
+ *                                flush                                 *
+ ************************************************************************/
+void OpenGLCompositor::flush(bool premultiplied)
+{
+   lastDrawCalls = 0;
+   if(textures.empty())
+   {
+      return;
+   }
+   FARSO_TRACE_SCOPE("OpenGLCompositor::flush");
+
+   /* Set the state once for all quads */
+   glEnable(GL_BLEND);
+   if(premultiplied)
+   {
+      glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+   }
+   else
+   {
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+   }
+   glDisable(GL_DEPTH_TEST);
+   glEnable(GL_TEXTURE_2D);
+   glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+   glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+   glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].x);
+   glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].u);
+
+   /* A draw call per run of quads with the same texture */
+   size_t start = 0;
+   for(size_t i = 1; i <= textures.size(); i++)
+   {
+      if((i == textures.size()) || (textures[i] != textures[start]))
+      {
+         OpenGLWidgetRenderer::bindTexture(textures[start]);
+         glDrawArrays(GL_QUADS, start * 4, (i - start) * 4);
+         lastDrawCalls++;
+         start = i;
+      }
+   }
+
+   glPopClientAttrib();
+
+   glDisable(GL_TEXTURE_2D);
+   glEnable(GL_DEPTH_TEST);
+   glDisable(GL_BLEND);
+
+   FrameStats::count(FrameStats::COUNTER_DRAW_CALLS, lastDrawCalls);
+
+   vertices.clear();
+   textures.clear();
+}
+
@@ -0,0 +1,82 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_opengl_compositor_h
+#define _farso_opengl_compositor_h
+
+#include <SDL2/SDL_opengl.h>
+#include <vector>
+
+namespace Farso
+{
+
+/*! Batch compositor of OpenGLWidgetRenderers: instead of each renderer 
+ * setting the GL state and drawing its own quad, their quads are 
+ * collected (in render order, thus back to front) into a single vertex 
+ * array, drawn at the end of the frame with the state set just once and
+ * a draw call per run of consecutive quads from the same texture (with 
+ * an OpenGLTextureAtlas, usually a single run per page). */
+class OpenGLCompositor
+{
+   public:
+      /*! Constructor */
+      OpenGLCompositor();
+      /*! Destructor */
+      ~OpenGLCompositor();
+
+      /*! Add a textured quad to the batch.
+       * \param texture texture to use
+       * \param x1 left screen coordinate
+       * \param y1 bottom screen coordinate (OpenGL's, thus y up) 
+       * \param x2 right screen coordinate
+       * \param y2 top screen coordinate
+       * \param u1 left texture coordinate
+       * \param v1 top texture coordinate
+       * \param u2 right texture coordinate
+       * \param v2 bottom texture coordinate */
+      void addQuad(GLuint texture, float x1, float y1, float x2, float y2,
+            float u1, float v1, float u2, float v2);
+
+      /*! Draw all added quads, emptying the batch.
+       * \param premultiplied if textures are in premultiplied alpha */
+      void flush(bool premultiplied);
+
+      /*! \return draw calls issued by the last flush */
+      const int getLastDrawCalls() const { return lastDrawCalls; };
+
+   private:
+      /*! A vertex of the batch */
+      struct Vertex
+      {
+         GLfloat u; /**< Texture coordinate */
+         GLfloat v; /**< Texture coordinate */
+         GLfloat x; /**< Screen coordinate */
+         GLfloat y; /**< Screen coordinate */
+      };
+
+      std::vector<Vertex> vertices; /**< Vertices, 4 per quad */
+      std::vector<GLuint> textures; /**< Texture of each quad */
+      int lastDrawCalls; /**< Draw calls of the last flush */
+};
+
+}
+
+#endif
+
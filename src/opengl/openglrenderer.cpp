@@ -22,12 +22,14 @@
 #include "opengldraw.h"
 #include "openglsurface.h"
 #include "openglwidgetrenderer.h"
+#include "opengl3functions.h"
 #include "../controller.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
 
 #include <kobold/platform.h>
+#include <kobold/log.h>
 
 namespace Farso
 {
@@ -35,9 +37,20 @@ namespace Farso
 /**************************************************************************
  *                              Constructor                               *
  **************************************************************************/
-OpenGLRenderer::OpenGLRenderer()
+OpenGLRenderer::OpenGLRenderer(bool useAtlas, int atlasPageSize)
 {
    this->draw = new OpenGLDraw();
+   this->atlas = (useAtlas) ? new OpenGLTextureAtlas(atlasPageSize) : NULL;
+   this->compositor = new OpenGLCompositor();
+
+   /* Pixel buffers and fences are only available on newer contexts */
+   this->streamUploads = (OpenGL3Functions::isSupported()) && 
+                         (OpenGL3Functions::load());
+   if(!streamUploads)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+            "OpenGL 3.3 not available: uploading from client memory.");
+   }
 }
 
 /**************************************************************************
@@ -45,6 +58,30 @@ OpenGLRenderer::OpenGLRenderer()
  **************************************************************************/
 OpenGLRenderer::~OpenGLRenderer()
 {
+   if(atlas != NULL)
+   {
+      delete atlas;
+   }
+   if(compositor != NULL)
+   {
+      delete compositor;
+   }
+}
+
+/**************************************************************************
+ *                              setBatching                               *
+ **************************************************************************/
+void OpenGLRenderer::setBatching(bool enable)
+{
+   if((enable) && (compositor == NULL))
+   {
+      compositor = new OpenGLCompositor();
+   }
+   else if((!enable) && (compositor != NULL))
+   {
+      delete compositor;
+      compositor = NULL;
+   }
 }
 
 /**************************************************************************
@@ -52,7 +89,7 @@ OpenGLRenderer::~OpenGLRenderer()
  **************************************************************************/
 WidgetRenderer* OpenGLRenderer::createWidgetRenderer(int width, int height)
 {
-   return new OpenGLWidgetRenderer(width, height);
+   return new OpenGLWidgetRenderer(width, height, atlas);
 }
 
 /*************************************************************************
@@ -78,6 +115,9 @@ void OpenGLRenderer::enter2dMode()
    /* Identity to current model view */
    glMatrixMode(GL_MODELVIEW);
    glLoadIdentity();
+
+   /* The application could have bound any texture since last frame */
+   OpenGLWidgetRenderer::resetBoundTexture();
 }
 
 /*************************************************************************
@@ -85,6 +125,12 @@ void OpenGLRenderer::enter2dMode()
  *************************************************************************/
 void OpenGLRenderer::restore3dMode()
 {
+   /* Draw all widget renderers batched this frame */
+   if(compositor != NULL)
+   {
+      compositor->flush(Controller::isPremultipliedAlpha());
+   }
+
    /* Restore Projection matrix */
    glMatrixMode (GL_PROJECTION);
    glPopMatrix();
@@ -102,6 +148,15 @@ Surface* OpenGLRenderer::loadImageToSurface(const Kobold::String& filename)
    return new OpenGLSurface(filename);
 }
 
+/**************************************************************************
+ *                             createSurface                              *
+ **************************************************************************/
+Surface* OpenGLRenderer::createSurface(const Kobold::String& name, 
+      int width, int height)
+{
+   return new OpenGLSurface(name, width, height);
+}
+
 
 }
 
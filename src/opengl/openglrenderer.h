@@ -23,16 +23,26 @@
 
 #include <SDL2/SDL.h>
 #include "../renderer.h"
+#include "opengltextureatlas.h"
+#include "openglcompositor.h"
 
 namespace Farso
 {
 
-/*! SDL Renderer implemenation */
+/*! SDL Renderer implemenation 
+ * \note on OpenGL 3.3 (or newer) compatibility contexts, texture updates
+ *       are streamed through pixel buffers (see OpenGL3UploadRing), 
+ *       falling back to uploads from client memory on older ones. */
 class OpenGLRenderer : public Renderer
 {
    public:
-      /*! Constructor */ 
-      OpenGLRenderer();
+      /*! Constructor 
+       * \param useAtlas if should pack all widget renderers surfaces on
+       *        a shared texture atlas, instead of a texture for each.
+       * \param atlasPageSize width and height of each atlas page 
+       * \note must be created with the OpenGL context current. */ 
+      OpenGLRenderer(bool useAtlas = false, 
+            int atlasPageSize = FARSO_DEFAULT_ATLAS_PAGE_SIZE);
       /*! Destructor */
       virtual ~OpenGLRenderer();
 
@@ -43,7 +53,29 @@ class OpenGLRenderer : public Renderer
       void restore3dMode() override;
       const bool shouldManualRender() const override { return true; };
       Surface* loadImageToSurface(const Kobold::String& filename) override;
+      Surface* createSurface(const Kobold::String& name, 
+            int width, int height) override;
 
+      /*! \return texture atlas used, or NULL if not using one */
+      OpenGLTextureAtlas* getAtlas() { return atlas; };
+
+      /*! Define if widget renderers should be composited in batch (the
+       * default), drawn when restoring the 3d mode, or each one drawn 
+       * with its own state changes and draw call. */
+      void setBatching(bool enable);
+
+      /*! \return compositor to batch the widget renderers at, or NULL if
+       *          not batching. */
+      OpenGLCompositor* getCompositor() { return compositor; };
+
+      /*! \return if texture updates could be streamed through pixel 
+       *          buffers (ie: OpenGL3Functions were loaded). */
+      const bool canStreamUploads() const { return streamUploads; };
+
+   private:
+      OpenGLTextureAtlas* atlas; /**< Shared atlas, if used */
+      OpenGLCompositor* compositor; /**< Batch compositor, if used */
+      bool streamUploads; /**< If could stream uploads */
 };
 
 }
@@ -0,0 +1,258 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "opengltextureatlas.h"
+#include "openglwidgetrenderer.h"
+
+#include <algorithm>
+
+/*! Empty space kept at the right and bottom of each region, avoiding 
+ * linear filtering bleeding between neighbours */
+#define FARSO_ATLAS_REGION_PADDING    1
+
+using namespace Farso;
+
+/*! A region to repack: its index and padded size */
+struct RepackItem
+{
+   size_t index; /**< Index of the region at its page */
+   int width; /**< Padded width */
+   int height; /**< Padded height */
+};
+
+/*! Sort regions by decreasing height, the best order to repack them */
+static bool compareRepackHeight(const RepackItem& a, const RepackItem& b)
+{
+   return a.height > b.height;
+}
+
+/************************************************************************
+ *                          OpenGLTextureAtlas                          *
+ ************************************************************************/
+OpenGLTextureAtlas::OpenGLTextureAtlas(int pageSize)
+{
+   this->pageSize = pageSize;
+}
+
+/************************************************************************
+ *                         ~OpenGLTextureAtlas                          *
+ ************************************************************************/
+OpenGLTextureAtlas::~OpenGLTextureAtlas()
+{
+   for(size_t i = 0; i < pages.size(); i++)
+   {
+      glDeleteTextures(1, &pages[i]->texture);
+      delete pages[i]->packer;
+      delete pages[i];
+   }
+   pages.clear();
+   OpenGLWidgetRenderer::resetBoundTexture();
+}
+
+/************************************************************************
+ *                              createPage                              *
+ ************************************************************************/
+OpenGLTextureAtlas::Page* OpenGLTextureAtlas::createPage()
+{
+   Page* page = new Page();
+   page->packer = new AtlasPacker(pageSize, pageSize);
+
+   glGenTextures(1, &page->texture);
+   OpenGLWidgetRenderer::bindTexture(page->texture, true);
+   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pageSize, pageSize, 0, GL_RGBA,
+         GL_UNSIGNED_BYTE, NULL);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+   pages.push_back(page);
+   return page;
+}
+
+/************************************************************************
+ *                               allocate                               *
+ ************************************************************************/
+bool OpenGLTextureAtlas::allocate(OpenGLWidgetRenderer* owner, 
+      int width, int height)
+{
+   release(owner);
+
+   if((width + FARSO_ATLAS_REGION_PADDING > pageSize) || 
+      (height + FARSO_ATLAS_REGION_PADDING > pageSize))
+   {
+      /* Too big to share a page */
+      return false;
+   }
+
+   /* First at the free space of current pages... */
+   for(size_t i = 0; i < pages.size(); i++)
+   {
+      if(place(pages[i], owner, width, height, false))
+      {
+         return true;
+      }
+   }
+
+   /* ...then defragmenting them... */
+   for(size_t i = 0; i < pages.size(); i++)
+   {
+      if(place(pages[i], owner, width, height, true))
+      {
+         return true;
+      }
+   }
+
+   /* ...and, finally, at a new page */
+   return place(createPage(), owner, width, height, false);
+}
+
+/************************************************************************
+ *                                place                                 *
+ ************************************************************************/
+bool OpenGLTextureAtlas::place(Page* page, OpenGLWidgetRenderer* owner, 
+      int width, int height, bool defrag)
+{
+   const int pad = FARSO_ATLAS_REGION_PADDING;
+
+   Region region;
+   region.owner = owner;
+   region.width = width;
+   region.height = height;
+
+   if(!defrag)
+   {
+      Rect area = page->packer->insert(width + pad, height + pad);
+      if(!area.isDefined())
+      {
+         return false;
+      }
+      region.area.set(area.getX1(), area.getY1(), 
+            area.getX1() + width - 1, area.getY1() + height - 1);
+      page->regions.push_back(region);
+      owner->setAtlasRegion(page->texture, region.area, pageSize, false);
+      return true;
+   }
+
+   /* Only worth repacking if the total area could fit */
+   int total = (width + pad) * (height + pad);
+   for(size_t i = 0; i < page->regions.size(); i++)
+   {
+      total += (page->regions[i].width + pad) * 
+               (page->regions[i].height + pad);
+   }
+   if(total > pageSize * pageSize)
+   {
+      return false;
+   }
+
+   /* Repack on a new packer, by decreasing height (the new region is 
+    * the last one). */
+   page->regions.push_back(region);
+   std::vector<RepackItem> order(page->regions.size());
+   for(size_t i = 0; i < page->regions.size(); i++)
+   {
+      order[i].index = i;
+      order[i].width = page->regions[i].width + pad;
+      order[i].height = page->regions[i].height + pad;
+   }
+   std::stable_sort(order.begin(), order.end(), compareRepackHeight);
+
+   AtlasPacker packer(pageSize, pageSize);
+   std::vector<Rect> areas(page->regions.size());
+   for(size_t i = 0; i < order.size(); i++)
+   {
+      Rect area = packer.insert(order[i].width, order[i].height);
+      if(!area.isDefined())
+      {
+         /* Still doesn't fit: keep the page as it was */
+         page->regions.pop_back();
+         return false;
+      }
+      areas[order[i].index] = area;
+   }
+
+   /* Fit: apply the new positions */
+   *page->packer = packer;
+   for(size_t i = 0; i < page->regions.size(); i++)
+   {
+      Region& cur = page->regions[i];
+      Rect area(areas[i].getX1(), areas[i].getY1(), 
+            areas[i].getX1() + cur.width - 1, 
+            areas[i].getY1() + cur.height - 1);
+      bool isNew = (i + 1 == page->regions.size());
+      if((isNew) || (area != cur.area))
+      {
+         cur.area = area;
+         /* Moved ones must upload its surfaces again */
+         cur.owner->setAtlasRegion(page->texture, cur.area, pageSize, 
+               !isNew);
+      }
+   }
+
+   return true;
+}
+
+/************************************************************************
+ *                                remove                                *
+ ************************************************************************/
+bool OpenGLTextureAtlas::remove(Page* page, OpenGLWidgetRenderer* owner)
+{
+   for(size_t i = 0; i < page->regions.size(); i++)
+   {
+      if(page->regions[i].owner == owner)
+      {
+         page->regions.erase(page->regions.begin() + i);
+         if(page->regions.empty())
+         {
+            /* Whole page free again */
+            page->packer->clear();
+         }
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/************************************************************************
+ *                               release                                *
+ ************************************************************************/
+void OpenGLTextureAtlas::release(OpenGLWidgetRenderer* owner)
+{
+   for(size_t i = 0; i < pages.size(); i++)
+   {
+      Page* page = pages[i];
+      if(remove(page, owner))
+      {
+         if((page->regions.empty()) && (pages.size() > 1))
+         {
+            /* Keep just a single empty page */
+            glDeleteTextures(1, &page->texture);
+            OpenGLWidgetRenderer::resetBoundTexture();
+            delete page->packer;
+            delete page;
+            pages.erase(pages.begin() + i);
+         }
+         return;
+      }
+   }
+}
+
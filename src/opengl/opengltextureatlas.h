@@ -0,0 +1,113 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_opengl_texture_atlas_h
+#define _farso_opengl_texture_atlas_h
+
+#include "../atlaspacker.h"
+#include "../rect.h"
+#include <SDL2/SDL_opengl.h>
+
+#include <vector>
+
+namespace Farso
+{
+
+/*! Default width and height of each OpenGLTextureAtlas page */
+#define FARSO_DEFAULT_ATLAS_PAGE_SIZE   2048
+
+class OpenGLWidgetRenderer;
+
+/*! Texture atlas shared by OpenGLWidgetRenderers: instead of a texture 
+ * for each renderer, their surfaces are packed as regions of a few big
+ * textures (pages), thus reducing texture binds and texture objects.
+ *
+ * When a region doesn't fit on any page, the pages are defragmented 
+ * (repacked with their current regions) before creating a new one. The
+ * renderers with moved regions are told to upload their whole surfaces
+ * again (all surfaces are kept on CPU memory anyway).
+ *
+ * \note must only be used from the rendering thread. */
+class OpenGLTextureAtlas
+{
+   public:
+      /*! Constructor 
+       * \param pageSize width and height of each page texture */
+      OpenGLTextureAtlas(int pageSize = FARSO_DEFAULT_ATLAS_PAGE_SIZE);
+      /*! Destructor */
+      ~OpenGLTextureAtlas();
+
+      /*! Allocate (or reallocate) a region for a renderer. On success, 
+       * OpenGLWidgetRenderer::setAtlasRegion is called with the region
+       * (for the renderer and for any other one moved to make room).
+       * \param owner renderer to allocate the region for
+       * \param width needed region width
+       * \param height needed region height
+       * \return false if can't allocate it (too big for a page), in which 
+       *         case the renderer should use its own texture. */
+      bool allocate(OpenGLWidgetRenderer* owner, int width, int height);
+
+      /*! Release the region of a renderer, if any */
+      void release(OpenGLWidgetRenderer* owner);
+
+      /*! \return width and height of each page */
+      const int getPageSize() const { return pageSize; };
+
+      /*! \return current number of pages */
+      const int getTotalPages() const { return (int) pages.size(); };
+
+   private:
+      /*! A region of a page, owned by a renderer */
+      struct Region
+      {
+         OpenGLWidgetRenderer* owner; /**< Renderer owning the region */
+         int width; /**< Requested width (without padding) */
+         int height; /**< Requested height (without padding) */
+         Rect area; /**< Area on the page (without padding) */
+      };
+
+      /*! A page: a texture with its packer and regions */
+      struct Page
+      {
+         GLuint texture; /**< Page texture */
+         AtlasPacker* packer; /**< Packer of its regions */
+         std::vector<Region> regions; /**< Regions on the page */
+      };
+
+      /*! Create a new, empty, page */
+      Page* createPage();
+
+      /*! Try to place a new region at a page.
+       * \param defrag if should repack the page if there's no space left
+       * \return if placed */
+      bool place(Page* page, OpenGLWidgetRenderer* owner, int width, 
+            int height, bool defrag);
+
+      /*! Remove an owner's region from a page. \return if found */
+      bool remove(Page* page, OpenGLWidgetRenderer* owner);
+
+      int pageSize; /**< Width and height of pages */
+      std::vector<Page*> pages; /**< Current pages */
+};
+
+}
+
+#endif
+
@@ -21,6 +21,9 @@
 #include "openglwidgetrenderer.h"
 #include "openglsurface.h"
 #include "opengldraw.h"
+#include "opengltextureatlas.h"
+#include "openglrenderer.h"
+#include "opengl3uploadring.h"
 #include "../controller.h"
 
 #include <kobold/platform.h>
@@ -34,14 +37,28 @@ using namespace Farso;
 /************************************************************************
  *                        OpenGLWidgetRenderer                          *
  ************************************************************************/
-OpenGLWidgetRenderer::OpenGLWidgetRenderer(int width, int height)
+OpenGLWidgetRenderer::OpenGLWidgetRenderer(int width, int height, 
+      OpenGLTextureAtlas* atlas)
                      :WidgetRenderer(width, height)
 {
    posX = 0;
    posY = 0;
    propX = 0.0f;
    propY = 0.0f;
-   glGenTextures(1, &texture);
+   textureWidth = 0;
+   textureHeight = 0;
+   texture = 0;
+   this->atlas = atlas;
+   useAtlas = (atlas != NULL);
+   atlasTexture = 0;
+   texX1 = 0.0f;
+   texY1 = 0.0f;
+   texScale = 0.0f;
+   uploadRing = NULL;
+   if(!useAtlas)
+   {
+      glGenTextures(1, &texture);
+   }
 }
 
 /************************************************************************
@@ -55,6 +72,20 @@ void OpenGLWidgetRenderer::createSurface()
    /* Calculate its max coordinate, as size may not equal (as powerOfTwo) */
    propX = (float) (width) / (float) this->realWidth;
    propY = (float) (height) / (float) this->realHeight;
+
+   if((atlas != NULL) && (!useAtlas))
+   {
+      /* Was too big for the atlas: with the new size, it may fit now. */
+      useAtlas = true;
+      if(texture != 0)
+      {
+         glDeleteTextures(1, &texture);
+         resetBoundTexture();
+         texture = 0;
+         textureWidth = 0;
+         textureHeight = 0;
+      }
+   }
 }
 
 /************************************************************************
@@ -62,7 +93,19 @@ void OpenGLWidgetRenderer::createSurface()
  ************************************************************************/
 OpenGLWidgetRenderer::~OpenGLWidgetRenderer()
 {
-   glDeleteTextures(1, &texture);
+   if(atlas != NULL)
+   {
+      atlas->release(this);
+   }
+   if(uploadRing != NULL)
+   {
+      delete uploadRing;
+   }
+   if(texture != 0)
+   {
+      glDeleteTextures(1, &texture);
+      resetBoundTexture();
+   }
    if(surface)
    {
       deleteSurface();
@@ -70,22 +113,144 @@ OpenGLWidgetRenderer::~OpenGLWidgetRenderer()
 }
 
 /************************************************************************
- *                           uploadSurface                              *
+ *                          doUploadSurface                             *
  ************************************************************************/
-void OpenGLWidgetRenderer::uploadSurface()
+size_t OpenGLWidgetRenderer::doUploadSurface(const std::list<Rect>& areas)
 {
+   if(useAtlas)
+   {
+      if((atlasArea.isDefined()) && (atlasArea.getWidth() >= width) &&
+         (atlasArea.getHeight() >= height))
+      {
+         bindTexture(atlasTexture, true);
+         return uploadAreas(areas, atlasArea.getX1(), atlasArea.getY1());
+      }
+
+      /* Need a (bigger) region, receiving the whole surface */
+      if(atlas->allocate(this, width, height))
+      {
+         std::list<Rect> all;
+         all.push_back(Rect(0, 0, width - 1, height - 1));
+         bindTexture(atlasTexture, true);
+         return uploadAreas(all, atlasArea.getX1(), atlasArea.getY1());
+      }
+
+      /* Too big to share an atlas page: must use its own texture */
+      useAtlas = false;
+      atlasArea = Rect();
+   }
+
    /* Retrieve SDL_Surface from our surface */
    SDL_Surface* sdlSurf = ((OpenGLSurface*) getSurface())->getSurface();
+   int bpp = sdlSurf->format->BytesPerPixel;
+
+   if(texture == 0)
+   {
+      glGenTextures(1, &texture);
+   }
+   bindTexture(texture, true);
+
+   if((textureWidth != sdlSurf->w) || (textureHeight != sdlSurf->h))
+   {
+      /* Texture storage not yet allocated (or surface was recreated with
+       * a new size): must (re)allocate it, with the whole surface. */
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sdlSurf->w, sdlSurf->h,
+            0, GL_RGBA, GL_UNSIGNED_BYTE, sdlSurf->pixels);
+
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+      textureWidth = sdlSurf->w;
+      textureHeight = sdlSurf->h;
+
+      return textureWidth * textureHeight * bpp;
+   }
+
+   /* Storage already allocated: just update the changed areas */
+   return uploadAreas(areas, 0, 0);
+}
+
+/************************************************************************
+ *                             uploadAreas                              *
+ ************************************************************************/
+size_t OpenGLWidgetRenderer::uploadAreas(const std::list<Rect>& areas, 
+      int x, int y)
+{
+   SDL_Surface* sdlSurf = ((OpenGLSurface*) getSurface())->getSurface();
+   int bpp = sdlSurf->format->BytesPerPixel;
+
+   OpenGLRenderer* renderer = static_cast<OpenGLRenderer*>(
+         Controller::getRenderer());
+   if(renderer->canStreamUploads())
+   {
+      /* Stream them through our ring, if any of its buffers is free */
+      if(uploadRing == NULL)
+      {
+         uploadRing = new OpenGL3UploadRing();
+      }
+      size_t streamed = uploadRing->upload(sdlSurf, areas, x, y);
+      if(streamed != 0)
+      {
+         return streamed;
+      }
+   }
 
-   /* Set the OpenGL texture */
-   glBindTexture(GL_TEXTURE_2D, texture);
-   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sdlSurf->w, sdlSurf->h,
-         0, GL_RGBA, GL_UNSIGNED_BYTE, sdlSurf->pixels);
+   /* Read from our surface with its full row length */
+   size_t bytes = 0;
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, sdlSurf->pitch / bpp);
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      const Rect& area = *it;
+      Uint8* pixels = (Uint8*) sdlSurf->pixels + 
+                      area.getY1() * sdlSurf->pitch + area.getX1() * bpp;
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x + area.getX1(), y + area.getY1(),
+            area.getWidth(), area.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE,
+            pixels);
 
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+      bytes += area.getWidth() * area.getHeight() * bpp;
+   }
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+   return bytes;
+}
+
+/************************************************************************
+ *                           setAtlasRegion                             *
+ ************************************************************************/
+void OpenGLWidgetRenderer::setAtlasRegion(GLuint texture, const Rect& area,
+      int pageSize, bool upload)
+{
+   atlasTexture = texture;
+   atlasArea = area;
+   texScale = 1.0f / pageSize;
+   texX1 = area.getX1() * texScale;
+   texY1 = area.getY1() * texScale;
+
+   if((upload) && (surface != NULL))
+   {
+      /* Moved to a new position: its previous contents are lost */
+      std::list<Rect> all;
+      all.push_back(Rect(0, 0, width - 1, height - 1));
+      bindTexture(atlasTexture, true);
+      FrameStats::count(FrameStats::COUNTER_BYTES_UPLOADED, 
+            uploadAreas(all, atlasArea.getX1(), atlasArea.getY1()));
+      markVisualChanged();
+   }
+}
+
+/************************************************************************
+ *                             bindTexture                              *
+ ************************************************************************/
+void OpenGLWidgetRenderer::bindTexture(GLuint texture, bool force)
+{
+   if((force) || (texture != boundTexture))
+   {
+      glBindTexture(GL_TEXTURE_2D, texture);
+      boundTexture = texture;
+   }
 }
 
 /************************************************************************
@@ -116,28 +281,64 @@ void OpenGLWidgetRenderer::doShow()
  ************************************************************************/
 void OpenGLWidgetRenderer::doRender()
 {
+   if((useAtlas) && (!atlasArea.isDefined()))
+   {
+      /* Not yet uploaded */
+      return;
+   }
+
+   /* Texture coordinates of our surface */
+   float u1 = 0.0f, v1 = 0.0f, u2 = propX, v2 = propY;
+   GLuint tex = texture;
+   if(useAtlas)
+   {
+      tex = atlasTexture;
+      u1 = texX1;
+      v1 = texY1;
+      u2 = texX1 + width * texScale;
+      v2 = texY1 + height * texScale;
+   }
+
+   OpenGLCompositor* compositor = static_cast<OpenGLRenderer*>(
+         Controller::getRenderer())->getCompositor();
+   if(compositor != NULL)
+   {
+      /* Just batch it, to draw all at once */
+      compositor->addQuad(tex, posX, posY, posX + width, posY + height,
+            u1, v1, u2, v2);
+      return;
+   }
+
    glEnable(GL_BLEND);
-   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+   if(Controller::isPremultipliedAlpha())
+   {
+      glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+   }
+   else
+   {
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+   }
    glDisable(GL_DEPTH_TEST);
 
    glEnable(GL_TEXTURE_2D);
-   glBindTexture(GL_TEXTURE_2D, texture);
+   bindTexture(tex);
 
    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
    glPushMatrix();
       glTranslatef(posX, posY, 0.0f);
       glBegin(GL_QUADS);
-         glTexCoord2f(0.0f, propY);
+         glTexCoord2f(u1, v2);
          glVertex3f(0.0f, 0.0f, 0.0f);
-         glTexCoord2f(0.0f, 0.0f);
+         glTexCoord2f(u1, v1);
          glVertex3f(0.0f, height, 0.0f);
-         glTexCoord2f(propX, 0.0f);
+         glTexCoord2f(u2, v1);
          glVertex3f(width, height, 0.0f);
-         glTexCoord2f(propX, propY);
+         glTexCoord2f(u2, v2);
          glVertex3f(width, 0.0f, 0.0f);
       glEnd();
    glPopMatrix();
+   FrameStats::count(FrameStats::COUNTER_DRAW_CALLS);
 
    glDisable(GL_TEXTURE_2D);
 
@@ -145,4 +346,8 @@ void OpenGLWidgetRenderer::doRender()
    glDisable(GL_BLEND);
 }
 
+/************************************************************************
+ *                               Static                                 *
+ ************************************************************************/
+GLuint OpenGLWidgetRenderer::boundTexture = 0;
 
@@ -27,18 +27,48 @@
 namespace Farso
 {
 
+class OpenGLTextureAtlas;
+class OpenGL3UploadRing;
+
 /*! The WidgetRenderer for OpenGL/SDL */
 class OpenGLWidgetRenderer: public WidgetRenderer
 {
    public:
-      OpenGLWidgetRenderer(int width, int height); 
+      /*! Constructor
+       * \param width renderer width 
+       * \param height renderer height
+       * \param atlas texture atlas to place the renderer's surface at, or
+       *        NULL to use its own texture. */
+      OpenGLWidgetRenderer(int width, int height, 
+            OpenGLTextureAtlas* atlas = NULL); 
       ~OpenGLWidgetRenderer();
 
-      void uploadSurface();
 
       /* not used.  */
       void setRenderQueueSubGroup(int renderQueueId){};
 
+      /*! Define the atlas region used by the renderer. Called by its
+       * OpenGLTextureAtlas when allocating or moving the region.
+       * \param texture atlas page texture
+       * \param area region on the page
+       * \param pageSize width and height of the page
+       * \param upload if should upload the whole surface to it (ie: the 
+       *        region was moved). */
+      void setAtlasRegion(GLuint texture, const Rect& area, int pageSize,
+            bool upload);
+
+      /*! Bind a texture, if not already the bound one
+       * \param texture texture to bind
+       * \param force if should bind it even if it is believed to be the
+       *        bound one. Uploads must use it, as they could happen out of
+       *        a frame (for example, when setting the cursor), after the
+       *        application bound its own textures. */
+      static void bindTexture(GLuint texture, bool force = false);
+
+      /*! Forget the last bound texture (for example, when the 
+       * application could have bound another one). */
+      static void resetBoundTexture() { boundTexture = 0; };
+
    protected:
       
       void createSurface();
@@ -46,14 +76,36 @@ class OpenGLWidgetRenderer: public WidgetRenderer
       void doHide();
       void doShow();
       void doRender();
+      size_t doUploadSurface(const std::list<Rect>& areas);
 
    private:
+      /*! Upload areas of the surface to the bound texture, streaming
+       * them through our ring when possible.
+       * \param x offset of the surface on the texture
+       * \param y offset of the surface on the texture
+       * \return bytes uploaded */
+      size_t uploadAreas(const std::list<Rect>& areas, int x, int y);
+
 
       int posX;        /**< current X position on screen */
       int posY;        /**< current Y position on screen */
       GLuint texture;  /**< GL texture for the renderer */
+      int textureWidth;  /**< Width of the allocated texture storage */
+      int textureHeight; /**< Height of the allocated texture storage */
       float propX;     /**< Proportional texture coordinate */
       float propY;     /**< Proportional texture coordinate */
+
+      OpenGLTextureAtlas* atlas; /**< Atlas used, if any */
+      bool useAtlas; /**< If currently at the atlas (false when too big) */
+      GLuint atlasTexture; /**< Atlas page texture with our region */
+      Rect atlasArea; /**< Our region at the atlas page */
+      float texX1; /**< Left texture coordinate when using the atlas */
+      float texY1; /**< Top texture coordinate when using the atlas */
+      float texScale; /**< 1 / atlas page size */
+
+      OpenGL3UploadRing* uploadRing; /**< Ring to stream uploads, if any */
+
+      static GLuint boundTexture; /**< Last bound texture */
 };
 
 }
@@ -0,0 +1,669 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_pixel_writer_h
+#define _farso_pixel_writer_h
+
+#include "farsoconfig.h"
+#include "colors.h"
+#include "rect.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Farso
+{
+
+/*! How a color is packed into a pixel, for non palettized formats 
+ * (the same as SDL_PixelFormat masks, shifts and losses). */
+struct PixelPacking
+{
+   Uint32 redMask; /**< Red bits mask */
+   Uint32 greenMask; /**< Green bits mask */
+   Uint32 blueMask; /**< Blue bits mask */
+   Uint32 alphaMask; /**< Alpha bits mask (0 if no alpha) */
+   Uint8 redShift; /**< Red left shift */
+   Uint8 greenShift; /**< Green left shift */
+   Uint8 blueShift; /**< Blue left shift */
+   Uint8 alphaShift; /**< Alpha left shift */
+   Uint8 redLoss; /**< Red bits lost */
+   Uint8 greenLoss; /**< Green bits lost */
+   Uint8 blueLoss; /**< Blue bits lost */
+   Uint8 alphaLoss; /**< Alpha bits lost */
+
+   /*! \return the color packed as a pixel value */
+   Uint32 pack(Uint8 r, Uint8 g, Uint8 b, Uint8 a) const
+   {
+      return (((((Uint32) r) >> redLoss) << redShift) & redMask) |
+             (((((Uint32) g) >> greenLoss) << greenShift) & greenMask) |
+             (((((Uint32) b) >> blueLoss) << blueShift) & blueMask) |
+             (((((Uint32) a) >> alphaLoss) << alphaShift) & alphaMask);
+   };
+
+   /*! Get the color of a pixel value (opaque if no alpha) */
+   void unpack(Uint32 pixel, Uint8& r, Uint8& g, Uint8& b, Uint8& a) const
+   {
+      r = (Uint8) (((pixel & redMask) >> redShift) << redLoss);
+      g = (Uint8) (((pixel & greenMask) >> greenShift) << greenLoss);
+      b = (Uint8) (((pixel & blueMask) >> blueShift) << blueLoss);
+      a = (alphaMask != 0) ? 
+          (Uint8) (((pixel & alphaMask) >> alphaShift) << alphaLoss) : 255;
+   };
+};
+
+/*! Writes pixels of a single color (mapped once, at constructor) 
+ * directly to a surface buffer with Bpp bytes per pixel, clipping them 
+ * to a rectangle. Used by PrimitiveRaster. */
+template<int Bpp> class PackedPixelWriter
+{
+   public:
+      /*! Constructor 
+       * \param pixels pixels of the surface, already locked
+       * \param pitch bytes per surface line
+       * \param bounds rectangle to write to (the surface area already 
+       *        intersected with the clip rectangle) or undefined to 
+       *        write nothing.
+       * \param packing how to pack colors into pixels
+       * \param color color to write (already premultiplied, if so)
+       * \param premultiplied if the surface is in premultiplied alpha */
+      PackedPixelWriter(Uint8* pixels, int pitch, const Rect& bounds,
+            const PixelPacking& packing, const Color& color, 
+            bool premultiplied = false)
+         : packing(packing), color(color)
+      {
+         this->premultiplied = premultiplied;
+         Uint32 one = 1;
+         this->pixels = pixels;
+         this->pitch = pitch;
+         this->bigEndian = (*((Uint8*) &one) == 0);
+         this->pixel = packing.pack(color.red, color.green, color.blue, 
+               color.alpha);
+         if(bounds.isDefined())
+         {
+            x1 = bounds.getX1();
+            y1 = bounds.getY1();
+            x2 = bounds.getX2();
+            y2 = bounds.getY2();
+         }
+         else
+         {
+            x1 = y1 = 0;
+            x2 = y2 = -1;
+         }
+      };
+
+      /*! Set a pixel with the color */
+      void setPixel(int x, int y)
+      {
+         if(isInner(x, y))
+         {
+            write(at(x, y), pixel);
+         }
+      };
+
+      /*! Set a pixel with the color multiplied by a bright factor 
+       * (clamped to [0.1, 1.0]), for antialiased lines */
+      void setPixel(int x, int y, float bright)
+      {
+         if(isInner(x, y))
+         {
+            float factor = (bright < 0.1f) ? 0.1f : 
+                           (bright > 1.0f) ? 1.0f : bright;
+            write(at(x, y), packing.pack(color.red * factor, 
+                     color.green * factor, color.blue * factor, 
+                     color.alpha));
+         }
+      };
+
+      /*! Blend the color, its alpha multiplied by a coverage (0 to 255),
+       * over a pixel (as Draw::blendColor), for antialiased edges of 
+       * filled primitives. Full coverage just sets it, as the spans do. */
+      void coverPixel(int x, int y, Uint8 coverage)
+      {
+         if(!isInner(x, y))
+         {
+            return;
+         }
+         Uint8* p = at(x, y);
+         if(coverage == 255)
+         {
+            write(p, pixel);
+            return;
+         }
+
+         Uint8 tr, tg, tb, ta;
+         packing.unpack(read(p), tr, tg, tb, ta);
+         int sa = (color.alpha * coverage + 127) / 255;
+         if(premultiplied)
+         {
+            /* Source (color * coverage) over target */
+            tr = ((color.red * coverage + 127) / 255) + tr * (255 - sa) / 255;
+            tg = ((color.green * coverage + 127) / 255) + 
+                 tg * (255 - sa) / 255;
+            tb = ((color.blue * coverage + 127) / 255) + tb * (255 - sa) / 255;
+            ta = sa + ta * (255 - sa) / 255;
+         }
+         else if(ta == 0)
+         {
+            /* Nothing under it: just the source */
+            tr = color.red;
+            tg = color.green;
+            tb = color.blue;
+            ta = sa;
+         }
+         else
+         {
+            tr = (color.red * sa + tr * (255 - sa)) / 255;
+            tg = (color.green * sa + tg * (255 - sa)) / 255;
+            tb = (color.blue * sa + tb * (255 - sa)) / 255;
+            ta = sa + ta * (255 - sa) / 255;
+         }
+         write(p, packing.pack(tr, tg, tb, ta));
+      };
+
+      /*! Set all pixels of the horizontal span [x1, x2] at line y */
+      void hSpan(int sx1, int sx2, int y)
+      {
+         if(sx1 > sx2)
+         {
+            std::swap(sx1, sx2);
+         }
+         if((y < y1) || (y > y2))
+         {
+            return;
+         }
+         sx1 = (sx1 < x1) ? x1 : sx1;
+         sx2 = (sx2 > x2) ? x2 : sx2;
+         if(sx1 <= sx2)
+         {
+            fill(at(sx1, y), sx2 - sx1 + 1);
+         }
+      };
+
+      /*! Set all pixels of the vertical span [y1, y2] at column x */
+      void vSpan(int x, int sy1, int sy2)
+      {
+         if(sy1 > sy2)
+         {
+            std::swap(sy1, sy2);
+         }
+         if((x < x1) || (x > x2))
+         {
+            return;
+         }
+         sy1 = (sy1 < y1) ? y1 : sy1;
+         sy2 = (sy2 > y2) ? y2 : sy2;
+         Uint8* p = at(x, sy1);
+         for(int y = sy1; y <= sy2; y++)
+         {
+            write(p, pixel);
+            p += pitch;
+         }
+      };
+
+   private:
+      /*! \return if the pixel is inside the bounds */
+      bool isInner(int x, int y) const
+      {
+         return (x >= x1) && (x <= x2) && (y >= y1) && (y <= y2);
+      };
+
+      /*! \return address of the pixel */
+      Uint8* at(int x, int y) const
+      {
+         return pixels + y * pitch + x * Bpp;
+      };
+
+      /*! \return a pixel value */
+      Uint32 read(const Uint8* p) const
+      {
+         switch(Bpp)
+         {
+            case 1:
+               return *p;
+            case 2:
+               return *((const Uint16*) p);
+            case 3:
+               if(bigEndian)
+               {
+                  return (p[0] << 16) | (p[1] << 8) | p[2];
+               }
+               return p[0] | (p[1] << 8) | (p[2] << 16);
+            case 4:
+               return *((const Uint32*) p);
+         }
+         return 0;
+      };
+
+      /*! Write a pixel value */
+      void write(Uint8* p, Uint32 value) const
+      {
+         switch(Bpp)
+         {
+            case 1:
+               *p = (Uint8) value;
+            break;
+            case 2:
+               *((Uint16*) p) = (Uint16) value;
+            break;
+            case 3:
+               if(bigEndian)
+               {
+                  p[0] = (value >> 16) & 0xff;
+                  p[1] = (value >> 8) & 0xff;
+                  p[2] = value & 0xff;
+               }
+               else
+               {
+                  p[0] = value & 0xff;
+                  p[1] = (value >> 8) & 0xff;
+                  p[2] = (value >> 16) & 0xff;
+               }
+            break;
+            case 4:
+               *((Uint32*) p) = value;
+            break;
+         }
+      };
+
+      /*! Fill count pixels, starting at p, with the color */
+      void fill(Uint8* p, int count) const
+      {
+         /* Check if all bytes of the pixel, as written, are the same */
+         Uint32 written = 0;
+         Uint8* bytes = (Uint8*) &written;
+         write(bytes, pixel);
+         bool sameBytes = true;
+         for(int b = 1; b < Bpp; b++)
+         {
+            sameBytes &= (bytes[b] == bytes[0]);
+         }
+
+         if(sameBytes)
+         {
+            /* Usually black, white or transparent */
+            memset(p, bytes[0], count * Bpp);
+         }
+         else if(Bpp == 4)
+         {
+            std::fill((Uint32*) p, ((Uint32*) p) + count, pixel);
+         }
+         else if(Bpp == 2)
+         {
+            std::fill((Uint16*) p, ((Uint16*) p) + count, (Uint16) pixel);
+         }
+         else
+         {
+            for(int i = 0; i < count; i++)
+            {
+               write(p, pixel);
+               p += Bpp;
+            }
+         }
+      };
+
+      Uint8* pixels; /**< Surface pixels */
+      int pitch; /**< Bytes per surface line */
+      int x1; /**< Left bound */
+      int y1; /**< Top bound */
+      int x2; /**< Right bound */
+      int y2; /**< Bottom bound */
+      bool bigEndian; /**< If running on a big endian machine */
+      bool premultiplied; /**< If the surface is premultiplied */
+      PixelPacking packing; /**< How to pack colors */
+      Color color; /**< Color to write */
+      Uint32 pixel; /**< Color packed as a pixel */
+};
+
+/*! The rasterization algorithms of Draw primitives, specialized at 
+ * compile time for a pixel writer (with setPixel(x, y), 
+ * setPixel(x, y, bright), coverPixel(x, y, coverage), hSpan(x1, x2, y) 
+ * and vSpan(x, y1, y2)). Filled primitives are done by integer 
+ * scanlines, emitting horizontal spans. */
+template<class Writer> class PrimitiveRaster
+{
+   public:
+      /*! Rasterize a line */
+      static void line(Writer& w, int x1, int y1, int x2, int y2)
+      {
+         /* Horizontal and vertical lines are just spans (with their
+          * coordinates rounded as the DDA below does them) */
+         if(y1 == y2)
+         {
+            w.hSpan(round(x1), round(x2), round(y1));
+            return;
+         }
+         if(x1 == x2)
+         {
+            w.vSpan(round(x1), round(y1), round(y2));
+            return;
+         }
+
+         /* Define deltas (width and height) */
+         int dx = x2 - x1;
+         int dy = y2 - y1;
+         int steps, k;
+         float xInc, yInc, x = x1, y = y1;
+
+         /* Define needed steps */
+         if(abs(dx) > abs(dy))
+         {
+            steps = abs(dx);
+         }
+         else
+         {
+            steps = abs(dy);
+         }
+
+         /* Let's iterate and set each line pixel */
+         xInc = (float) (dx) / (float) (steps);
+         yInc = (float) (dy) / (float) (steps);
+
+         w.setPixel(round(x), round(y));
+         for(k = 0; k < steps; k++)
+         {
+            x += xInc;
+            y += yInc;
+            w.setPixel(round(x), round(y));
+         }
+      };
+
+      /*! Rasterize an antialiased line */
+      static void antiAliasedLine(Writer& w, int x1, int y1, int x2, int y2)
+      {
+         float dx = (float)x2 - (float)x1;
+         float dy = (float)y2 - (float)y1;
+         if( fabsf(dx) > fabsf(dy) ) 
+         {
+            if ( x2 < x1 ) 
+            {
+               std::swap(x1, x2);
+               std::swap(y1, y2);
+            }
+            float gradient = dy / dx;
+            float xend = round((float) x1);
+            float yend = y1 + gradient*(xend - x1);
+            float xgap = rfpart(x1 + 0.5f);
+            int xpxl1 = xend;
+            int ypxl1 = (int)(yend);
+            w.setPixel(xpxl1, ypxl1, rfpart(yend)*xgap);
+            w.setPixel(xpxl1, ypxl1+1, fpart(yend)*xgap);
+            float intery = yend + gradient;
+
+            xend = round((float)x2);
+            yend = y2 + gradient*(xend - x2);
+            xgap = fpart(x2 + 0.5f);
+            int xpxl2 = xend;
+            int ypxl2 = (int)(yend);
+            w.setPixel(xpxl2, ypxl2, rfpart(yend) * xgap);
+            w.setPixel(xpxl2, ypxl2 + 1, fpart(yend) * xgap);
+
+            for(int x = xpxl1 + 1; x <= (xpxl2 - 1); x++) 
+            {
+               w.setPixel(x, (int)(intery), rfpart(intery));
+               w.setPixel(x, (int)(intery) + 1, fpart(intery));
+               intery += gradient;
+            }
+         } 
+         else 
+         {
+            if ( y2 < y1 ) 
+            {
+               std::swap(x1, x2);
+               std::swap(y1, y2);
+            }
+            float gradient = dx / dy;
+            float yend = round((float) y1);
+            float xend = x1 + gradient * (yend - y1);
+            float ygap = rfpart(y1 + 0.5f);
+            int ypxl1 = yend;
+            int xpxl1 = (int)(xend);
+            w.setPixel(xpxl1, ypxl1, rfpart(xend)*ygap);
+            w.setPixel(xpxl1, ypxl1+1, fpart(xend)*ygap);
+            float interx = xend + gradient;
+
+            yend = round((float)y2);
+            xend = x2 + gradient*(yend - y2);
+            ygap = fpart(y2+0.5);
+            int ypxl2 = yend;
+            int xpxl2 = (int)(xend);
+            w.setPixel(xpxl2, ypxl2, rfpart(xend) * ygap);
+            w.setPixel(xpxl2, ypxl2 + 1, fpart(xend) * ygap);
+
+            for(int y = ypxl1 + 1; y <= (ypxl2 - 1); y++) 
+            {
+               w.setPixel((int)(interx), y, rfpart(interx));
+               w.setPixel((int)(interx) + 1, y, fpart(interx));
+               interx += gradient;
+            }
+         }
+      };
+
+      /*! Rasterize a circle */
+      static void circle(Writer& w, int xC, int yC, int r)
+      {
+         int x=0, y=r,u=1,v=2*r-1,E=0;
+         while(x < y)
+         {
+            w.setPixel(xC+x, yC+y);
+            w.setPixel(xC+y, yC-x);
+            w.setPixel(xC-x, yC-y);
+            w.setPixel(xC-y, yC+x);
+            x++; E+= u; u+=2;
+            if (v < 2 * E)
+            {
+               y--;
+               E -= v;
+               v -= 2;
+            }
+            /* Must check if not done. */
+            if (x > y)
+            {
+               break;
+            }
+            w.setPixel(xC+y, yC+x);
+            w.setPixel(xC+x, yC-y);
+            w.setPixel(xC-y, yC-x);
+            w.setPixel(xC-x, yC+y);
+         }
+      };
+
+      /*! Rasterize a filled triangle, by scanlines: each line is filled
+       * between the leftmost and the rightmost x (rounded inwards) where
+       * the triangle edges cross it. */
+      static void filledTriangle(Writer& w, int x1, int y1, int x2, int y2,
+            int x3, int y3)
+      {
+         int xs[3] = {x1, x2, x3};
+         int ys[3] = {y1, y2, y3};
+         int top = std::min(y1, std::min(y2, y3));
+         int bottom = std::max(y1, std::max(y2, y3));
+
+         for(int y = top; y <= bottom; y++)
+         {
+            bool crossed = false;
+            int left = 0, right = 0;
+            for(int e = 0; e < 3; e++)
+            {
+               /* Edge from a to b, with ya <= yb */
+               int xa = xs[e], ya = ys[e];
+               int xb = xs[(e + 1) % 3], yb = ys[(e + 1) % 3];
+               if(ya > yb)
+               {
+                  std::swap(xa, xb);
+                  std::swap(ya, yb);
+               }
+               if((y < ya) || (y > yb))
+               {
+                  continue;
+               }
+
+               int eLeft, eRight;
+               if(ya == yb)
+               {
+                  /* Horizontal edge: all of it is at the line */
+                  eLeft = std::min(xa, xb);
+                  eRight = std::max(xa, xb);
+               }
+               else
+               {
+                  /* x = xa + (y - ya) * (xb - xa) / (yb - ya) */
+                  int num = (y - ya) * (xb - xa);
+                  int den = yb - ya;
+                  eLeft = xa + ceilDiv(num, den);
+                  eRight = xa + floorDiv(num, den);
+               }
+               left = (crossed) ? std::min(left, eLeft) : eLeft;
+               right = (crossed) ? std::max(right, eRight) : eRight;
+               crossed = true;
+            }
+            if((crossed) && (left <= right))
+            {
+               w.hSpan(left, right, y);
+            }
+         }
+      };
+
+      /*! Rasterize a filled circle: each line from its center has the 
+       * pixels (x, dy) with x^2 + dy^2 <= r^2 + r (ie: with distance to 
+       * the center up to r + 0.5). */
+      static void filledCircle(Writer& w, int xC, int yC, int r)
+      {
+         if(r < 0)
+         {
+            return;
+         }
+         int x = r;
+         for(int dy = 0; dy <= r; dy++)
+         {
+            x = arcHalfWidth(x, dy, r);
+            w.hSpan(xC - x, xC + x, yC - dy);
+            if(dy != 0)
+            {
+               w.hSpan(xC - x, xC + x, yC + dy);
+            }
+         }
+      };
+
+      /*! Rasterize a filled rectangle with rounded corners of radius r.
+       * \param antiAliased if corner edge pixels should have their alpha
+       *        multiplied by how much of them is inside the corner arc. */
+      static void filledRoundedRectangle(Writer& w, int x1, int y1, 
+            int x2, int y2, int r, bool antiAliased)
+      {
+         if(x1 > x2)
+         {
+            std::swap(x1, x2);
+         }
+         if(y1 > y2)
+         {
+            std::swap(y1, y2);
+         }
+         r = std::max(0, std::min(r, std::min((x2 - x1) / 2, 
+                     (y2 - y1) / 2)));
+
+         /* Lines between corners are just spans */
+         for(int y = y1 + r; y <= y2 - r; y++)
+         {
+            w.hSpan(x1, x2, y);
+         }
+
+         /* Corner lines, at dy from their arcs centers */
+         int cx1 = x1 + r;
+         int cx2 = x2 - r;
+         int x = r;
+         for(int dy = 1; dy <= r; dy++)
+         {
+            int top = y1 + r - dy;
+            int bottom = y2 - r + dy;
+            if(!antiAliased)
+            {
+               x = arcHalfWidth(x, dy, r);
+            }
+            else
+            {
+               /* Pixels partially inside the arc get coverage by 
+                * their center distance to it. */
+               for(x = r; x > 0; x--)
+               {
+                  float coverage = r + 1.0f - sqrtf(x * x + dy * dy);
+                  if(coverage >= 1.0f)
+                  {
+                     break;
+                  }
+                  else if(coverage > 0.0f)
+                  {
+                     Uint8 c = (Uint8) (coverage * 255.0f + 0.5f);
+                     w.coverPixel(cx1 - x, top, c);
+                     w.coverPixel(cx2 + x, top, c);
+                     w.coverPixel(cx1 - x, bottom, c);
+                     w.coverPixel(cx2 + x, bottom, c);
+                  }
+               }
+            }
+            w.hSpan(cx1 - x, cx2 + x, top);
+            w.hSpan(cx1 - x, cx2 + x, bottom);
+         }
+      };
+
+   private:
+      /*! \return a rounded to nearest integer (for positive values) */
+      static int round(const float a)
+      {
+         return (int)(a+0.5);
+      };
+      /*! \return fractional part of a */
+      static float fpart(const float a)
+      {
+         return a - (int)(a);
+      };
+      /*! \return 1 - fractional part of a */
+      static float rfpart(const float a)
+      {
+         return 1 - fpart(a);
+      };
+      /*! \return num / den, rounded down (den must be positive) */
+      static int floorDiv(int num, int den)
+      {
+         return (num >= 0) ? num / den : -((den - 1 - num) / den);
+      };
+      /*! \return num / den, rounded up (den must be positive) */
+      static int ceilDiv(int num, int den)
+      {
+         return -floorDiv(-num, den);
+      };
+      /*! \return half width of a r radius arc at dy from its center, 
+       * decreasing from the previous line half width x. */
+      static int arcHalfWidth(int x, int dy, int r)
+      {
+         while((x > 0) && (x * x + dy * dy > r * r + r))
+         {
+            x--;
+         }
+         return x;
+      };
+};
+
+}
+
+#endif
+
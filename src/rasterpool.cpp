@@ -0,0 +1,142 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "rasterpool.h"
+#include "widget.h"
+
+#include <assert.h>
+
+using namespace Farso;
+
+/***********************************************************************
+ *                              RasterPool                             *
+ ***********************************************************************/
+RasterPool::RasterPool(int totalThreads)
+{
+   jobs = NULL;
+   nextJob = 0;
+   doneJobs = 0;
+   generation = 0;
+   quitting = false;
+
+   if(totalThreads > FARSO_RASTER_MAX_THREADS)
+   {
+      totalThreads = FARSO_RASTER_MAX_THREADS;
+   }
+   for(int i = 0; i < totalThreads; i++)
+   {
+      threads.push_back(std::thread(&RasterPool::workerLoop, this, i + 1));
+   }
+}
+
+/***********************************************************************
+ *                             ~RasterPool                             *
+ ***********************************************************************/
+RasterPool::~RasterPool()
+{
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      quitting = true;
+   }
+   wakeUp.notify_all();
+
+   for(size_t i = 0; i < threads.size(); i++)
+   {
+      threads[i].join();
+   }
+   threads.clear();
+}
+
+/***********************************************************************
+ *                           rasterizePending                          *
+ ***********************************************************************/
+void RasterPool::rasterizePending(std::unique_lock<std::mutex>& lock)
+{
+   while((jobs != NULL) && (nextJob < jobs->size()))
+   {
+      Widget* widget = (*jobs)[nextJob];
+      nextJob++;
+
+      lock.unlock();
+      widget->rasterize();
+      lock.lock();
+
+      doneJobs++;
+      if(doneJobs == jobs->size())
+      {
+         done.notify_all();
+      }
+   }
+}
+
+/***********************************************************************
+ *                              workerLoop                             *
+ ***********************************************************************/
+void RasterPool::workerLoop(int slot)
+{
+   currentSlot = slot;
+   unsigned int lastGeneration = 0;
+
+   std::unique_lock<std::mutex> lock(mutex);
+   while(!quitting)
+   {
+      if(generation != lastGeneration)
+      {
+         lastGeneration = generation;
+         rasterizePending(lock);
+      }
+      else
+      {
+         wakeUp.wait(lock);
+      }
+   }
+}
+
+/***********************************************************************
+ *                              rasterize                              *
+ ***********************************************************************/
+void RasterPool::rasterize(std::vector<Widget*>& widgets)
+{
+   assert(currentSlot == 0);
+
+   if(widgets.empty())
+   {
+      return;
+   }
+
+   std::unique_lock<std::mutex> lock(mutex);
+   jobs = &widgets;
+   nextJob = 0;
+   doneJobs = 0;
+   generation++;
+   wakeUp.notify_all();
+
+   /* Let's work too, while waiting the workers */
+   rasterizePending(lock);
+   while(doneJobs < widgets.size())
+   {
+      done.wait(lock);
+   }
+
+   jobs = NULL;
+}
+
+thread_local int RasterPool::currentSlot = 0;
+
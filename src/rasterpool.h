@@ -0,0 +1,95 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_raster_pool_h
+#define _farso_raster_pool_h
+
+#include "farsoconfig.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Farso
+{
+
+class Widget;
+
+/*! Maximum number of worker threads of a RasterPool */
+#define FARSO_RASTER_MAX_THREADS    8
+
+/*! A pool of threads used to rasterize independent root widgets (each one
+ * with its own WidgetRenderer surface) at the same time.
+ * \note The calling thread also rasterizes, and is always identified by
+ *       slot 0. Each worker thread has its own slot, from 1 to 
+ *       FARSO_RASTER_MAX_THREADS, which is used to keep per-thread state
+ *       (for example, Font's current size and glyph caches). */
+class RasterPool
+{
+   public:
+      /*! Constructor
+       * \param totalThreads number of worker threads to create (besides 
+       *        the caller's one). Limited to FARSO_RASTER_MAX_THREADS. */
+      RasterPool(int totalThreads);
+      /*! Destructor. Will wait the threads to finish. */
+      ~RasterPool();
+
+      /*! Rasterize the widgets, distributing them between the caller's
+       * and the worker threads, returning only when all are done.
+       * \param widgets vector with widgets (owning their renderers and with
+       *        already created surfaces) to rasterize.
+       * \note Each widget must be followed by a call to its finishDraw,
+       *       at the rendering thread. */
+      void rasterize(std::vector<Widget*>& widgets);
+
+      /*! \return number of worker threads */
+      const int getTotalThreads() const { return (int) threads.size(); };
+
+      /*! \return slot of the current thread (0 for any thread outside the
+       *          pool, 1 to FARSO_RASTER_MAX_THREADS for the workers). */
+      static const int getCurrentSlot() { return currentSlot; };
+
+   private:
+      /*! Main loop of each worker thread */
+      void workerLoop(int slot);
+
+      /*! Rasterize pending widgets, until none left to get.
+       * \note mutex must be locked by the caller. */
+      void rasterizePending(std::unique_lock<std::mutex>& lock);
+
+      std::vector<std::thread> threads; /**< The worker threads */
+      std::mutex mutex; /**< Mutex for accessing the jobs */
+      std::condition_variable wakeUp; /**< To wake up the workers */
+      std::condition_variable done; /**< To notify done jobs */
+
+      std::vector<Widget*>* jobs; /**< Current widgets to rasterize */
+      size_t nextJob; /**< Next job to get */
+      size_t doneJobs; /**< Number of done jobs */
+      unsigned int generation; /**< Current rasterize call generation */
+      bool quitting; /**< If threads should quit */
+
+      static thread_local int currentSlot; /**< Slot of current thread */
+};
+
+}
+
+#endif
+
@@ -54,6 +54,47 @@ const bool Rect::isInner(int x, int y) const
    return (x >= x1) && (x <= x2) && (y >= y1) && (y <= y2);
 }
 
+/***********************************************************************
+ *                              intersects                             *
+ ***********************************************************************/
+const bool Rect::intersects(const Rect& r) const
+{
+   return (defined) && (r.defined) && (x1 <= x2) && (y1 <= y2) &&
+          (r.x1 <= r.x2) && (r.y1 <= r.y2) && (x1 <= r.x2) && (r.x1 <= x2) && (y1 <= r.y2) && (r.y1 <= y2);
+}
+
+/***********************************************************************
+ *                            getIntersection                          *
+ ***********************************************************************/
+Rect Rect::getIntersection(const Rect& r) const
+{
+   if(!intersects(r))
+   {
+      return Rect();
+   }
+
+   return Rect((x1 > r.x1) ? x1 : r.x1, (y1 > r.y1) ? y1 : r.y1,
+               (x2 < r.x2) ? x2 : r.x2, (y2 < r.y2) ? y2 : r.y2);
+}
+
+/***********************************************************************
+ *                               getUnion                              *
+ ***********************************************************************/
+Rect Rect::getUnion(const Rect& r) const
+{
+   if(!r.defined)
+   {
+      return *this;
+   }
+   if(!defined)
+   {
+      return r;
+   }
+
+   return Rect((x1 < r.x1) ? x1 : r.x1, (y1 < r.y1) ? y1 : r.y1,
+               (x2 > r.x2) ? x2 : r.x2, (y2 > r.y2) ? y2 : r.y2);
+}
+
 /***********************************************************************
  *                                   set                               *
  ***********************************************************************/
@@ -51,6 +51,17 @@ class Rect
       /*! Verify if point x,y is inner the rectangle */
       const bool isInner(int x, int y) const;
 
+      /*! Verify if this rectangle has any area in common with another one.
+       * \param r the other rectangle to check with. */
+      const bool intersects(const Rect& r) const;
+
+      /*! \return rectangle with the area common to this and r.
+       * \note will be undefined if they have no common area. */
+      Rect getIntersection(const Rect& r) const;
+
+      /*! \return smallest rectangle that contains both this and r. */
+      Rect getUnion(const Rect& r) const;
+
       /*! Set rectangle coordinates */
       void set(int x1, int y1, int x2, int y2);
 
@@ -42,6 +42,23 @@ Renderer::~Renderer()
    }
 }
 
+/****************************************************************************
+ *                               createSurface                              *
+ ****************************************************************************/
+Surface* Renderer::createSurface(const Kobold::String& name, 
+      int width, int height)
+{
+   return NULL;
+}
+
+/****************************************************************************
+ *                         supportsPremultipliedAlpha                       *
+ ****************************************************************************/
+bool Renderer::supportsPremultipliedAlpha()
+{
+   return true;
+}
+
 
 }
 
@@ -63,6 +63,23 @@ class Renderer
        * more needed. */
       virtual Surface* loadImageToSurface(const Kobold::String& filename) = 0;
 
+      /*! Create a new drawable surface, only for CPU side use (ie: as 
+       * source of Draw::doStampFill calls, never uploaded to a texture).
+       * \param name surface name (must be unique)
+       * \param width surface width
+       * \param height surface height
+       * \return pointer to the created surface, or NULL if not supported
+       *         by the renderer. 
+       * \note The caller is responsible to delete the surface when no 
+       * more needed. */
+      virtual Surface* createSurface(const Kobold::String& name, 
+            int width, int height);
+
+      /*! \return if the renderer can compose premultiplied alpha surfaces
+       *          over its target. Checked once by Controller::init, which
+       *          falls back to straight alpha when not supported. */
+      virtual bool supportsPremultipliedAlpha();
+
    protected:
       Draw* draw; /**< Draw to use */
 };
@@ -48,7 +48,8 @@ void SDLDraw::setPixel(Surface* surface, int x, int y,
    int bpp = sdlSurf->format->BytesPerPixel;
 
    /* Verify Limits */
-   if((x > sdlSurf->w - 1) || (y > sdlSurf->h - 1) || (x < 0) || (y < 0))
+   if((x > sdlSurf->w - 1) || (y > sdlSurf->h - 1) || (x < 0) || (y < 0) ||
+      (!isInsideClip(x, y)))
    {
       return;
    }
@@ -160,6 +161,21 @@ void SDLDraw::doFilledRectangle(Surface* surface, int x1, int y1,
 {
    /* Retrieve SDL surface */
    SDL_Surface* sdlSurf = static_cast<SDLSurface*>(surface)->getSurface();
+
+   /* Restrict to the clip rectangle, if any */
+   const Rect& clip = clipRect();
+   if(clip.isDefined())
+   {
+      Rect area = clip.getIntersection(Rect(x1, y1, x2, y2));
+      if(!area.isDefined())
+      {
+         return;
+      }
+      x1 = area.getX1();
+      y1 = area.getY1();
+      x2 = area.getX2();
+      y2 = area.getY2();
+   }
    
    /* Define fill rectangle */
    SDL_Rect ret;
@@ -170,16 +186,16 @@ void SDLDraw::doFilledRectangle(Surface* surface, int x1, int y1,
 
    int bpp = sdlSurf->format->BytesPerPixel;
    Uint32 color;
+   Color cur = getWriteColor(curColor());
 
    if(bpp == 4)
    {
-      color = SDL_MapRGBA(sdlSurf->format, curColor.red, curColor.green,
-            curColor.blue, curColor.alpha);
+      color = SDL_MapRGBA(sdlSurf->format, cur.red, cur.green,
+            cur.blue, cur.alpha);
    }
    else
    { 
-      color = SDL_MapRGB(sdlSurf->format, curColor.red, curColor.green,
-            curColor.blue);
+      color = SDL_MapRGB(sdlSurf->format, cur.red, cur.green, cur.blue);
    }
 
    SDL_FillRect(sdlSurf, &ret, color);
@@ -192,10 +208,37 @@ void SDLDraw::doStampFill(Surface* target, int tx1, int ty1,
       int tx2, int ty2, Surface* source, int sx1, int sy1,
       int sx2, int sy2, StampFillType stampType)
 {
+   /* Nothing to stamp if outside the clip rectangle */
+   const Rect& clipArea = clipRect();
+   if((clipArea.isDefined()) && 
+      (!clipArea.intersects(Rect(tx1, ty1, tx2, ty2))))
+   {
+      return;
+   }
+
    /* Retrieve SDL surfaces from our surfaces */
    SDL_Surface* targetSdl = ((SDLSurface*) target)->getSurface();
    SDL_Surface* sourceSdl = ((SDLSurface*) source)->getSurface();
 
+   /* SDL blits can't blend premultiplied surfaces: must do it ourselves */
+   if((isPremultipliedAlpha()) && (stampType == Draw::STAMP_TYPE_BLEND) &&
+      (sourceSdl->format->Amask != 0) &&
+      (doPremultipliedStamp(targetSdl, tx1, ty1, tx2, ty2, sourceSdl, 
+                            sx1, sy1, sx2, sy2)))
+   {
+      return;
+   }
+
+   if(clipArea.isDefined())
+   {
+      SDL_Rect clip;
+      clip.x = clipArea.getX1();
+      clip.y = clipArea.getY1();
+      clip.w = clipArea.getWidth();
+      clip.h = clipArea.getHeight();
+      SDL_SetClipRect(targetSdl, &clip);
+   }
+
    int sourceWidth = (sx2 - sx1) + 1;
    int sourceHeight = (sy2 - sy1) + 1;
 
@@ -210,6 +253,9 @@ void SDLDraw::doStampFill(Surface* target, int tx1, int ty1,
    sourceRect.w = sourceWidth;
    sourceRect.h = sourceHeight;
 
+   /* Blits change the source: serialize them per source surface */
+   ((SDLSurface*) source)->lockBlit();
+
    /* Check each stamp type */
    if(stampType == Draw::STAMP_TYPE_BLEND) 
    {
@@ -236,8 +282,10 @@ void SDLDraw::doStampFill(Surface* target, int tx1, int ty1,
          sourceRect.h = ty2 - targetRect.y + 1;
       } 
 
-      /* Do the actual blit */
-      if(SDL_BlitSurface(sourceSdl, &sourceRect, targetSdl, &targetRect) < 0)
+      /* Do the actual blit. Note that SDL changes the target rectangle
+       * when clipping, so we must pass a copy of it. */
+      SDL_Rect blitRect = targetRect;
+      if(SDL_BlitSurface(sourceSdl, &sourceRect, targetSdl, &blitRect) < 0)
       {
          Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, SDL_GetError());
       }
@@ -259,6 +307,12 @@ void SDLDraw::doStampFill(Surface* target, int tx1, int ty1,
       moreToBlit = (targetRect.y <= ty2);
    }
 
+   ((SDLSurface*) source)->unlockBlit();
+
+   if(clipArea.isDefined())
+   {
+      SDL_SetClipRect(targetSdl, NULL);
+   }
 }
 
 /************************************************************************
@@ -267,69 +321,240 @@ void SDLDraw::doStampFill(Surface* target, int tx1, int ty1,
 void SDLDraw::doFreeTypeStamp(Surface* target, int x, int y, 
       FT_Bitmap* bitmap, int left, int top)
 {
-   /* Define glyph bytes per pixel */
-   int glyphBpp = 1;
-   switch(bitmap->pixel_mode)
+   if(bitmap->pixel_mode != FT_PIXEL_MODE_GRAY)
    {
-      case FT_PIXEL_MODE_GRAY:
-         glyphBpp = 1;
-      break;
-      default:
-         Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
-               "WARN: unsupported glyph bitmap format: %d", bitmap->pixel_mode);
-         return;
-      break;
+      Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+            "WARN: unsupported glyph bitmap format: %d", bitmap->pixel_mode);
+      return;
    }
-   
-   Uint8* pSrc = bitmap->buffer;
 
-   /* Define the 'jump' after each valid line */
-   int glyphLineJump = (int) (abs(bitmap->pitch) - 
-         (bitmap->width * glyphBpp));
-   int tx;
-   int ty = y - top;
- 
-   for(unsigned int v = 0; v < bitmap->rows; v++)
+   SDL_Surface* sdlSurf = ((SDLSurface*) target)->getSurface();
+
+   /* Glyph area on target, clipped once for the whole glyph */
+   int gx1 = x + left;
+   int gy1 = y - top;
+   Rect area = Rect(gx1, gy1, gx1 + bitmap->width - 1, 
+         gy1 + bitmap->rows - 1).getIntersection(
+            Rect(0, 0, sdlSurf->w - 1, sdlSurf->h - 1));
+   const Rect& clip = clipRect();
+   if((area.isDefined()) && (clip.isDefined()))
    {
-      tx = x + left;
-      for(unsigned int u = 0; u < bitmap->width; u++)
+      area = area.getIntersection(clip);
+   }
+   if(!area.isDefined())
+   {
+      return;
+   }
+
+   const Color& color = curColor();
+   BlendSpan::Layout layout;
+   bool spanBlend = getBlendLayout(sdlSurf, layout);
+   BlendSpan span(color, (spanBlend) ? layout : BlendSpan::Layout(),
+         isPremultipliedAlpha());
+
+   for(int ty = area.getY1(); ty <= area.getY2(); ty++)
+   {
+      /* Note: a negative pitch means the bitmap lines are stored from 
+       * bottom to top. */
+      int line = (bitmap->pitch >= 0) ? (ty - gy1) : 
+                 (bitmap->rows - 1 - (ty - gy1));
+      Uint8* pSrc = bitmap->buffer + line * abs(bitmap->pitch) + 
+                    (area.getX1() - gx1);
+
+      if(spanBlend)
+      {
+         /* Blend the whole glyph row at once */
+         span.blend((Uint8*) sdlSurf->pixels + ty * sdlSurf->pitch + 
+               area.getX1() * 4, pSrc, area.getWidth());
+      }
+      else
       {
-         if(glyphBpp == 1)
+         /* Not a 8-bit per channel RGBA surface: must use SDL to map 
+          * each pixel */
+         for(int tx = area.getX1(); tx <= area.getX2(); tx++)
          {
             Uint8 tr, tg, tb, ta;
-            
-            /* Get pixel from target to blend it with glyph */
             getPixel(target, tx, ty, tr, tg, tb, ta);
-            blendColor(curColor.red, curColor.green, curColor.blue, pSrc[0], 
-                  tr, tg, tb, ta);
-
-            /* Define it at target */
+            if(isPremultipliedAlpha())
+            {
+               blendColor(div255(color.red * *pSrc), 
+                     div255(color.green * *pSrc), 
+                     div255(color.blue * *pSrc), *pSrc, tr, tg, tb, ta);
+            }
+            else
+            {
+               blendColor(color.red, color.green, color.blue, *pSrc, 
+                     tr, tg, tb, ta);
+            }
             setPixel(target, tx, ty, tr, tg, tb, ta);
+            pSrc++;
          }
+      }
+   }
+}
 
-         /* Advance to next pixel */
-         if(bitmap->pitch > 0)
-         {
-            /* Pitch signal will define if will upward or backward on it */
-            pSrc += glyphBpp;
-         }
-         else
-         {
-            pSrc -= glyphBpp;
-         }
-         tx++;
+/************************************************************************
+ *                               rasterize                              *
+ ************************************************************************/
+void SDLDraw::rasterize(Surface* surface, const Primitive& primitive)
+{
+   SDL_Surface* sdlSurf = ((SDLSurface*) surface)->getSurface();
+   SDL_PixelFormat* format = sdlSurf->format;
+
+   if(format->BytesPerPixel == 1)
+   {
+      /* Palettized: must map each pixel through SDL */
+      Draw::rasterize(surface, primitive);
+      return;
+   }
+
+   PixelPacking packing;
+   packing.redMask = format->Rmask;
+   packing.greenMask = format->Gmask;
+   packing.blueMask = format->Bmask;
+   packing.alphaMask = format->Amask;
+   packing.redShift = format->Rshift;
+   packing.greenShift = format->Gshift;
+   packing.blueShift = format->Bshift;
+   packing.alphaShift = format->Ashift;
+   packing.redLoss = format->Rloss;
+   packing.greenLoss = format->Gloss;
+   packing.blueLoss = format->Bloss;
+   packing.alphaLoss = format->Aloss;
+
+   Rect area = getWritableArea(sdlSurf->w, sdlSurf->h);
+   Uint8* pixels = (Uint8*) sdlSurf->pixels;
+
+   /* Note: as in setPixel, only 32-bit surfaces receive the alpha */
+   Color color = curColor();
+   if(format->BytesPerPixel != 4)
+   {
+      color.alpha = 255;
+   }
+   color = getWriteColor(color);
+   bool premultiplied = isPremultipliedAlpha();
+
+   switch(format->BytesPerPixel)
+   {
+      case 2:
+      {
+         PackedPixelWriter<2> writer(pixels, sdlSurf->pitch, area, packing, 
+               color, premultiplied);
+         Draw::rasterize(writer, primitive);
       }
-      
-      ty++;
-      if(bitmap->pitch > 0)
+      break;
+      case 3:
       {
-         pSrc += glyphLineJump;
+         PackedPixelWriter<3> writer(pixels, sdlSurf->pitch, area, packing, 
+               color, premultiplied);
+         Draw::rasterize(writer, primitive);
       }
-      else
+      break;
+      case 4:
       {
-         pSrc -= glyphLineJump;
+         PackedPixelWriter<4> writer(pixels, sdlSurf->pitch, area, packing, 
+               color, premultiplied);
+         Draw::rasterize(writer, primitive);
       }
+      break;
+   }
+}
+
+/************************************************************************
+ *                            getBlendLayout                            *
+ ************************************************************************/
+bool SDLDraw::getBlendLayout(SDL_Surface* surface, BlendSpan::Layout& layout)
+{
+   SDL_PixelFormat* format = surface->format;
+
+   /* Must be 32 bits with a 8 bit, byte aligned, component per channel */
+   if((format->BytesPerPixel != 4) || (format->Amask == 0) ||
+      (format->Rmask != (0xFFu << format->Rshift)) ||
+      (format->Gmask != (0xFFu << format->Gshift)) ||
+      (format->Bmask != (0xFFu << format->Bshift)) ||
+      (format->Amask != (0xFFu << format->Ashift)) ||
+      ((format->Rshift | format->Gshift | format->Bshift | 
+        format->Ashift) & 7) != 0)
+   {
+      return false;
+   }
+
+   /* Convert the shifts to byte positions */
+   int shifts[4] = { format->Rshift, format->Gshift, format->Bshift, 
+      format->Ashift };
+   int positions[4];
+   for(int i = 0; i < 4; i++)
+   {
+      positions[i] = (SDL_BYTEORDER == SDL_BIG_ENDIAN) ? 3 - shifts[i] / 8 :
+                     shifts[i] / 8;
    }
+   layout.red = positions[0];
+   layout.green = positions[1];
+   layout.blue = positions[2];
+   layout.alpha = positions[3];
+
+   return true;
 }
 
+/************************************************************************
+ *                         doPremultipliedStamp                         *
+ ************************************************************************/
+bool SDLDraw::doPremultipliedStamp(SDL_Surface* target, int tx1, int ty1,
+      int tx2, int ty2, SDL_Surface* source, int sx1, int sy1, 
+      int sx2, int sy2)
+{
+   BlendSpan::Layout tl, sl;
+   if((!getBlendLayout(target, tl)) || (!getBlendLayout(source, sl)))
+   {
+      return false;
+   }
+
+   /* Limit to the target surface and the clip rectangle */
+   Rect area = Rect(tx1, ty1, tx2, ty2).getIntersection(
+         Rect(0, 0, target->w - 1, target->h - 1));
+   const Rect& clip = clipRect();
+   if((area.isDefined()) && (clip.isDefined()))
+   {
+      area = area.getIntersection(clip);
+   }
+   if(!area.isDefined())
+   {
+      return true;
+   }
+
+   int sourceWidth = (sx2 - sx1) + 1;
+   int sourceHeight = (sy2 - sy1) + 1;
+   if((sourceWidth <= 0) || (sourceHeight <= 0))
+   {
+      return true;
+   }
+
+   /* Note: we only read the source, thus no need to lock its blits here. */
+   for(int ty = area.getY1(); ty <= area.getY2(); ty++)
+   {
+      /* The source is tiled over the target rectangle */
+      int sy = sy1 + (ty - ty1) % sourceHeight;
+      Uint8* pTgtLine = (Uint8*) target->pixels + ty * target->pitch;
+      Uint8* pSrcLine = (Uint8*) source->pixels + sy * source->pitch;
+      for(int tx = area.getX1(); tx <= area.getX2(); tx++)
+      {
+         int sx = sx1 + (tx - tx1) % sourceWidth;
+         Uint8* pSrc = pSrcLine + sx * 4;
+         Uint8 sa = pSrc[sl.alpha];
+         if(sa == 0)
+         {
+            continue;
+         }
+         Uint8* pTgt = pTgtLine + tx * 4;
+         pTgt[tl.red] = blendPremultiplied(pSrc[sl.red], pTgt[tl.red], sa);
+         pTgt[tl.green] = blendPremultiplied(pSrc[sl.green], 
+               pTgt[tl.green], sa);
+         pTgt[tl.blue] = blendPremultiplied(pSrc[sl.blue], 
+               pTgt[tl.blue], sa);
+         pTgt[tl.alpha] = blendPremultiplied(sa, pTgt[tl.alpha], sa);
+      }
+   }
+
+   return true;
+}
 
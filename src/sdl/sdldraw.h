@@ -22,6 +22,8 @@
 #define _farso_sdl_draw_h
 
 #include "../draw.h"
+#include "../blendspan.h"
+#include <SDL2/SDL.h>
 
 namespace Farso
 {
@@ -94,6 +96,24 @@ class SDLDraw : public Draw
        * \param alpha -> alpha value */ 
       void setPixel(Surface* surface, int x, int y, 
             Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha);
+
+      /*! Get the layout of a surface for BlendSpan use.
+       * \return false if its format isn't supported by BlendSpan */
+      static bool getBlendLayout(SDL_Surface* surface, 
+            BlendSpan::Layout& layout);
+
+   protected:
+      /*! Rasterize a primitive directly to the SDL surface pixels, with 
+       * a writer specialized for its bytes per pixel. */
+      void rasterize(Surface* surface, const Primitive& primitive);
+
+   private:
+      /*! Stamp (tiling) a premultiplied source over a premultiplied 
+       * target, as SDL blits can't do that blend.
+       * \return false if the surfaces formats aren't supported. */
+      bool doPremultipliedStamp(SDL_Surface* target, int tx1, int ty1,
+            int tx2, int ty2, SDL_Surface* source, int sx1, int sy1, 
+            int sx2, int sy2);
       
 };
 
@@ -22,6 +22,7 @@
 #include "sdldraw.h"
 #include "sdlsurface.h"
 #include "sdlwidgetrenderer.h"
+#include <kobold/log.h>
 
 namespace Farso
 {
@@ -58,5 +59,55 @@ Surface* SDLRenderer::loadImageToSurface(const Kobold::String& filename)
    return new SDLSurface(filename);
 }
 
+/**************************************************************************
+ *                             createSurface                              *
+ **************************************************************************/
+Surface* SDLRenderer::createSurface(const Kobold::String& name, 
+      int width, int height)
+{
+   return new SDLSurface(name, width, height);
+}
+
+/**************************************************************************
+ *                       supportsPremultipliedAlpha                       *
+ **************************************************************************/
+bool SDLRenderer::supportsPremultipliedAlpha()
+{
+   /* Custom blend modes aren't supported by every SDL render driver, so
+    * let's check it with a dummy texture. */
+   SDL_Texture* texture = SDL_CreateTexture(sdlRenderer, 
+         SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+   if(texture == NULL)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't create texture: %s", SDL_GetError());
+      return false;
+   }
+
+   bool supported = true;
+   if(SDL_SetTextureBlendMode(texture, getPremultipliedBlendMode()) != 0)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: premultiplied alpha blend mode not supported: %s",
+            SDL_GetError());
+      supported = false;
+   }
+
+   SDL_DestroyTexture(texture);
+   return supported;
+}
+
+/**************************************************************************
+ *                        getPremultipliedBlendMode                       *
+ **************************************************************************/
+SDL_BlendMode SDLRenderer::getPremultipliedBlendMode()
+{
+   /* Texture color is already multiplied by its alpha */
+   return SDL_ComposeCustomBlendMode(
+         SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+         SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE, 
+         SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+}
+
 }
 
@@ -47,6 +47,12 @@ class SDLRenderer : public Renderer
       void restore3dMode() override {};
       const bool shouldManualRender() const override { return true; };
       Surface* loadImageToSurface(const Kobold::String& filename) override;
+      Surface* createSurface(const Kobold::String& name, 
+            int width, int height) override;
+      bool supportsPremultipliedAlpha() override;
+
+      /*! \return the blend mode to compose premultiplied alpha textures */
+      static SDL_BlendMode getPremultipliedBlendMode();
 
    private:
       SDL_Renderer* sdlRenderer; /**< The renderer from SDL */
@@ -21,6 +21,7 @@
 #include "sdlsurface.h"
 #include "../controller.h"
 #include "../draw.h"
+#include "sdldraw.h"
 
 #include <kobold/platform.h>
 
@@ -83,6 +84,48 @@ void SDLSurface::createSurface(int width, int height)
    unlock();
 }
 
+/******************************************************************
+ *                        premultiplyAlpha                        *
+ ******************************************************************/
+void SDLSurface::premultiplyAlpha()
+{
+   if((surface == NULL) || (surface->format->Amask == 0) ||
+      (!Controller::isPremultipliedAlpha()))
+   {
+      /* Nothing to convert */
+      return;
+   }
+
+   BlendSpan::Layout layout;
+   if(!SDLDraw::getBlendLayout(surface, layout))
+   {
+      /* Not an 8-bit per channel format: convert it to one */
+      SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, 
+            SDL_PIXELFORMAT_ABGR8888, 0);
+      if((converted == NULL) || (!SDLDraw::getBlendLayout(converted, layout)))
+      {
+         Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+               "Can't convert '%s' to premultiplied alpha: %s", 
+               name.c_str(), SDL_GetError());
+         if(converted != NULL)
+         {
+            SDL_FreeSurface(converted);
+         }
+         return;
+      }
+      SDL_FreeSurface(surface);
+      surface = converted;
+   }
+
+   lock();
+   for(int y = 0; y < surface->h; y++)
+   {
+      BlendSpan::premultiply((Uint8*) surface->pixels + y * surface->pitch,
+            surface->w, layout);
+   }
+   unlock();
+}
+
 /******************************************************************
  *                           Constructor                          *
  ******************************************************************/
@@ -116,6 +159,8 @@ SDLSurface::SDLSurface(Kobold::String filename, bool load)
                "Warning: loaded non-power of two image: '%s' (%d x %d)",
                filename.c_str(), surface->w, surface->h);
       }
+
+      premultiplyAlpha();
 #else
       Kobold::Log::add(Kobold::LOG_LEVEL_ERROR,
         "Error: load SDL image from disk is only supported by Farso's OpenGL.");
@@ -184,3 +229,19 @@ SDL_Surface* SDLSurface::getSurface()
    return surface;
 }
 
+/******************************************************************
+ *                              lockBlit                          *
+ ******************************************************************/
+void SDLSurface::lockBlit()
+{
+   blitMutex.lock();
+}
+
+/******************************************************************
+ *                             unlockBlit                         *
+ ******************************************************************/
+void SDLSurface::unlockBlit()
+{
+   blitMutex.unlock();
+}
+
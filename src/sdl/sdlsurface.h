@@ -23,6 +23,7 @@
 
 #include "../surface.h"
 #include <SDL2/SDL.h>
+#include <kobold/mutex.h>
 
 namespace Farso
 {
@@ -58,15 +59,30 @@ class SDLSurface : public Surface
       /*! \return SDL_Surface */
       SDL_Surface* getSurface();
 
+      /*! Lock the surface to be used as a blit source.
+       * \note SDL blits change the source surface (its blend mode and
+       *       blit map), thus they must be serialized per source when
+       *       stamping from the same source on multiple threads. */
+      void lockBlit();
+
+      /*! Unlock the surface after used as a blit source. */
+      void unlockBlit();
+
    protected:
       /*! Create the surface. Should be called when load == false
        * on image load constructor, as soon as know the image's dimensions
        * to load */
       void createSurface(int width, int height);
 
+      /*! Convert the loaded image to premultiplied alpha, if surfaces
+       * are used that way (see Controller::init). Should be called
+       * once, just after loading an image to the surface. */
+      void premultiplyAlpha();
+
    private:
 
       SDL_Surface* surface; /**< The SDL Surface */
+      Kobold::Mutex blitMutex; /**< Mutex for blits from this surface */
 
       int realWidth; /**< Width as power of two */
       int realHeight; /**< Height as power of two */
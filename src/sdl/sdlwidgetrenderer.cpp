@@ -22,6 +22,7 @@
 #include "sdlrenderer.h"
 #include "sdlsurface.h"
 #include "../controller.h"
+#include <kobold/log.h>
 using namespace Farso;
 
 /***********************************************************************
@@ -42,7 +43,16 @@ SDLWidgetRenderer::SDLWidgetRenderer(int width, int height)
    this->posX = 0;
    this->posY = 0;
 
-   SDL_SetTextureBlendMode(this->texture, SDL_BLENDMODE_BLEND);
+   SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+   if(Controller::isPremultipliedAlpha())
+   {
+      blendMode = SDLRenderer::getPremultipliedBlendMode();
+   }
+   if(SDL_SetTextureBlendMode(this->texture, blendMode) != 0)
+   {
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't set texture blend mode: %s", SDL_GetError());
+   }
 }
 
 /***********************************************************************
@@ -62,19 +72,49 @@ SDLWidgetRenderer::~SDLWidgetRenderer()
 }
 
 /***********************************************************************
- *                             uploadSurface                           *
+ *                           doUploadSurface                           *
  ***********************************************************************/
-void SDLWidgetRenderer::uploadSurface()
+size_t SDLWidgetRenderer::doUploadSurface(const std::list<Rect>& areas)
 {
    /* From the SDL mail list, by one of the SDL developers:
     * 'if you're keeping a copy in memory anyhow, and/or updating 
     * every pixel for each upload, SDL_UpdateTexture() is the better choice.'
     * As we don't need to read back the texture contents (we are only flushing
     * our surface to it), let's use SDL_UpdateSurface instead of Lock / copy /
-    * Unlock. */
-   SDLSurface* sdlSurface = static_cast<SDLSurface*>(surface);
-   SDL_UpdateTexture(texture, NULL, sdlSurface->getSurface()->pixels, 
-         sdlSurface->getSurface()->pitch);
+    * Unlock, only for the changed areas. */
+   SDL_Surface* sdlSurf = static_cast<SDLSurface*>(surface)->getSurface();
+   int bpp = sdlSurf->format->BytesPerPixel;
+   size_t bytes = 0;
+
+   /* Note: the texture was created with the initial size, which could be 
+    * smaller than current one. */
+   int texWidth = 0, texHeight = 0;
+   SDL_QueryTexture(texture, NULL, NULL, &texWidth, &texHeight);
+   Rect limits(0, 0, texWidth - 1, texHeight - 1);
+
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      Rect area = (*it).getIntersection(limits);
+      if(!area.isDefined())
+      {
+         continue;
+      }
+
+      SDL_Rect rect;
+      rect.x = area.getX1();
+      rect.y = area.getY1();
+      rect.w = area.getWidth();
+      rect.h = area.getHeight();
+
+      Uint8* pixels = (Uint8*) sdlSurf->pixels + rect.y * sdlSurf->pitch + 
+                      rect.x * bpp;
+      SDL_UpdateTexture(texture, &rect, pixels, sdlSurf->pitch);
+
+      bytes += rect.w * rect.h * bpp;
+   }
+
+   return bytes;
 }
 
 /***********************************************************************
@@ -33,7 +33,6 @@ namespace Farso
          SDLWidgetRenderer(int width, int height); 
          ~SDLWidgetRenderer();
 
-         void uploadSurface();
          void setRenderQueueSubGroup(int renderQueueId){};
 
       protected:
@@ -42,6 +41,7 @@ namespace Farso
          void doHide();
          void doShow();
          void doRender();
+         size_t doUploadSurface(const std::list<Rect>& areas);
 
       private:
          SDL_Texture* texture; /**< SDL_Texture related */
@@ -19,6 +19,7 @@
 */
 
 #include "skin.h"
+#include "skinelementcache.h"
 #include "controller.h"
 #include "font.h"
 
@@ -526,7 +527,7 @@ const Farso::Rect Skin::SkinElement::getBounds(int width, int height) const
  *                                draw                                 *
  ***********************************************************************/
 void Skin::SkinElement::draw(Surface* dest, Surface* src, 
-      int wx1, int wy1, int wx2, int wy2)
+      int wx1, int wy1, int wx2, int wy2) const
 {
    Farso::Rect rect, delta;
    Farso::Draw* fdraw = Farso::Controller::getDraw();
@@ -664,6 +665,19 @@ void Skin::SkinElement::draw(Surface* dest, Surface* src,
    /* Do the normal draw */
    draw(dest, src, wx1, wy1, wx2, wy2);
 
+   drawCaption(dest, bounds, caption, fontName, fontSize, align, fontColor,
+         outlineColor, outlineWidth);
+}
+
+/***********************************************************************
+ *                             drawCaption                             *
+ ***********************************************************************/
+void Skin::SkinElement::drawCaption(Surface* dest, const Rect& bounds, 
+      const Kobold::String& caption, const Kobold::String& fontName, 
+      int fontSize, const Font::Alignment& align, 
+      const Color& fontColor, const Color& outlineColor, 
+      int outlineWidth) const
+{
    if( (textAreaDelta.isDefined()) && (!caption.empty()) )
    {
       /* Write with the desired font */
@@ -696,6 +710,7 @@ Skin::Skin()
       elements(NULL),
       filename("")
 {
+   cache = new SkinElementCache();
 }
 
 /***********************************************************************
@@ -703,6 +718,7 @@ Skin::Skin()
  ***********************************************************************/
 Skin::~Skin()
 {
+   delete cache;
    if(surface)
    {
       delete surface;
@@ -752,6 +768,8 @@ bool Skin::load(const Kobold::String& filename)
  ***********************************************************************/
 bool Skin::load(const Kobold::String& filename, Kobold::DefParser& def)
 {
+   FARSO_TRACE_SCOPE_DETAIL("Skin::load", filename);
+
    /* Define elements vector and totals */
    total = getTotalElements();
    if(elements)
@@ -1053,7 +1071,16 @@ Surface* Skin::getSurface()
 void Skin::drawElement(Surface* dest, int type, 
       int wx1, int wy1, int wx2, int wy2)
 {
-   getInnerSkinElement(type).draw(dest, surface, wx1, wy1, wx2, wy2); 
+   FARSO_TRACE_SCOPE("Skin::drawElement");
+   FrameStats::count(FrameStats::COUNTER_SKIN_STAMPS);
+
+   /* Try a single stamp from the composed elements cache, or compose
+    * it directly to the surface if not cacheable. */
+   SkinElement& element = getInnerSkinElement(type);
+   if(!cache->draw(dest, surface, type, element, wx1, wy1, wx2, wy2))
+   {
+      element.draw(dest, surface, wx1, wy1, wx2, wy2); 
+   }
 }
 
 /***********************************************************************
@@ -1063,8 +1090,11 @@ void Skin::drawElement(Surface* dest, int type,
       int wx1, int wy1, int wx2, int wy2, const Rect& bounds, 
       const Kobold::String& caption)
 {
-   getInnerSkinElement(type).draw(dest, surface, wx1, wy1, wx2, wy2, bounds, 
-         caption);
+   const SkinElement& element = getInnerSkinElement(type);
+   drawElement(dest, type, wx1, wy1, wx2, wy2, bounds, caption, 
+         element.getFontName(), element.getFontSize(), 
+         element.getFontAlignment(), element.getFontColor(), 
+         element.getFontColor(), 0);
 }
 
 /***********************************************************************
@@ -1076,9 +1106,17 @@ void Skin::drawElement(Surface* dest, int type, int wx1, int wy1,
       const Font::Alignment& align, const Color& fontColor, 
       const Color& outlineColor, int outlineWidth)
 {
-   getInnerSkinElement(type).draw(dest, surface, wx1, wy1, wx2, wy2, bounds,
-         caption, fontName, fontSize, align, fontColor, outlineColor,
-         outlineWidth);
+   drawElement(dest, type, wx1, wy1, wx2, wy2);
+   getInnerSkinElement(type).drawCaption(dest, bounds, caption, fontName, 
+         fontSize, align, fontColor, outlineColor, outlineWidth);
+}
+
+/***********************************************************************
+ *                              clearCache                             *
+ ***********************************************************************/
+void Skin::clearCache()
+{
+   cache->clear();
 }
 
 /***********************************************************************
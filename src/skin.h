@@ -33,6 +33,8 @@
 namespace Farso
 {
 
+class SkinElementCache;
+
 /*! A skin is an image atlas with elements to define the style of
  * Farso Widgets.
  * \note One could extend from this class, supporting own skin elements
@@ -115,6 +117,10 @@ class Skin
             const Farso::Rect& getBottomBorderDelta() const;
             const Farso::Rect& getBorderDelta() const { return borderDelta; };
 
+            const Farso::Rect& getBackgroundDelta() const 
+            { return backgroundDelta; };
+            const Farso::Rect& getBackground() const { return background; };
+
             const Farso::Rect& getTopBorder() const { return topBorder; };
             const Farso::Rect& getLeftBorder() const { return leftBorder; };
             const Farso::Rect& getBottomBorder() const { return bottomBorder; };
@@ -163,7 +169,7 @@ class Skin
              * \param wy2 widget bottom coordinate 
              * \note: both dest and src surface must be locked. */ 
             void draw(Surface* dest, Surface* src, 
-                  int wx1, int wy1, int wx2, int wy2);
+                  int wx1, int wy1, int wx2, int wy2) const;
             /*! Same as #draw, but writing caption at text area, if defined */
             void draw(Surface* dest, Surface* src, 
                   int wx1, int wy1, int wx2, int wy2, 
@@ -175,6 +181,21 @@ class Skin
                   const Kobold::String& fontName, int fontSize, 
                   const Font::Alignment& align, const Color& fontColor,
                   const Color& outlineColor, int outlineWidth);
+            /*! Write a caption at the element text area, if defined.
+             * \param dest drawable surface where will draw to
+             * \param bounds element bounds for current widget
+             * \param caption to write
+             * \param fontName font to use
+             * \param fontSize font size to use
+             * \param align font alignment to use
+             * \param fontColor font color to use
+             * \param outlineColor font outline color (if any)
+             * \param outlineWidth font outline width (0 for none) */
+            void drawCaption(Surface* dest, const Rect& bounds, 
+                  const Kobold::String& caption, 
+                  const Kobold::String& fontName, int fontSize, 
+                  const Font::Alignment& align, const Color& fontColor,
+                  const Color& outlineColor, int outlineWidth) const;
             /*! \return if this SkinElement is defined or not. */
             const bool isDefined() const;
 
@@ -288,6 +309,11 @@ class Skin
             const Color& outlineColor = Colors::black, 
             int outlineWidth = 0);
 
+      /*! Clear the cache of composed elements. 
+       * \note usually there's no need to call it, as it is cleared when 
+       *       the skin is set on Controller. */
+      void clearCache();
+
       /*! \return if the Element type is defined or not on this skin. */
       const bool isElementDefined(int type) const;
 
@@ -320,6 +346,7 @@ class Skin
       SkinElement& getInnerSkinElement(int type) const;
 
       Surface* surface; /** The surface with the skin texture atlas. */
+      SkinElementCache* cache; /**< Cache of composed elements */
 
       Kobold::String defaultFont; /**< Default font to use. */
       int defaultFontSize; /**< Default font size to use. */
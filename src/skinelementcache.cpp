@@ -0,0 +1,310 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "skinelementcache.h"
+#include "controller.h"
+#include "framestats.h"
+
+using namespace Farso;
+
+/***********************************************************************
+ *                              Constructor                            *
+ ***********************************************************************/
+SkinElementCache::SkinElementCache()
+{
+   usedBytes = 0;
+   unsupported = false;
+}
+
+/***********************************************************************
+ *                               Destructor                            *
+ ***********************************************************************/
+SkinElementCache::~SkinElementCache()
+{
+   clear();
+}
+
+/***********************************************************************
+ *                                 Entry                               *
+ ***********************************************************************/
+SkinElementCache::Entry::Entry(Surface* surface, size_t bytes)
+{
+   this->surface = surface;
+   this->bytes = bytes;
+}
+
+/***********************************************************************
+ *                                ~Entry                               *
+ ***********************************************************************/
+SkinElementCache::Entry::~Entry()
+{
+   surface->unlock();
+   delete surface;
+}
+
+/***********************************************************************
+ *                                 draw                                *
+ ***********************************************************************/
+bool SkinElementCache::draw(Surface* dest, Surface* atlas, int type, 
+      const Skin::SkinElement& element, int wx1, int wy1, int wx2, int wy2)
+{
+   Key key;
+   key.type = type;
+   key.width = wx2 - wx1 + 1;
+   key.height = wy2 - wy1 + 1;
+   size_t bytes = ((size_t) key.width) * key.height * 4;
+
+   /* Elements bigger than a quarter of the budget aren't worth it, as 
+    * they would evict most of the others (and usually are windows, 
+    * rarely with the same size of another one). */
+   if((key.width <= 0) || (key.height <= 0) || (bytes > budget / 4))
+   {
+      return false;
+   }
+
+   mutex.lock();
+   if((unsupported) || (!isCacheable(atlas, type, element)))
+   {
+      mutex.unlock();
+      return false;
+   }
+   std::shared_ptr<Entry> entry;
+   std::map<Key, std::shared_ptr<Entry> >::iterator it = entries.find(key);
+   if(it != entries.end())
+   {
+      /* Hit: just mark it as the most recently used */
+      entry = it->second;
+      lru.splice(lru.begin(), lru, entry->lruPosition);
+   }
+   mutex.unlock();
+
+   if(entry)
+   {
+      FrameStats::count(FrameStats::COUNTER_SKIN_CACHE_HITS);
+   }
+   else
+   {
+      /* Miss: compose it, out of the lock (at worst, another thread 
+       * will compose the same element at the same time). */
+      FrameStats::count(FrameStats::COUNTER_SKIN_CACHE_MISSES);
+      Surface* surface = compose(atlas, element, key.width, key.height);
+      mutex.lock();
+      if(surface == NULL)
+      {
+         unsupported = true;
+         mutex.unlock();
+         return false;
+      }
+      entry = insert(key, surface, bytes);
+      mutex.unlock();
+   }
+
+   /* Stamp the composed element (our reference keeps it valid even if 
+    * evicted meanwhile by another thread). */
+   Controller::getDraw()->doStampFill(dest, wx1, wy1, wx2, wy2, 
+         entry->surface, 0, 0, key.width - 1, key.height - 1);
+
+   return true;
+}
+
+/***********************************************************************
+ *                                insert                               *
+ ***********************************************************************/
+std::shared_ptr<SkinElementCache::Entry> SkinElementCache::insert(
+      const Key& key, Surface* surface, size_t bytes)
+{
+   std::shared_ptr<Entry> entry(new Entry(surface, bytes));
+
+   std::map<Key, std::shared_ptr<Entry> >::iterator it = entries.find(key);
+   if(it != entries.end())
+   {
+      /* Composed by another thread meanwhile: just use ours this time */
+      return entry;
+   }
+
+   /* Free least recently used ones, until it fits */
+   size_t maxBytes = budget;
+   while((!lru.empty()) && (usedBytes + bytes > maxBytes))
+   {
+      std::map<Key, std::shared_ptr<Entry> >::iterator old = 
+         entries.find(lru.back());
+      usedBytes -= old->second->bytes;
+      entries.erase(old);
+      lru.pop_back();
+   }
+
+   lru.push_front(key);
+   entry->lruPosition = lru.begin();
+   entries[key] = entry;
+   usedBytes += bytes;
+
+   return entry;
+}
+
+/***********************************************************************
+ *                               compose                               *
+ ***********************************************************************/
+Surface* SkinElementCache::compose(Surface* atlas, 
+      const Skin::SkinElement& element, int width, int height)
+{
+   unsigned int id = ++counter;
+   Surface* surface = Controller::getRenderer()->createSurface(
+         "skinElementCache" + Kobold::StringUtil::toString(id),
+         width, height);
+   if(surface == NULL)
+   {
+      return NULL;
+   }
+
+   surface->lock();
+   surface->clear();
+
+   /* Compose it without the current clip rectangle, restoring it after */
+   Draw* draw = Controller::getDraw();
+   Rect clip = draw->getClipRect();
+   draw->clearClipRect();
+   element.draw(surface, atlas, 0, 0, width - 1, height - 1);
+   if(clip.isDefined())
+   {
+      draw->setClipRect(clip);
+   }
+
+   return surface;
+}
+
+/***********************************************************************
+ *                             isCacheable                             *
+ ***********************************************************************/
+bool SkinElementCache::isCacheable(Surface* atlas, int type, 
+      const Skin::SkinElement& element)
+{
+   if(type >= (int) cacheability.size())
+   {
+      cacheability.resize(type + 1, CACHEABILITY_UNKNOWN);
+   }
+
+   if(cacheability[type] == CACHEABILITY_UNKNOWN)
+   {
+      /* Its parts must be drawn inside its bounds (ie: no negative 
+       * deltas) and must have just fully opaque or transparent pixels 
+       * (premultiplied 'over' is associative, thus any alpha is fine
+       * when using it). */
+      const Rect* deltas[] = {&element.getBackgroundDelta(), 
+         &element.getTopBorderDelta(), &element.getBottomBorderDelta(),
+         &element.getLeftBorderDelta(), &element.getRightBorderDelta(), 
+         &element.getCornerDelta()};
+      const Rect* parts[] = {&element.getBackground(), 
+         &element.getTopBorder(), &element.getBottomBorder(), 
+         &element.getLeftBorder(), &element.getRightBorder(), 
+         &element.getTopLeftCorner(), &element.getTopRightCorner(),
+         &element.getBottomLeftCorner(), &element.getBottomRightCorner()};
+
+      bool cacheable = true;
+      for(size_t i = 0; (cacheable) && (i < 6); i++)
+      {
+         const Rect& delta = *deltas[i];
+         cacheable = (!delta.isDefined()) || 
+            ((delta.getX1() >= 0) && (delta.getY1() >= 0) && 
+             (delta.getX2() >= 0) && (delta.getY2() >= 0));
+      }
+      bool premultiplied = Controller::isPremultipliedAlpha();
+      for(size_t i = 0; (cacheable) && (!premultiplied) && (i < 9); i++)
+      {
+         cacheable = hasBinaryAlpha(atlas, *parts[i]);
+      }
+      cacheability[type] = (cacheable) ? CACHEABILITY_YES : CACHEABILITY_NO;
+   }
+
+   return cacheability[type] == CACHEABILITY_YES;
+}
+
+/***********************************************************************
+ *                            hasBinaryAlpha                           *
+ ***********************************************************************/
+bool SkinElementCache::hasBinaryAlpha(Surface* atlas, const Rect& rect)
+{
+   if(!rect.isDefined())
+   {
+      return true;
+   }
+
+   Draw* draw = Controller::getDraw();
+   Uint8 r = 0, g = 0, b = 0, a = 0;
+   for(int y = rect.getY1(); y <= rect.getY2(); y++)
+   {
+      for(int x = rect.getX1(); x <= rect.getX2(); x++)
+      {
+         draw->getPixel(atlas, x, y, r, g, b, a);
+         if((a != 0) && (a != 255))
+         {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+/***********************************************************************
+ *                                 clear                               *
+ ***********************************************************************/
+void SkinElementCache::clear()
+{
+   mutex.lock();
+   entries.clear();
+   lru.clear();
+   cacheability.clear();
+   usedBytes = 0;
+   unsupported = false;
+   mutex.unlock();
+}
+
+/***********************************************************************
+ *                             getUsedBytes                            *
+ ***********************************************************************/
+size_t SkinElementCache::getUsedBytes()
+{
+   mutex.lock();
+   size_t used = usedBytes;
+   mutex.unlock();
+   return used;
+}
+
+/***********************************************************************
+ *                               setBudget                             *
+ ***********************************************************************/
+void SkinElementCache::setBudget(size_t bytes)
+{
+   budget = bytes;
+}
+
+/***********************************************************************
+ *                               getBudget                             *
+ ***********************************************************************/
+size_t SkinElementCache::getBudget()
+{
+   return budget;
+}
+
+/***********************************************************************
+ *                               Static                                *
+ ***********************************************************************/
+std::atomic<size_t> SkinElementCache::budget(FARSO_DEFAULT_SKIN_CACHE_BUDGET);
+std::atomic<unsigned int> SkinElementCache::counter(0);
+
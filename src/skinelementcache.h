@@ -0,0 +1,168 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_skin_element_cache_h
+#define _farso_skin_element_cache_h
+
+#include "farsoconfig.h"
+#include "skin.h"
+
+#include <kobold/mutex.h>
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Farso
+{
+
+/*! Default memory budget, in bytes, of each skin composed elements cache */
+#define FARSO_DEFAULT_SKIN_CACHE_BUDGET   (8 * 1024 * 1024)
+
+/*! LRU cache of fully composed skin elements bitmaps, keyed by element 
+ * type and size, thus redrawing a skin element is a single stamp 
+ * instead of up to nine (each one tiled) stamps from the skin atlas.
+ *
+ * Each Skin has its own cache, freed with it (thus invalidated when the
+ * Controller skin changes). It's thread safe, as rasterization could
+ * be done in parallel, and stamping from a cached bitmap is done out 
+ * of its lock.
+ *
+ * \note an element is only cached when the pixels of its atlas parts 
+ *       are fully opaque or fully transparent (and it's drawn inside its
+ *       own bounds), as only then stamping its pre-composed bitmap gives 
+ *       the same result of stamping each part. Other elements are drawn
+ *       as usual. */
+class SkinElementCache
+{
+   public:
+      /*! Constructor */
+      SkinElementCache();
+      /*! Destructor */
+      ~SkinElementCache();
+
+      /*! Draw an element from the cache, composing it if not yet cached.
+       * \param dest surface to draw to
+       * \param atlas skin texture atlas
+       * \param type element type
+       * \param element element definition
+       * \param wx1 widget left coordinate 
+       * \param wy1 widget top coordinate 
+       * \param wx2 widget right coordinate 
+       * \param wy2 widget bottom coordinate 
+       * \return false if the element shouldn't be cached (and thus 
+       *         wasn't drawn). */
+      bool draw(Surface* dest, Surface* atlas, int type, 
+            const Skin::SkinElement& element, 
+            int wx1, int wy1, int wx2, int wy2);
+
+      /*! Remove all cached bitmaps */
+      void clear();
+
+      /*! \return bytes used by cached bitmaps */
+      size_t getUsedBytes();
+
+      /*! Set the memory budget, in bytes, of each cache (0 to disable 
+       * caching). Least recently used bitmaps are freed to keep within
+       * it. Defaults to FARSO_DEFAULT_SKIN_CACHE_BUDGET. */
+      static void setBudget(size_t bytes);
+      /*! \return current memory budget of each cache, in bytes */
+      static size_t getBudget();
+
+   private:
+      /*! A cached element key */
+      class Key
+      {
+         public:
+            int type; /**< Element type */
+            int width; /**< Element width */
+            int height; /**< Element height */
+
+            bool operator<(const Key& other) const
+            {
+               if(type != other.type)
+               {
+                  return type < other.type;
+               }
+               if(width != other.width)
+               {
+                  return width < other.width;
+               }
+               return height < other.height;
+            };
+      };
+
+      /*! A cached composed element bitmap */
+      class Entry
+      {
+         public:
+            /*! Constructor, taking ownership of a locked surface */
+            Entry(Surface* surface, size_t bytes);
+            /*! Destructor */
+            ~Entry();
+
+            Surface* surface; /**< Composed element (kept locked) */
+            size_t bytes; /**< Bytes used by the surface */
+            std::list<Key>::iterator lruPosition; /**< At the LRU list */
+      };
+
+      /*! Element states of cacheability */
+      enum Cacheability
+      {
+         CACHEABILITY_UNKNOWN = 0,
+         CACHEABILITY_YES,
+         CACHEABILITY_NO
+      };
+
+      /*! \return if an element could be cached */
+      bool isCacheable(Surface* atlas, int type, 
+            const Skin::SkinElement& element);
+      /*! \return if all pixels of an atlas rectangle are fully opaque
+       *          or fully transparent. */
+      bool hasBinaryAlpha(Surface* atlas, const Rect& rect);
+
+      /*! Compose an element to a new surface.
+       * \return new surface, locked, or NULL if couldn't create it. */
+      Surface* compose(Surface* atlas, const Skin::SkinElement& element,
+            int width, int height);
+
+      /*! Insert a composed element, freeing least recently used ones
+       * to keep within budget (the mutex must be locked).
+       * \return the inserted entry (or the already present one) */
+      std::shared_ptr<Entry> insert(const Key& key, Surface* surface, 
+            size_t bytes);
+
+      std::map<Key, std::shared_ptr<Entry> > entries; /**< Cached ones */
+      std::list<Key> lru; /**< Keys, from most to least recently used */
+      std::vector<Cacheability> cacheability; /**< Per element type */
+      size_t usedBytes; /**< Bytes used by cached bitmaps */
+      bool unsupported; /**< If renderer couldn't create cache surfaces */
+      Kobold::Mutex mutex; /**< Mutex for thread-safe access */
+
+      static std::atomic<size_t> budget; /**< Memory budget, in bytes */
+      static std::atomic<unsigned int> counter; /**< For surface names */
+};
+
+}
+
+#endif
+
@@ -75,6 +75,26 @@ void Surface::clear()
    draw->doFilledRectangle(this, 0, 0, this->getRealWidth() - 1, 
                            this->getRealHeight() - 1);
    draw->setActiveColor(r, g, b, a);
+
+   FrameStats::count(FrameStats::COUNTER_PIXELS_CLEARED, 
+         getRealWidth() * getRealHeight());
+}
+
+/******************************************************************
+ *                              clear                             *
+ ******************************************************************/
+void Surface::clear(const Rect& area)
+{
+   Farso::Draw* draw = Farso::Controller::getDraw();
+   Uint8 r=0,g=0,b=0,a=0;
+   draw->getActiveColor(r, g, b, a);
+   draw->setActiveColor(0, 0, 0, 0);
+   draw->doFilledRectangle(this, area.getX1(), area.getY1(), 
+                           area.getX2(), area.getY2());
+   draw->setActiveColor(r, g, b, a);
+
+   FrameStats::count(FrameStats::COUNTER_PIXELS_CLEARED, 
+         area.getWidth() * area.getHeight());
 }
 
 /******************************************************************
@@ -23,6 +23,7 @@
 
 #include <kobold/kstring.h>
 #include "farsoconfig.h"
+#include "rect.h"
 
 namespace Farso
 {
@@ -47,6 +48,11 @@ class Surface
        * \note: the caller is responsible to lock the surface before clear(). */
       void clear();
 
+      /*! Clear only an area of a drawable surface.
+       * \param area rectangle to clear, in surface coordinates.
+       * \note: the caller is responsible to lock the surface before clear(). */
+      void clear(const Rect& area);
+
       /*! Lock the surface to draw.
        * \note: must be called before start to draw on it. */
       virtual void lock() = 0;
@@ -122,7 +122,7 @@ void TextSelector::clearOptions()
    TextOption* opt = static_cast<TextOption*>(options.getFirst());
    for(int i = 0; i < options.getTotal(); i++)
    {
-      remove(opt->label);
+      removeChild(opt->label);
       opt = static_cast<TextOption*>(opt->getNext());
    }
 
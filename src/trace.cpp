@@ -0,0 +1,213 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "trace.h"
+
+#include <kobold/log.h>
+
+#include <chrono>
+
+using namespace Farso;
+
+/***********************************************************************
+ *                                start                                *
+ ***********************************************************************/
+bool Trace::start(const Kobold::String& filename, int processId)
+{
+   stop();
+
+   mutex.lock();
+   file = fopen(filename.c_str(), "w");
+   if(file == NULL)
+   {
+      mutex.unlock();
+      Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+            "Error: couldn't open trace file '%s'", filename.c_str());
+      return false;
+   }
+#if FARSO_HAS_TRACE != 1
+   Kobold::Log::add(Kobold::LOG_LEVEL_NORMAL, 
+         "Warning: Farso built without FARSO_TRACE: no markers to trace.");
+#endif
+   Trace::processId = processId;
+   wroteEvent = false;
+   fprintf(file, "{\"traceEvents\":[\n");
+   active = true;
+   mutex.unlock();
+
+   return true;
+}
+
+/***********************************************************************
+ *                                 stop                                *
+ ***********************************************************************/
+void Trace::stop()
+{
+   mutex.lock();
+   active = false;
+   if(file != NULL)
+   {
+      flush();
+      fprintf(file, "\n]}\n");
+      fclose(file);
+      file = NULL;
+   }
+   mutex.unlock();
+}
+
+/***********************************************************************
+ *                               getTime                               *
+ ***********************************************************************/
+uint64_t Trace::getTime()
+{
+   return std::chrono::duration_cast<std::chrono::microseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/***********************************************************************
+ *                             getThreadId                             *
+ ***********************************************************************/
+int Trace::getThreadId()
+{
+   if(threadId == 0)
+   {
+      threadId = ++totalThreads;
+   }
+   return threadId;
+}
+
+/***********************************************************************
+ *                                 add                                 *
+ ***********************************************************************/
+void Trace::add(const char* name, uint64_t start, uint64_t end,
+      const Kobold::String& detail)
+{
+   Event ev;
+   ev.name = name;
+   ev.start = start;
+   ev.duration = (end > start) ? end - start : 0;
+   ev.threadId = getThreadId();
+   ev.detail = detail;
+
+   mutex.lock();
+   if(file != NULL)
+   {
+      events.push_back(ev);
+      if(events.size() >= FARSO_TRACE_FLUSH_EVENTS)
+      {
+         flush();
+      }
+   }
+   mutex.unlock();
+}
+
+/***********************************************************************
+ *                                flush                                *
+ ***********************************************************************/
+void Trace::flush()
+{
+   for(size_t i = 0; i < events.size(); i++)
+   {
+      Event& ev = events[i];
+      fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"farso\",\"ph\":\"X\","
+            "\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%d", 
+            (wroteEvent) ? ",\n" : "", ev.name, 
+            (unsigned long long) ev.start, (unsigned long long) ev.duration,
+            processId, ev.threadId);
+      if(!ev.detail.empty())
+      {
+         /* Escape the detail to be a valid JSON string */
+         fprintf(file, ",\"args\":{\"detail\":\"");
+         for(size_t c = 0; c < ev.detail.length(); c++)
+         {
+            unsigned char ch = (unsigned char) ev.detail[c];
+            if((ch == '"') || (ch == '\\'))
+            {
+               fprintf(file, "\\%c", ch);
+            }
+            else if(ch < 0x20)
+            {
+               fprintf(file, "\\u%04x", ch);
+            }
+            else
+            {
+               fputc(ch, file);
+            }
+         }
+         fprintf(file, "\"}");
+      }
+      fprintf(file, "}");
+      wroteEvent = true;
+   }
+   events.clear();
+}
+
+/***********************************************************************
+ *                              TraceScope                             *
+ ***********************************************************************/
+TraceScope::TraceScope(const char* name)
+{
+   this->name = name;
+   this->start = (Trace::isActive()) ? Trace::getTime() : 0;
+}
+
+/***********************************************************************
+ *                              TraceScope                             *
+ ***********************************************************************/
+TraceScope::TraceScope(const char* name, const Kobold::String& detail)
+{
+   this->name = name;
+   this->start = 0;
+   if(Trace::isActive())
+   {
+      this->detail = detail;
+      this->start = Trace::getTime();
+   }
+}
+
+/***********************************************************************
+ *                             ~TraceScope                             *
+ ***********************************************************************/
+TraceScope::~TraceScope()
+{
+   end();
+}
+
+/***********************************************************************
+ *                                 end                                 *
+ ***********************************************************************/
+void TraceScope::end()
+{
+   if(start != 0)
+   {
+      Trace::add(name, start, Trace::getTime(), detail);
+      start = 0;
+   }
+}
+
+std::atomic<bool> Trace::active(false);
+Kobold::Mutex Trace::mutex;
+FILE* Trace::file = NULL;
+int Trace::processId = 1;
+bool Trace::wroteEvent = false;
+std::vector<Trace::Event> Trace::events;
+std::atomic<int> Trace::totalThreads(0);
+thread_local int Trace::threadId = 0;
+
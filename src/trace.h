@@ -0,0 +1,154 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_trace_h
+#define _farso_trace_h
+
+#include "farsoconfig.h"
+
+#include <kobold/kstring.h>
+#include <kobold/mutex.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <vector>
+
+namespace Farso
+{
+
+/*! Number of trace events kept in memory before writing them to file */
+#define FARSO_TRACE_FLUSH_EVENTS   1024
+
+/*! Timeline of Farso's work, written as a Chrome trace JSON file (could
+ * be opened at chrome://tracing or Perfetto UI).
+ * Timestamps are in microseconds from the std::chrono::steady_clock 
+ * epoch, thus the trace could be merged with other traces using the same
+ * clock (for example, the application's engine ones).
+ * \note the markers (see FARSO_TRACE_SCOPE) are only compiled when Farso
+ *       is built with FARSO_TRACE option. Without it, Trace::start will
+ *       just record nothing. */
+class Trace
+{
+   public:
+      /*! Start recording trace events to a file.
+       * \param filename trace JSON file to write to.
+       * \param processId process id to use at the trace events.
+       * \return if could open the file to write. */
+      static bool start(const Kobold::String& filename, int processId = 1);
+
+      /*! Stop recording, writing any pending event and closing the file */
+      static void stop();
+
+      /*! \return if recording trace events */
+      static bool isActive() 
+      { 
+         return active.load(std::memory_order_relaxed); 
+      };
+
+      /*! \return current trace time, in microseconds */
+      static uint64_t getTime();
+
+      /*! Add a complete event to the trace. 
+       * \param name event name (must be kept alive until stop).
+       * \param start start time, in microseconds
+       * \param end end time, in microseconds
+       * \param detail optional detail of the event 
+       * \note thread safe */
+      static void add(const char* name, uint64_t start, uint64_t end,
+            const Kobold::String& detail);
+
+   private:
+      /*! A complete ("X") trace event */
+      struct Event
+      {
+         const char* name; /**< Event name */
+         uint64_t start; /**< Start time, in microseconds */
+         uint64_t duration; /**< Duration, in microseconds */
+         int threadId; /**< Thread that generated it */
+         Kobold::String detail; /**< Optional detail */
+      };
+
+      /*! Write all buffered events to the file.
+       * \note mutex must be locked. */
+      static void flush();
+
+      /*! \return trace id of the current thread */
+      static int getThreadId();
+
+      static std::atomic<bool> active; /**< If recording */
+      static Kobold::Mutex mutex; /**< Mutex for events and file */
+      static FILE* file; /**< File to write to */
+      static int processId; /**< Process id used on events */
+      static bool wroteEvent; /**< If any event was written to file */
+      static std::vector<Event> events; /**< Events not yet written */
+      static std::atomic<int> totalThreads; /**< Threads with events */
+      static thread_local int threadId; /**< Trace id of current thread */
+};
+
+/*! A trace event that lasts from its creation until its destruction 
+ * (or its end call). Usually used by the FARSO_TRACE_* macros. */
+class TraceScope
+{
+   public:
+      /*! Constructor
+       * \param name event name (should be a literal) */
+      TraceScope(const char* name);
+      /*! Constructor 
+       * \param name event name (should be a literal) 
+       * \param detail detail to show at event's arguments */
+      TraceScope(const char* name, const Kobold::String& detail);
+      /*! Destructor */
+      ~TraceScope();
+
+      /*! End the event before the scope end */
+      void end();
+
+   private:
+      const char* name; /**< Event name */
+      Kobold::String detail; /**< Event detail */
+      uint64_t start; /**< Start time or 0, if not recording */
+};
+
+}
+
+#if FARSO_HAS_TRACE == 1
+   #define FARSO_TRACE_CONCAT_IMPL(a, b) a##b
+   #define FARSO_TRACE_CONCAT(a, b) FARSO_TRACE_CONCAT_IMPL(a, b)
+   /*! Trace from here to the end of current scope */
+   #define FARSO_TRACE_SCOPE(name) \
+      Farso::TraceScope FARSO_TRACE_CONCAT(farsoTrace, __LINE__)(name)
+   /*! Trace from here to the end of current scope, with a detail string */
+   #define FARSO_TRACE_SCOPE_DETAIL(name, detail) \
+      Farso::TraceScope FARSO_TRACE_CONCAT(farsoTrace, __LINE__)(name, detail)
+   /*! Trace from here to a FARSO_TRACE_END(var) call */
+   #define FARSO_TRACE_BEGIN(var, name) Farso::TraceScope var(name)
+   /*! End a trace started with FARSO_TRACE_BEGIN(var, name) */
+   #define FARSO_TRACE_END(var) var.end()
+#else
+   #define FARSO_TRACE_SCOPE(name)
+   #define FARSO_TRACE_SCOPE_DETAIL(name, detail)
+   #define FARSO_TRACE_BEGIN(var, name)
+   #define FARSO_TRACE_END(var)
+#endif
+
+#endif
+
@@ -563,8 +563,8 @@ void TreeView::doDraw(const Rect& pBody)
       {
          /* Remove the memory of label and button (remember that they are 
           * children of the grid) */
-         grid->remove(labels[labels.size() - 1]);
-         grid->remove(buttons[buttons.size() - 1]);
+         grid->removeChild(labels[labels.size() - 1]);
+         grid->removeChild(buttons[buttons.size() - 1]);
          labels.pop_back();
          buttons.pop_back();
       }
@@ -49,7 +49,13 @@ Widget::Widget(WidgetType wType, int x, int y, int w, int h, Widget* wParent)
         parent(wParent),
         root(NULL),
         dirty(true),
-        skinElementType(Skin::SKIN_TYPE_UNKNOWN)
+        dirtyChild(false),
+        skinElementType(Skin::SKIN_TYPE_UNKNOWN),
+        absBodyValid(false),
+        rasterizedFull(false),
+        index(NULL),
+        indexed(false),
+        treatMark(0)
 {
    assert((width > 0) && (height > 0));
 
@@ -71,6 +77,19 @@ Widget::Widget(WidgetType wType, int x, int y, int w, int h, Widget* wParent)
    defineParentContainer();
 
    setPosition(x, y);
+
+   /* Its area must be drawn */
+   damageArea();
+   propagateDirty();
+
+   if(ownRenderer)
+   {
+      index = new WidgetIndex(width, height);
+   }
+   else
+   {
+      reindex();
+   }
 }
 
 /***********************************************************************
@@ -93,7 +112,13 @@ Widget::Widget(WidgetType wType, Widget* wParent)
         parent(wParent),
         root(NULL),
         dirty(true),
-        skinElementType(Skin::SKIN_TYPE_UNKNOWN)
+        dirtyChild(false),
+        skinElementType(Skin::SKIN_TYPE_UNKNOWN),
+        absBodyValid(false),
+        rasterizedFull(false),
+        index(NULL),
+        indexed(false),
+        treatMark(0)
 {
    if(parent)
    {
@@ -111,6 +136,7 @@ Widget::Widget(WidgetType wType, Widget* wParent)
    }
    
    defineParentContainer();
+   propagateDirty();
 }
 
 /***********************************************************************
@@ -120,6 +146,33 @@ Widget::~Widget()
 {
    listeners.clear();
 
+   /* Remove itself and its children from the index */
+   if(index != NULL)
+   {
+      Widget* child = (Widget*) getFirst();
+      for(int i = 0; i < getTotal(); i++)
+      {
+         if(!child->ownRenderer)
+         {
+            child->indexSubtree(index, false);
+         }
+         child = (Widget*) child->getNext();
+      }
+      delete index;
+      index = NULL;
+   }
+   else if(indexed)
+   {
+      WidgetIndex* idx = getOwnerIndex();
+      if(idx != NULL)
+      {
+         indexSubtree(idx, false);
+      }
+   }
+
+   /* No queued command should be applied to it anymore */
+   Controller::discardQueuedCommands(this);
+
    /* Remove reference from its id, if defined */
    if(!this->id.empty())
    {
@@ -139,8 +192,20 @@ Widget::~Widget()
 void Widget::overrideWidgetRenderer(WidgetRenderer* renderer, bool ownRenderer)
 {
    assert(parent != NULL);
+
+   if((ownRenderer) && (!this->ownRenderer))
+   {
+      /* No more at our parent's renderer index */
+      WidgetIndex* idx = getOwnerIndex();
+      if(idx != NULL)
+      {
+         indexSubtree(idx, false);
+      }
+   }
+
    this->renderer = renderer;
    this->ownRenderer = ownRenderer;
+   invalidateAbsoluteBody();
 
    /* Propagate children */
    Widget* child = (Widget*) getFirst();
@@ -150,6 +215,12 @@ void Widget::overrideWidgetRenderer(WidgetRenderer* renderer, bool ownRenderer)
       child = (Widget*) child->getNext();
    }
 
+   if((ownRenderer) && (index == NULL))
+   {
+      index = new WidgetIndex(width, height);
+      rebuildIndex();
+   }
+
 }
 
 /***********************************************************************
@@ -203,11 +274,15 @@ void Widget::setPosition(int x, int y)
    {
       if( (this->x != x) || (this->y != y) )
       {
+         /* Its previous area must be redrawn */
+         damageArea();
+
          this->x = x; 
          this->y = y;
 
          /* As changed its position, must dirty its parent too */
          setDirtyWithParent();
+         reindex();
       }
    }
 }
@@ -251,10 +326,13 @@ void Widget::setSize(int width, int height)
 {
    if( (this->width != width) || (this->height != height) )
    {
-      this->width = width;
-      this->height = height;
+      /* Our body and children's positions could change */
+      invalidateAbsoluteBody();
+
       if(ownRenderer)
       {
+         this->width = width;
+         this->height = height;
          if(this->renderer != NULL)
          {
             /* Just update renderer size (recreating its surface if needed) */
@@ -266,11 +344,22 @@ void Widget::setSize(int width, int height)
             /* As no renderer yet, should create one. */
             this->renderer = Controller::createNewWidgetRenderer(width, height);
          }
+
+         /* Recreate the index for the new size */
+         if(index == NULL)
+         {
+            index = new WidgetIndex(width, height);
+         }
+         rebuildIndex();
       }
       else
       {
-         /* As changed its position, must dirty its parent too */
+         /* As changed its size, must redraw its previous area too */
+         damageArea();
+         this->width = width;
+         this->height = height;
          setDirtyWithParent();
+         reindex();
       }
 
    }
@@ -347,65 +436,202 @@ void Widget::enable()
  ***********************************************************************/
 void Widget::draw(bool force)
 {
-   bool wasDirty = dirty;
-   Surface* surface = getWidgetRenderer()->getSurface();
-
-   if(ownRenderer)
+   if(!ownRenderer)
    {
-      surface->lock();
-      /* Only need to clear the surface if is itself dirty.
-       * In case the children is dirty and will need to affect the
-       * parent's (changind its area, for example), the child is responsable
-       * for marking parent as dirty to it to work as expected. */
-      if(isSelfDirty())
+      /* Must draw our area through the widget owning the renderer */
+      setDirty();
+      Widget* owner = parent;
+      while((owner != NULL) && (!owner->ownRenderer))
       {
-         surface->clear();
+         owner = owner->parent;
       }
+      if(owner != NULL)
+      {
+         owner->draw(force);
+      }
+      return;
+   }
+
+   rasterize(force);
+   finishDraw();
+}
+
+/***********************************************************************
+ *                              rasterize                              *
+ ***********************************************************************/
+void Widget::rasterize(bool force)
+{
+   assert(ownRenderer);
+   FARSO_TRACE_SCOPE_DETAIL("Widget::rasterize", id);
+
+   Surface* surface = renderer->getSurface();
+   Farso::Draw* draw = Controller::getDraw();
+   bool fullRedraw = force || dirty;
+
+   surface->lock();
+
+   if(force)
+   {
+      renderer->damageAll();
    }
 
-   /* Draw it */
-   if(wasDirty || force)
+   /* Get the damaged areas to redraw. Note that we must clear them 
+    * before drawing, as the draw itself could define new damaged areas
+    * (for example, by redefining children positions), that should be 
+    * redrawn later. */
+   rasterizedAreas = renderer->getDamage();
+   renderer->clearDamage();
+   rasterizedFull = fullRedraw;
+
+   rasterizedSubRenderers.clear();
+   clearDirty(rasterizedSubRenderers, fullRedraw);
+
+   /* Redraw each damaged area, with everything on it */
+   for(std::list<Rect>::iterator it = rasterizedAreas.begin(); 
+       it != rasterizedAreas.end(); ++it)
    {
-      Rect pBody = (parent ? parent->getBodyWithParentsApplied()
-                           : Rect(0, 0, width-1, height-1));
-      if(skinElementType == Skin::SKIN_TYPE_UNKNOWN)
+      surface->clear(*it);
+      draw->pushClipRect(*it);
+      drawArea(*it);
+      draw->popClipRect();
+   }
+}
+
+/***********************************************************************
+ *                              finishDraw                             *
+ ***********************************************************************/
+void Widget::finishDraw()
+{
+   assert(ownRenderer);
+
+   /* Reupload its texture, if changed */
+   if(!rasterizedAreas.empty())
+   {
+      renderer->uploadSurface(rasterizedAreas);
+      rasterizedAreas.clear();
+   }
+   renderer->getSurface()->unlock();
+
+   /* Draw children with their own renderers */
+   std::list<Widget*> subRenderers;
+   subRenderers.swap(rasterizedSubRenderers);
+   for(std::list<Widget*>::iterator it = subRenderers.begin(); 
+       it != subRenderers.end(); ++it)
+   {
+      if((rasterizedFull) || ((*it)->isDirty()))
       {
-         /* Usual render */
-         doDraw(pBody);
+         (*it)->draw(rasterizedFull);
       }
-      else
+   }
+}
+
+/***********************************************************************
+ *                              drawArea                               *
+ ***********************************************************************/
+void Widget::drawArea(const Rect& area)
+{
+   FrameStats::count(FrameStats::COUNTER_WIDGETS_DRAWN);
+
+   Rect pBody = (parent ? parent->getBodyWithParentsApplied()
+                        : Rect(0, 0, width-1, height-1));
+
+   /* Never draw (nor let its children draw) outside its parent's area.
+    * Note that it isn't clipped to the parent's body, as some children
+    * are placed out of it (like a window's close button, at its title).
+    * A widget owning its renderer is the root of its surface, thus only
+    * clipped by the damaged area. */
+   Farso::Draw* draw = Controller::getDraw();
+   if(!draw->pushClipRect(((ownRenderer) || (parent == NULL)) ? area : 
+            parent->getRectOnRenderer()))
+   {
+      draw->popClipRect();
+      return;
+   }
+
+   if(skinElementType == Skin::SKIN_TYPE_UNKNOWN)
+   {
+      /* Usual render */
+      doDraw(pBody);
+   }
+   else
+   {
+      /* Override render */
+      Farso::Skin* skin = Farso::Controller::getSkin();
+      if(skin)
       {
-         /* Override render */
-         Farso::Skin* skin = Farso::Controller::getSkin();
-         if(skin)
-         {
-            int x1 = pBody.getX1() + getX();
-            int y1 = pBody.getY1() + getY();
-            int x2 = x1 + getWidth() - 1;
-            int y2 = y1 + getHeight() - 1;
+         int x1 = pBody.getX1() + getX();
+         int y1 = pBody.getY1() + getY();
+         int x2 = x1 + getWidth() - 1;
+         int y2 = y1 + getHeight() - 1;
 
-            skin->drawElement(surface, skinElementType, x1, y1, x2, y2);
-         }
+         skin->drawElement(renderer->getSurface(), skinElementType, 
+               x1, y1, x2, y2);
       }
    }
-   dirty = false;
 
-   /* Draw each of its dirty children (or, if dirty, MUST draw the children). */
+   /* Draw each of its children which intersects the area. Note that 
+    * body must be taken after doDraw, as it could be redefined there. */
+   if(absBodyValid)
+   {
+      Rect cur = getBody();
+      if(absBodyRelative != cur)
+      {
+         invalidateAbsoluteBody();
+      }
+   }
+   Rect body = getBodyWithParentsApplied();
    Widget* child = (Widget*) getFirst();
    for(int i = 0; i < getTotal(); i++)
    {
-      if((child->isVisible()) && (force || wasDirty || child->isDirty()))
+      if((child->isVisible()) && (!child->ownRenderer))
       {
-         child->draw(wasDirty || force);
+         int cx = body.getX1() + child->getX();
+         int cy = body.getY1() + child->getY();
+         Rect childRect(cx, cy, cx + child->getWidth() - 1, 
+                        cy + child->getHeight() - 1);
+         if(area.intersects(childRect))
+         {
+            child->drawArea(area);
+         }
       }
       child = (Widget*) child->getNext();
    }
 
-   /* Reupload its texture, if owned it */
-   if(ownRenderer)
+   draw->popClipRect();
+}
+
+/***********************************************************************
+ *                             clearDirty                              *
+ ***********************************************************************/
+void Widget::clearDirty(std::list<Widget*>& subRenderers, bool all)
+{
+   bool checkChildren = all || dirtyChild;
+   dirty = false;
+   dirtyChild = false;
+
+   if(!checkChildren)
+   {
+      /* No dirty descendants: done. */
+      return;
+   }
+
+   Widget* child = (Widget*) getFirst();
+   for(int i = 0; i < getTotal(); i++)
    {
-      renderer->uploadSurface();
-      surface->unlock();
+      if(child->ownRenderer)
+      {
+         /* Note: a hidden one keeps its flags, as it still should be 
+          * drawn when shown again (and show() will tell us so). */
+         if(child->isVisible())
+         {
+            subRenderers.push_back(child);
+         }
+      }
+      else if((all) || (child->dirty) || (child->dirtyChild))
+      {
+         child->clearDirty(subRenderers, all);
+      }
+      child = (Widget*) child->getNext();
    }
 }
 
@@ -419,25 +645,14 @@ bool Widget::isDirty()
       /* A not-visible widget will never be dirty */
       return false;
    }
-   if(dirty)
+   if((dirty) || (dirtyChild))
    {
-      /* This is dirty: will redraw it and its children.*/
+      /* This (or some of its descendants) is dirty */
       return true;
    }
 
-   /* Not dirty, must check children */
-   Widget* child = (Widget*) getFirst();
-   for(int i = 0; i < getTotal(); i++)
-   {
-      if(child->isDirty())
-      {
-         return true;
-      }
-      child = (Widget*) child->getNext();
-   }
-
-   /* No dirty found! */
-   return false;
+   /* Not dirty, but some area of its renderer could need a redraw */
+   return (ownRenderer) && (renderer != NULL) && (renderer->hasDamage());
 }
 
 /***********************************************************************
@@ -445,7 +660,11 @@ bool Widget::isDirty()
  ***********************************************************************/
 void Widget::setDirty()
 {
+   /* Note: body usually is redefined when the widget changes */
+   invalidateAbsoluteBody();
    dirty = true;
+   damageArea();
+   propagateDirty();
 }
 
 /***********************************************************************
@@ -453,16 +672,59 @@ void Widget::setDirty()
  ***********************************************************************/
 void Widget::setDirtyWithParent()
 {
-   if(!dirty)
+   /* Note: as a damaged area is redrawn with everything under it, 
+    * the parent will be redrawn there too. */
+   invalidateAbsoluteBody();
+   dirty = true;
+   damageArea();
+   propagateDirty();
+}
+
+/***********************************************************************
+ *                            propagateDirty                           *
+ ***********************************************************************/
+void Widget::propagateDirty()
+{
+   /* Note: if a parent is already marked, all of its parents at the 
+    * same renderer are too. A renderer owner could keep its mark while
+    * its parent was cleared (for example, if hidden when its parent was
+    * drawn), so we must keep going up when crossing renderers. */
+   Widget* w = parent;
+   while((w != NULL) && ((!w->dirtyChild) || (w->ownRenderer)))
    {
-      if(parent)
-      {
-         parent->setDirty();
-      }
-      dirty = true;
+      w->dirtyChild = true;
+      w = w->parent;
    }
 }
 
+/***********************************************************************
+ *                             damageArea                              *
+ ***********************************************************************/
+void Widget::damageArea()
+{
+   if((visible) && (getWidgetRenderer() != NULL))
+   {
+      renderer->addDamage(getRectOnRenderer());
+   }
+}
+
+/***********************************************************************
+ *                          getRectOnRenderer                          *
+ ***********************************************************************/
+Farso::Rect Widget::getRectOnRenderer()
+{
+   if((ownRenderer) || (parent == NULL))
+   {
+      return Rect(0, 0, width - 1, height - 1);
+   }
+
+   Rect pBody = parent->getBodyWithParentsApplied();
+   int x1 = pBody.getX1() + getX();
+   int y1 = pBody.getY1() + getY();
+
+   return Rect(x1, y1, x1 + width - 1, y1 + height - 1);
+}
+
 /***********************************************************************
  *                            setMouseHint                             *
  ***********************************************************************/
@@ -478,19 +740,22 @@ void Widget::hide()
 {
    if(visible)
    {
-      visible = false;
       available = false;
 
       /* Note that when hidden, there's no need to redraw itself.
-       * But we must tell our parent. */
+       * But we must redraw its previous area. */
       if((!ownRenderer) && (getParent() != NULL))
       {
-         getParent()->setDirty();
+         damageArea();
+         propagateDirty();
+         visible = false;
+         reindex();
       }
       else if(renderer)
       {
          renderer->hide();
       }
+      visible = false;
    }
 }
 
@@ -507,6 +772,14 @@ void Widget::show()
       if(ownRenderer && renderer)
       {
          renderer->show();
+
+         /* Its parents must know, to draw it if needed */
+         propagateDirty();
+      }
+      else
+      {
+         setDirty();
+         reindex();
       }
    }
 }
@@ -576,6 +849,27 @@ void Widget::addChild(Widget* child)
    insertAtEnd(child);
 }
 
+/***********************************************************************
+ *                             removeChild                             *
+ ***********************************************************************/
+void Widget::removeChild(Widget* child)
+{
+   assert(child->parent == this);
+
+   /* Its area must be redrawn without it */
+   child->damageArea();
+   child->propagateDirty();
+
+   /* And no more indexed */
+   WidgetIndex* idx = child->getOwnerIndex();
+   if(idx != NULL)
+   {
+      child->indexSubtree(idx, false);
+   }
+
+   remove(child);
+}
+
 /***********************************************************************
  *                           getWidgetRenderer                         *
  ***********************************************************************/
@@ -606,8 +900,46 @@ bool Widget::treat(bool leftButtonPressed, bool rightButtonPressed,
    int mrX = mouseX - getWidgetRenderer()->getPositionX();
    int mrY = mouseY - getWidgetRenderer()->getPositionY();
 
-   return treat(leftButtonPressed, rightButtonPressed, 
+   if((!ownRenderer) || (index == NULL) || 
+      (!Controller::isHitTestIndexEnabled()))
+   {
+      /* Must check the whole tree */
+      return treat(leftButtonPressed, rightButtonPressed, 
+            mouseX, mouseY, mrX, mrY);
+   }
+
+   /* When no button is pressed (nor was at last check), no text is
+    * being edited and the wheel isn't moving, only hover could happen. 
+    * Thus, we just need to check widgets under current and last cursor 
+    * positions (the last one, to let them know that the cursor left). 
+    * Otherwise, all widgets must be checked, as they could be waiting for
+    * a release or drag outside their areas, or scroll by wheel while the
+    * cursor is over a sibling (like a ScrollBar of a ScrollText). */
+   bool pressed = leftButtonPressed || rightButtonPressed;
+   unsigned int filter = 0;
+   if((!pressed) && (!index->wasPressed()) && 
+      (!Kobold::Keyboard::isEditingText()) &&
+      (Farso::Cursor::getRelativeWheel() == 0))
+   {
+      treatStamp++;
+      if(treatStamp == 0)
+      {
+         /* Note: 0 is reserved for 'no filter' */
+         treatStamp = 1;
+      }
+      filter = treatStamp;
+      markTreatCandidates(mrX, mrY, filter);
+      markTreatCandidates(index->getLastX(), index->getLastY(), filter);
+   }
+   index->setLastCursor(mrX, mrY, pressed);
+
+   unsigned int prevFilter = treatFilter;
+   treatFilter = filter;
+   bool res = treat(leftButtonPressed, rightButtonPressed, 
          mouseX, mouseY, mrX, mrY);
+   treatFilter = prevFilter;
+
+   return res;
 
 }
 
@@ -623,6 +955,8 @@ bool Widget::treat(bool leftButtonPressed, bool rightButtonPressed,
       return false;
    }
 
+   FrameStats::count(FrameStats::COUNTER_WIDGETS_TREATED);
+
 #if KOBOLD_PLATFORM != KOBOLD_PLATFORM_ANDROID && \
     KOBOLD_PLATFORM != KOBOLD_PLATFORM_IOS
    /* Check if have mouse hint and is cursor is over it */
@@ -671,8 +1005,23 @@ bool Widget::treat(bool leftButtonPressed, bool rightButtonPressed,
    Widget* child = (Widget*) getFirst();
    for(int i = 0; i < getTotal(); i++)
    {
-      if(child->treat(leftButtonPressed, rightButtonPressed, 
-               mouseX, mouseY, mrX, mrY))
+      bool got = false;
+      if(child->ownRenderer)
+      {
+         /* Its children aren't at our index: must check all of them */
+         unsigned int prevFilter = treatFilter;
+         treatFilter = 0;
+         got = child->treat(leftButtonPressed, rightButtonPressed, 
+               mouseX, mouseY, mrX, mrY);
+         treatFilter = prevFilter;
+      }
+      else if((treatFilter == 0) || (child->treatMark == treatFilter))
+      {
+         got = child->treat(leftButtonPressed, rightButtonPressed, 
+               mouseX, mouseY, mrX, mrY);
+      }
+
+      if(got)
       {
          doAfterChildTreat();
          return true;
@@ -686,25 +1035,187 @@ bool Widget::treat(bool leftButtonPressed, bool rightButtonPressed,
    return last.getType() != EVENT_NONE;
 }
 
+/***********************************************************************
+ *                          markTreatCandidates                        *
+ ***********************************************************************/
+void Widget::markTreatCandidates(int x, int y, unsigned int mark)
+{
+   std::vector<Widget*> found;
+   index->getWidgetsAt(x, y, found);
+
+   for(size_t i = 0; i < found.size(); i++)
+   {
+      /* Mark it and its parents (as they must be treated to reach it). */
+      Widget* w = found[i];
+      while((w != NULL) && (w != this) && (w->treatMark != mark))
+      {
+         w->treatMark = mark;
+         w = w->parent;
+      }
+   }
+}
+
+/***********************************************************************
+ *                             getOwnerIndex                           *
+ ***********************************************************************/
+WidgetIndex* Widget::getOwnerIndex()
+{
+   Widget* owner = parent;
+   while((owner != NULL) && (!owner->ownRenderer))
+   {
+      owner = owner->parent;
+   }
+
+   return (owner != NULL) ? owner->index : NULL;
+}
+
+/***********************************************************************
+ *                                reindex                              *
+ ***********************************************************************/
+void Widget::reindex()
+{
+   if(ownRenderer)
+   {
+      /* Renderer owners aren't indexed */
+      return;
+   }
+
+   /* Only indexed if all parents (until the renderer owner) are visible */
+   bool insert = true;
+   Widget* owner = parent;
+   while((owner != NULL) && (!owner->ownRenderer))
+   {
+      insert &= owner->visible;
+      owner = owner->parent;
+   }
+
+   if((owner != NULL) && (owner->index != NULL))
+   {
+      indexSubtree(owner->index, insert);
+   }
+}
+
+/***********************************************************************
+ *                             indexSubtree                            *
+ ***********************************************************************/
+void Widget::indexSubtree(WidgetIndex* idx, bool insert)
+{
+   /* Note: the area must be taken before changing the index, as getting
+    * it could update our parent's body, reindexing its children. */
+   insert &= visible;
+   Rect area = (insert) ? getRectOnRenderer() : Rect();
+
+   if(indexed)
+   {
+      idx->remove(this, indexedArea);
+      indexed = false;
+   }
+
+   if(insert)
+   {
+      indexedArea = area;
+      idx->insert(this, indexedArea);
+      indexed = true;
+   }
+
+   Widget* child = (Widget*) getFirst();
+   for(int i = 0; i < getTotal(); i++)
+   {
+      if(!child->ownRenderer)
+      {
+         child->indexSubtree(idx, insert);
+      }
+      child = (Widget*) child->getNext();
+   }
+}
+
+/***********************************************************************
+ *                             rebuildIndex                            *
+ ***********************************************************************/
+void Widget::rebuildIndex()
+{
+   /* Note: setSize also clears the index */
+   index->setSize(width, height);
+
+   Widget* child = (Widget*) getFirst();
+   for(int i = 0; i < getTotal(); i++)
+   {
+      if(!child->ownRenderer)
+      {
+         child->indexSubtree(index, true);
+      }
+      child = (Widget*) child->getNext();
+   }
+}
+
 /***********************************************************************
  *                      getBodyWithParentsApplied                      *
  ***********************************************************************/
 Farso::Rect Widget::getBodyWithParentsApplied()
 {
-   Rect body = getBody();
+   if(absBodyValid)
+   {
+      return absBody;
+   }
+
+   Rect prevAbsBody = absBody;
+   absBodyRelative = getBody();
    
    if((parent != NULL) && (!ownRenderer))
    {
       Rect parentBody = parent->getBodyWithParentsApplied();
 
-      return Rect(parentBody.getX1() + body.getX1(), 
-                  parentBody.getY1() + body.getY1(),
-                  parentBody.getX1() + body.getX2(),
-                  parentBody.getY1() + body.getY2());
+      absBody.set(parentBody.getX1() + absBodyRelative.getX1(), 
+                  parentBody.getY1() + absBodyRelative.getY1(),
+                  parentBody.getX1() + absBodyRelative.getX2(),
+                  parentBody.getY1() + absBodyRelative.getY2());
+   }
+   else
+   {
+      absBody = absBodyRelative;
    }
+   absBodyValid = true;
 
-   return Rect(body.getX1(), body.getY1(),
-               body.getX2(), body.getY2());
+   /* If changed (for example, redefined by a window when its skin
+    * changes), its children moved, thus must be indexed again. */
+   if((prevAbsBody != absBody) && (getTotal() > 0))
+   {
+      if(!ownRenderer)
+      {
+         reindex();
+      }
+      else if(index != NULL)
+      {
+         rebuildIndex();
+      }
+   }
+
+   return absBody;
+}
+
+/***********************************************************************
+ *                        invalidateAbsoluteBody                       *
+ ***********************************************************************/
+void Widget::invalidateAbsoluteBody()
+{
+   if(!absBodyValid)
+   {
+      /* Note: when invalid, all children depending on it are invalid 
+       * too, as they can't be calculated without calculating us. */
+      return;
+   }
+   absBodyValid = false;
+
+   Widget* child = (Widget*) getFirst();
+   for(int i = 0; i < getTotal(); i++)
+   {
+      /* Widgets with own renderer don't depend on our body */
+      if(!child->ownRenderer)
+      {
+         child->invalidateAbsoluteBody();
+      }
+      child = (Widget*) child->getNext();
+   }
 }
 
 /***********************************************************************
@@ -759,3 +1270,6 @@ Widget* Widget::getRoot()
    return root;
 }
 
+unsigned int Widget::treatStamp = 0;
+unsigned int Widget::treatFilter = 0;
+
@@ -26,6 +26,7 @@
 #include <list>
 
 #include "widgetrenderer.h"
+#include "widgetindex.h"
 #include "draw.h"
 #include "rect.h"
 #include "farsoconfig.h"
@@ -99,13 +100,32 @@ class Widget : public Kobold::ListElement, public Kobold::List
       const Kobold::String& getId() const { return id; };
 
       /*! Draw the Widget to its target renderer.
-       * \param force with will force a draw, regardless of its dirty state.
-       *        Usually seted as true when parent is dirty.
+       * Only the areas marked as damaged on the renderer are cleared and
+       * redrawn (with all widgets intersecting each of them).
+       * \param force with will force a draw of the whole renderer area, 
+       *        regardless of its damaged areas.
        * \note: usually called when the widget (or some of its children) 
        * is dirty, to update the texture.
+       * \note: when called on a widget without its own renderer, the draw
+       *        will be done by its nearest parent that owns one.
        * \note: the caller is responsable for locking the needed surfaces. */
       void draw(bool force = false);
 
+      /*! First step of draw: only rasterize the damaged areas of the 
+       * widget's surface (without uploading them to the renderer). 
+       * As different widgets owning renderers don't share surfaces, this
+       * could be called for them at the same time, by different threads.
+       * \param force if should redraw the whole renderer area.
+       * \note only for widgets owning its renderer, and with the renderer's
+       *       surface already created.
+       * \note must be followed by a call to finishDraw, at the rendering
+       *       thread. */
+      void rasterize(bool force = false);
+
+      /*! Last step of draw: upload the areas rasterized by last rasterize
+       * call and draw children with their own renderers (if needed). */
+      void finishDraw();
+
       /*! Treat mouse (or finger) action on the widget.
        * \param leftButtonPressed state of the left mouse button (or similar,
        *        of a single finger touch on screen). 
@@ -120,7 +140,11 @@ class Widget : public Kobold::ListElement, public Kobold::List
       bool treat(bool leftButtonPressed, bool rightButtonPressed, 
             int mouseX, int mouseY);
       /*! Same as treat, but with pre-calculated coordinates on parent's
-       * coordinate system */
+       * coordinate system
+       * \note when called through the treat above, on a widget with its 
+       *       own renderer, only the children under the current (or last)
+       *       cursor position are checked while no mouse button is 
+       *       pressed (as only cursor hovering could happen). */
       bool treat(bool leftButtonPressed, bool rightButtonPressed, 
             int mouseX, int mouseY, int mrX, int mrY);
 
@@ -195,16 +219,21 @@ class Widget : public Kobold::ListElement, public Kobold::List
       virtual void disable();
 
       /*! Verify if need to redraw the Widget (or some of its children). 
-       * \note: the flag will be cleaned with a call to draw. */
+       * \note: the flag will be cleaned with a call to draw. 
+       * \note: constant time, as dirty state is propagated to parents. */
       bool isDirty();
 
       /*! Verify if the widget itself is dirty (ignoring its children state).*/
       const bool isSelfDirty() const { return dirty; };
 
-      /*! Set the Widget as dirty (ie: that will need to be redraw). */
+      /*! Set the Widget as dirty (ie: that will need to be redraw),
+       * marking its area as damaged on its renderer. */
       virtual void setDirty();
 
-      /*! Set the Widget as dirty and also its parent (if any). */
+      /*! Set the Widget as dirty, also redrawing its parent (if any) at 
+       * the widget's area. Used by non-opaque widgets.
+       * \note as any damaged area is redrawn with everything under it,
+       *       this no longer needs to dirty the whole parent. */
       void setDirtyWithParent();
 
       /*! Set Text to display when mouse is over the widget */
@@ -232,6 +261,10 @@ class Widget : public Kobold::ListElement, public Kobold::List
        * \note: all of its children are deleted at the Widget destructor. */
       void addChild(Widget* child);
 
+      /*! Remove (and delete) a child of this Widget, redrawing its area.
+       * \param child pointer to the child Widget to remove. */
+      void removeChild(Widget* child);
+
       /*! \return the WidgetRenderer to use. */
       WidgetRenderer* getWidgetRenderer();
       /*! \return if the renderer it use is one of its own (true) or if it's
@@ -246,9 +279,16 @@ class Widget : public Kobold::ListElement, public Kobold::List
        * inside the widget. */
       bool isInnerAbsolute(int x, int y);
 
-      /*! \return rectangle with body with parent's coordinate applyed */
+      /*! \return rectangle with body with parent's coordinate applyed 
+       * \note the value is cached until the widget (or any of its 
+       *       parents) is moved, resized, marked dirty or has its body 
+       *       redefined on draw. */
       Rect getBodyWithParentsApplied();
 
+      /*! \return rectangle occupied by the widget, in its renderer's 
+       * surface coordinates. */
+      Rect getRectOnRenderer();
+
       /*! \return rectangle defining the widget's body. All its children
        * have their coordinates relative to this body */
       virtual const Rect& getBody() = 0;
@@ -310,6 +350,53 @@ class Widget : public Kobold::ListElement, public Kobold::List
       void overrideWidgetRenderer(WidgetRenderer* renderer, bool ownRenderer);
 
    private:
+
+      /*! Mark the current widget area as damaged on its renderer, if
+       * visible. */
+      void damageArea();
+
+      /*! Draw the widget and its children that intersects an area of 
+       * the renderer.
+       * \param area damaged area to redraw, in renderer coordinates. */
+      void drawArea(const Rect& area);
+
+      /*! Tell all parents that some of its descendants is dirty */
+      void propagateDirty();
+
+      /*! Invalidate the cached body with parents applied of this widget
+       * and of its children (that depend on it). */
+      void invalidateAbsoluteBody();
+
+      /*! \return the WidgetIndex of the renderer owner of this widget,
+       * if any. */
+      WidgetIndex* getOwnerIndex();
+
+      /*! Update this widget (and its children) at its renderer owner's
+       * WidgetIndex. Usually called after its area or visibility changed. */
+      void reindex();
+
+      /*! Update the widget and its children areas at an index.
+       * \param idx index to update
+       * \param insert if should insert (true) or only remove (false) */
+      void indexSubtree(WidgetIndex* idx, bool insert);
+
+      /*! Rebuild the whole index of a renderer owner widget. */
+      void rebuildIndex();
+
+      /*! Mark widgets (and their parents) under a point as candidates to
+       * treat events.
+       * \param x X coordinate, in renderer coordinates.
+       * \param y Y coordinate, in renderer coordinates.
+       * \param mark mark to set. */
+      void markTreatCandidates(int x, int y, unsigned int mark);
+
+      /*! Clear the dirty flags of the widget and its children which are 
+       * drawn at the same renderer.
+       * \param subRenderers list where to put visible children with their
+       *        own renderers (that should be drawn by themselves).
+       * \param all if will check all children or only those marked as 
+       *        having dirty descendants. */
+      void clearDirty(std::list<Widget*>& subRenderers, bool all);
       
       WidgetType type;     /**< Widget Type */ 
 
@@ -332,9 +419,29 @@ class Widget : public Kobold::ListElement, public Kobold::List
       Widget* parent;   /**< Parent Widget - if any */
       Widget* root; /**< Root widget of this one */
       bool dirty;     /**< Flag if the had changed its draw state */
+      bool dirtyChild; /**< Flag if some of its descendants is dirty */
 
       int skinElementType; /**< Override the way to draw the element */
 
+      Rect absBody; /**< Cached body with parents applied */
+      Rect absBodyRelative; /**< Body used when calculated absBody */
+      bool absBodyValid; /**< If absBody is up to date */
+
+      std::list<Rect> rasterizedAreas; /**< Areas rasterized, to upload */
+      std::list<Widget*> rasterizedSubRenderers; /**< Children with own
+                                                      renderers to draw */
+      bool rasterizedFull; /**< If the last rasterize was a full one */
+
+      WidgetIndex* index; /**< Spatial index of the widgets drawn at our 
+                               renderer, if its owner */
+      Rect indexedArea; /**< Area used when inserted at the index */
+      bool indexed; /**< If is currently inserted at owner's index */
+      unsigned int treatMark; /**< Mark as candidate for current treat */
+
+      static unsigned int treatStamp; /**< Last used treat mark */
+      static unsigned int treatFilter; /**< Current treat mark to filter
+                                            children, 0 for none. */
+
       std::list<WidgetEventListener*> listeners; /**< List of event listeners */
 };
 
@@ -0,0 +1,347 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "widgetcommand.h"
+#include "widget.h"
+#include "progressbar.h"
+#include "spin.h"
+#include "scrollbar.h"
+#include "checkbox.h"
+
+#include <kobold/log.h>
+
+#include <algorithm>
+#include <functional>
+#include <set>
+
+using namespace Farso;
+
+/***********************************************************************
+ *                            WidgetCommand                            *
+ ***********************************************************************/
+WidgetCommand::WidgetCommand(Widget* widget, const Kobold::String& id, 
+      CommandType type)
+{
+   this->widget = widget;
+   this->id = id;
+   this->type = type;
+   this->value = 0.0f;
+   this->x = 0;
+   this->y = 0;
+   this->flag = false;
+   this->next = NULL;
+}
+
+/***********************************************************************
+ *                              setCaption                             *
+ ***********************************************************************/
+WidgetCommand WidgetCommand::setCaption(Widget* widget, 
+      const Kobold::String& caption)
+{
+   WidgetCommand cmd(widget, "", COMMAND_SET_CAPTION);
+   cmd.text = caption;
+   return cmd;
+}
+WidgetCommand WidgetCommand::setCaption(const Kobold::String& id, 
+      const Kobold::String& caption)
+{
+   WidgetCommand cmd(NULL, id, COMMAND_SET_CAPTION);
+   cmd.text = caption;
+   return cmd;
+}
+
+/***********************************************************************
+ *                               setValue                              *
+ ***********************************************************************/
+WidgetCommand WidgetCommand::setValue(Widget* widget, float value)
+{
+   WidgetCommand cmd(widget, "", COMMAND_SET_VALUE);
+   cmd.value = value;
+   return cmd;
+}
+WidgetCommand WidgetCommand::setValue(const Kobold::String& id, float value)
+{
+   WidgetCommand cmd(NULL, id, COMMAND_SET_VALUE);
+   cmd.value = value;
+   return cmd;
+}
+
+/***********************************************************************
+ *                              setVisible                             *
+ ***********************************************************************/
+WidgetCommand WidgetCommand::setVisible(Widget* widget, bool visible)
+{
+   WidgetCommand cmd(widget, "", COMMAND_SET_VISIBLE);
+   cmd.flag = visible;
+   return cmd;
+}
+WidgetCommand WidgetCommand::setVisible(const Kobold::String& id, bool visible)
+{
+   WidgetCommand cmd(NULL, id, COMMAND_SET_VISIBLE);
+   cmd.flag = visible;
+   return cmd;
+}
+
+/***********************************************************************
+ *                             setPosition                             *
+ ***********************************************************************/
+WidgetCommand WidgetCommand::setPosition(Widget* widget, int x, int y)
+{
+   WidgetCommand cmd(widget, "", COMMAND_SET_POSITION);
+   cmd.x = x;
+   cmd.y = y;
+   return cmd;
+}
+WidgetCommand WidgetCommand::setPosition(const Kobold::String& id, int x, int y)
+{
+   WidgetCommand cmd(NULL, id, COMMAND_SET_POSITION);
+   cmd.x = x;
+   cmd.y = y;
+   return cmd;
+}
+
+/***********************************************************************
+ *                              setEnabled                             *
+ ***********************************************************************/
+WidgetCommand WidgetCommand::setEnabled(Widget* widget, bool enabled)
+{
+   WidgetCommand cmd(widget, "", COMMAND_SET_ENABLED);
+   cmd.flag = enabled;
+   return cmd;
+}
+WidgetCommand WidgetCommand::setEnabled(const Kobold::String& id, bool enabled)
+{
+   WidgetCommand cmd(NULL, id, COMMAND_SET_ENABLED);
+   cmd.flag = enabled;
+   return cmd;
+}
+
+/***********************************************************************
+ *                             isSameTarget                            *
+ ***********************************************************************/
+const bool WidgetCommand::isSameTarget(const WidgetCommand& cmd) const
+{
+   return (type == cmd.type) && (widget == cmd.widget) && (id == cmd.id);
+}
+
+/***********************************************************************
+ *                            isTargetBefore                           *
+ ***********************************************************************/
+const bool WidgetCommand::isTargetBefore(const WidgetCommand& cmd) const
+{
+   if(type != cmd.type)
+   {
+      return type < cmd.type;
+   }
+   if(widget != cmd.widget)
+   {
+      return std::less<Widget*>()(widget, cmd.widget);
+   }
+   return id < cmd.id;
+}
+
+/***********************************************************************
+ *                                apply                                *
+ ***********************************************************************/
+void WidgetCommand::apply(Widget* target) const
+{
+   switch(type)
+   {
+      case COMMAND_SET_CAPTION:
+         target->setCaption(text);
+      break;
+      case COMMAND_SET_VALUE:
+      {
+         switch(target->getType())
+         {
+            case Widget::WIDGET_TYPE_PROGRESS_BAR:
+               static_cast<ProgressBar*>(target)->setValue((int) value);
+            break;
+            case Widget::WIDGET_TYPE_SPIN:
+               static_cast<Spin*>(target)->setValue(value);
+            break;
+            case Widget::WIDGET_TYPE_SCROLL_BAR:
+               static_cast<ScrollBar*>(target)->setCurrent((int) value);
+            break;
+            case Widget::WIDGET_TYPE_CHECK_BOX:
+               if(value != 0.0f)
+               {
+                  static_cast<CheckBox*>(target)->check();
+               }
+               else
+               {
+                  static_cast<CheckBox*>(target)->uncheck();
+               }
+            break;
+            default:
+               Kobold::Log::add(Kobold::LOG_LEVEL_ERROR, 
+                     "Error: widget type %d doesn't have a value to set!",
+                     target->getType());
+            break;
+         }
+      }
+      break;
+      case COMMAND_SET_VISIBLE:
+         if(flag)
+         {
+            target->show();
+         }
+         else
+         {
+            target->hide();
+         }
+      break;
+      case COMMAND_SET_POSITION:
+         target->setPosition(x, y);
+      break;
+      case COMMAND_SET_ENABLED:
+         if(flag)
+         {
+            target->enable();
+         }
+         else
+         {
+            target->disable();
+         }
+      break;
+      default:
+      break;
+   }
+}
+
+/***********************************************************************
+ *                          WidgetCommandQueue                         *
+ ***********************************************************************/
+WidgetCommandQueue::WidgetCommandQueue()
+                   :head(NULL)
+{
+}
+
+/***********************************************************************
+ *                         ~WidgetCommandQueue                         *
+ ***********************************************************************/
+WidgetCommandQueue::~WidgetCommandQueue()
+{
+   take();
+   for(size_t i = 0; i < taken.size(); i++)
+   {
+      delete taken[i];
+   }
+   taken.clear();
+}
+
+/***********************************************************************
+ *                                 push                                *
+ ***********************************************************************/
+void WidgetCommandQueue::push(const WidgetCommand& cmd)
+{
+   WidgetCommand* node = new WidgetCommand(cmd);
+   node->next = head.load(std::memory_order_relaxed);
+
+   /* Note: on failure, node->next is updated with current head */
+   while(!head.compare_exchange_weak(node->next, node, 
+            std::memory_order_release, std::memory_order_relaxed))
+   {
+   }
+}
+
+/***********************************************************************
+ *                                 take                                *
+ ***********************************************************************/
+void WidgetCommandQueue::take()
+{
+   /* Take all pushed commands at once. They are from newest to oldest. */
+   WidgetCommand* cmd = head.exchange(NULL, std::memory_order_acquire);
+   if(cmd == NULL)
+   {
+      return;
+   }
+
+   size_t first = taken.size();
+   while(cmd != NULL)
+   {
+      WidgetCommand* next = cmd->next;
+      cmd->next = NULL;
+      taken.push_back(cmd);
+      cmd = next;
+   }
+
+   /* Keep them from oldest to newest, after the previously taken ones */
+   std::reverse(taken.begin() + first, taken.end());
+}
+
+/***********************************************************************
+ *                                 pop                                 *
+ ***********************************************************************/
+void WidgetCommandQueue::pop(std::vector<WidgetCommand*>& cmds)
+{
+   take();
+   if(taken.empty())
+   {
+      return;
+   }
+
+   /* Keep only the newest of each target, deleting the overridden ones
+    * (ie: the ones whose target was already seen). */
+   std::vector<WidgetCommand*> kept;
+   std::set<const WidgetCommand*, TargetLess> targets;
+   for(size_t i = taken.size(); i > 0; i--)
+   {
+      WidgetCommand* cmd = taken[i - 1];
+      if(targets.insert(cmd).second)
+      {
+         kept.push_back(cmd);
+      }
+      else
+      {
+         delete cmd;
+      }
+   }
+   taken.clear();
+
+   /* Return them from oldest to newest */
+   for(size_t i = kept.size(); i > 0; i--)
+   {
+      cmds.push_back(kept[i - 1]);
+   }
+}
+
+/***********************************************************************
+ *                               discard                               *
+ ***********************************************************************/
+void WidgetCommandQueue::discard(Widget* widget)
+{
+   take();
+
+   size_t total = 0;
+   for(size_t i = 0; i < taken.size(); i++)
+   {
+      if(taken[i]->getWidget() == widget)
+      {
+         delete taken[i];
+      }
+      else
+      {
+         taken[total] = taken[i];
+         total++;
+      }
+   }
+   taken.resize(total);
+}
@@ -0,0 +1,179 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_widget_command_h
+#define _farso_widget_command_h
+
+#include <kobold/kstring.h>
+
+#include "farsoconfig.h"
+
+#include <atomic>
+#include <vector>
+
+namespace Farso
+{
+
+class Widget;
+
+/*! A mutation to be applied to a widget, usually created at a thread 
+ * other than the GUI one, and queued with Controller::queueCommand. 
+ * The target widget could be addressed either by pointer or by its id
+ * (see Controller::setIdReference). 
+ * \note When addressed by pointer, commands queued before the widget's
+ *       deletion are discarded, but the caller must not queue new ones
+ *       after it. Prefer addressing by id when the widget could be deleted
+ *       while other threads still reference it. */
+class WidgetCommand
+{
+   public:
+      /*! Types of mutations */
+      enum CommandType
+      {
+         /*! Set widget's caption */
+         COMMAND_SET_CAPTION = 0,
+         /*! Set widget's value (progress bar, spin, scroll bar or 
+          * checkbox - where non zero is checked) */
+         COMMAND_SET_VALUE,
+         /*! Show or hide the widget */
+         COMMAND_SET_VISIBLE,
+         /*! Set widget's position */
+         COMMAND_SET_POSITION,
+         /*! Enable or disable the widget */
+         COMMAND_SET_ENABLED,
+         /*! Just to know the total number of command types */
+         TOTAL_COMMAND_TYPES
+      };
+
+      /*! \return command to set the caption of a widget */
+      static WidgetCommand setCaption(Widget* widget, 
+            const Kobold::String& caption);
+      static WidgetCommand setCaption(const Kobold::String& id, 
+            const Kobold::String& caption);
+
+      /*! \return command to set the value of a widget */
+      static WidgetCommand setValue(Widget* widget, float value);
+      static WidgetCommand setValue(const Kobold::String& id, float value);
+
+      /*! \return command to show (true) or hide (false) a widget */
+      static WidgetCommand setVisible(Widget* widget, bool visible);
+      static WidgetCommand setVisible(const Kobold::String& id, bool visible);
+
+      /*! \return command to set the position of a widget */
+      static WidgetCommand setPosition(Widget* widget, int x, int y);
+      static WidgetCommand setPosition(const Kobold::String& id, int x, int y);
+
+      /*! \return command to enable (true) or disable (false) a widget */
+      static WidgetCommand setEnabled(Widget* widget, bool enabled);
+      static WidgetCommand setEnabled(const Kobold::String& id, bool enabled);
+
+      /*! \return the command type */
+      const CommandType getType() const { return type; };
+
+      /*! \return if the command targets the same widget and property of
+       *          another one (thus, one overrides the other). */
+      const bool isSameTarget(const WidgetCommand& cmd) const;
+
+      /*! Strict weak ordering of commands by target widget and property
+       * (ie: two commands are equivalent if they have the same target).
+       * \return if this command's target is before the one of cmd. */
+      const bool isTargetBefore(const WidgetCommand& cmd) const;
+
+      /*! Apply the command to the widget.
+       * \param target resolved target widget. */
+      void apply(Widget* target) const;
+
+      /*! \return target widget, when addressed by pointer */
+      Widget* getWidget() const { return widget; };
+      /*! \return target widget id, when addressed by id */
+      const Kobold::String& getId() const { return id; };
+
+   private:
+      /*! Constructor, used by the static creators */
+      WidgetCommand(Widget* widget, const Kobold::String& id, 
+            CommandType type);
+
+      Widget* widget; /**< Target widget, if addressed by pointer */
+      Kobold::String id; /**< Target widget id, if addressed by id */
+      CommandType type; /**< Type of the command */
+      Kobold::String text; /**< Text value, for caption */
+      float value; /**< Numeric value */
+      int x; /**< X coordinate, for position */
+      int y; /**< Y coordinate, for position */
+      bool flag; /**< Boolean value, for visibility and enabled */
+
+      WidgetCommand* next; /**< Next on WidgetCommandQueue */
+
+      friend class WidgetCommandQueue;
+};
+
+/*! A lock-free multiple producers / single consumer queue of 
+ * WidgetCommands: any thread could push commands without blocking, 
+ * while only the GUI thread pops them. */
+class WidgetCommandQueue
+{
+   public:
+      /*! Constructor */
+      WidgetCommandQueue();
+      /*! Destructor */
+      ~WidgetCommandQueue();
+
+      /*! Push a copy of a command to the queue. Thread safe and lock-free.
+       * \param cmd command to push */
+      void push(const WidgetCommand& cmd);
+
+      /*! Pop all current commands, in the order they were pushed, 
+       * coalescing commands to the same widget property (ie: only the
+       * last one of them is kept).
+       * \param cmds vector where to append the commands. Caller is 
+       *        responsible to delete them.
+       * \note must be only called by a single thread (the consumer). */
+      void pop(std::vector<WidgetCommand*>& cmds);
+
+      /*! Discard all current commands addressed to a widget pointer.
+       * \param widget pointer to the widget being deleted.
+       * \note as pop, must be only called by the consumer. */
+      void discard(Widget* widget);
+
+   private:
+      /*! Take all pushed commands from the stack, appending them (from
+       * oldest to newest) to the taken ones. */
+      void take();
+
+      /*! Orders commands by their targets */
+      struct TargetLess
+      {
+         bool operator()(const WidgetCommand* a, 
+               const WidgetCommand* b) const
+         {
+            return a->isTargetBefore(*b);
+         };
+      };
+
+      std::atomic<WidgetCommand*> head; /**< Last pushed command */
+      std::vector<WidgetCommand*> taken; /**< Commands already taken from
+                                           the stack, but not yet popped,
+                                           from oldest to newest */
+};
+
+}
+
+#endif
+
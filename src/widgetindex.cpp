@@ -0,0 +1,192 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "widgetindex.h"
+using namespace Farso;
+
+/***********************************************************************
+ *                              Constructor                            *
+ ***********************************************************************/
+WidgetIndex::WidgetIndex(int width, int height)
+{
+   columns = 0;
+   rows = 0;
+   lastX = -1;
+   lastY = -1;
+   lastPressed = false;
+   setSize(width, height);
+}
+
+/***********************************************************************
+ *                               Destructor                            *
+ ***********************************************************************/
+WidgetIndex::~WidgetIndex()
+{
+}
+
+/***********************************************************************
+ *                                setSize                              *
+ ***********************************************************************/
+void WidgetIndex::setSize(int width, int height)
+{
+   columns = (width + FARSO_WIDGET_INDEX_CELL_SIZE - 1) / 
+             FARSO_WIDGET_INDEX_CELL_SIZE;
+   rows = (height + FARSO_WIDGET_INDEX_CELL_SIZE - 1) / 
+          FARSO_WIDGET_INDEX_CELL_SIZE;
+
+   cells.clear();
+   cells.resize(columns * rows);
+}
+
+/***********************************************************************
+ *                                 clear                               *
+ ***********************************************************************/
+void WidgetIndex::clear()
+{
+   for(size_t i = 0; i < cells.size(); i++)
+   {
+      cells[i].clear();
+   }
+}
+
+/***********************************************************************
+ *                               getCells                              *
+ ***********************************************************************/
+bool WidgetIndex::getCells(const Rect& area, int& c1, int& r1, 
+      int& c2, int& r2)
+{
+   if((!area.isDefined()) || (area.getX2() < 0) || (area.getY2() < 0) ||
+      (area.getX1() > area.getX2()) || (area.getY1() > area.getY2()))
+   {
+      return false;
+   }
+
+   c1 = (area.getX1() > 0) ? area.getX1() / FARSO_WIDGET_INDEX_CELL_SIZE : 0;
+   r1 = (area.getY1() > 0) ? area.getY1() / FARSO_WIDGET_INDEX_CELL_SIZE : 0;
+   c2 = area.getX2() / FARSO_WIDGET_INDEX_CELL_SIZE;
+   r2 = area.getY2() / FARSO_WIDGET_INDEX_CELL_SIZE;
+
+   if((c1 >= columns) || (r1 >= rows))
+   {
+      return false;
+   }
+   if(c2 >= columns)
+   {
+      c2 = columns - 1;
+   }
+   if(r2 >= rows)
+   {
+      r2 = rows - 1;
+   }
+
+   return true;
+}
+
+/***********************************************************************
+ *                                insert                               *
+ ***********************************************************************/
+void WidgetIndex::insert(Widget* widget, const Rect& area)
+{
+   int c1, r1, c2, r2;
+   if(!getCells(area, c1, r1, c2, r2))
+   {
+      return;
+   }
+
+   Entry entry;
+   entry.widget = widget;
+   entry.area = area;
+
+   for(int r = r1; r <= r2; r++)
+   {
+      for(int c = c1; c <= c2; c++)
+      {
+         cells[r * columns + c].push_back(entry);
+      }
+   }
+}
+
+/***********************************************************************
+ *                                remove                               *
+ ***********************************************************************/
+void WidgetIndex::remove(Widget* widget, const Rect& area)
+{
+   int c1, r1, c2, r2;
+   if(!getCells(area, c1, r1, c2, r2))
+   {
+      return;
+   }
+
+   for(int r = r1; r <= r2; r++)
+   {
+      for(int c = c1; c <= c2; c++)
+      {
+         std::vector<Entry>& cell = cells[r * columns + c];
+         for(size_t i = 0; i < cell.size(); i++)
+         {
+            if(cell[i].widget == widget)
+            {
+               /* Order isn't relevant: just replace it by the last one */
+               cell[i] = cell.back();
+               cell.pop_back();
+               break;
+            }
+         }
+      }
+   }
+}
+
+/***********************************************************************
+ *                             getWidgetsAt                            *
+ ***********************************************************************/
+void WidgetIndex::getWidgetsAt(int x, int y, std::vector<Widget*>& widgets)
+{
+   if((x < 0) || (y < 0))
+   {
+      return;
+   }
+
+   int c = x / FARSO_WIDGET_INDEX_CELL_SIZE;
+   int r = y / FARSO_WIDGET_INDEX_CELL_SIZE;
+   if((c >= columns) || (r >= rows))
+   {
+      return;
+   }
+
+   std::vector<Entry>& cell = cells[r * columns + c];
+   for(size_t i = 0; i < cell.size(); i++)
+   {
+      if(cell[i].area.isInner(x, y))
+      {
+         widgets.push_back(cell[i].widget);
+      }
+   }
+}
+
+/***********************************************************************
+ *                             setLastCursor                           *
+ ***********************************************************************/
+void WidgetIndex::setLastCursor(int x, int y, bool pressed)
+{
+   lastX = x;
+   lastY = y;
+   lastPressed = pressed;
+}
+
@@ -0,0 +1,108 @@
+/* 
+  Farso: a simple GUI.
+  Copyright (C) DNTeam <dnt@dnteam.org>
+ 
+  This file is part of Farso.
+ 
+  Farso is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Farso is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with Farso.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _farso_widget_index_h
+#define _farso_widget_index_h
+
+#include "farsoconfig.h"
+#include "rect.h"
+
+#include <vector>
+
+namespace Farso
+{
+
+class Widget;
+
+/*! Size, in pixels, of each cell of a WidgetIndex */
+#define FARSO_WIDGET_INDEX_CELL_SIZE    32
+
+/*! A uniform grid spatial index of the widgets drawn at a single 
+ * WidgetRenderer, in its surface coordinates. Used to find the widgets
+ * under the cursor without needing to walk the whole widget tree.
+ * \note the index is kept updated by the widgets themselves, when they 
+ *       move, resize, show or hide. */
+class WidgetIndex
+{
+   public:
+      /*! Constructor
+       * \param width width of the indexed area
+       * \param height height of the indexed area */
+      WidgetIndex(int width, int height);
+      /*! Destructor */
+      ~WidgetIndex();
+
+      /*! Redefine the indexed area size, clearing the index. */
+      void setSize(int width, int height);
+
+      /*! Remove all widgets from the index */
+      void clear();
+
+      /*! Insert a widget at the index.
+       * \param widget pointer to the widget to insert
+       * \param area widget's area, in renderer coordinates */
+      void insert(Widget* widget, const Rect& area);
+
+      /*! Remove a widget from the index.
+       * \param widget pointer to the widget to remove
+       * \param area area used when the widget was inserted. */
+      void remove(Widget* widget, const Rect& area);
+
+      /*! Get all indexed widgets whose area contains a point.
+       * \param x X coordinate, in renderer coordinates
+       * \param y Y coordinate, in renderer coordinates
+       * \param widgets vector where to append the found widgets */
+      void getWidgetsAt(int x, int y, std::vector<Widget*>& widgets);
+
+      /*! Define the last cursor state used to treat events */
+      void setLastCursor(int x, int y, bool pressed);
+
+      /*! \return last cursor X coordinate used to treat events */
+      const int getLastX() const { return lastX; };
+      /*! \return last cursor Y coordinate used to treat events */
+      const int getLastY() const { return lastY; };
+      /*! \return if any mouse button was pressed at last event treat */
+      const bool wasPressed() const { return lastPressed; };
+
+   private:
+      /*! An indexed widget */
+      struct Entry
+      {
+         Widget* widget; /**< The widget */
+         Rect area;      /**< Its area, in renderer coordinates */
+      };
+
+      /*! Get the range of cells occupied by an area.
+       * \return false if the area is outside the index. */
+      bool getCells(const Rect& area, int& c1, int& r1, int& c2, int& r2);
+
+      int columns; /**< Number of cell columns */
+      int rows;    /**< Number of cell rows */
+      std::vector< std::vector<Entry> > cells; /**< Each cell entries */
+
+      int lastX; /**< Last cursor X coordinate */
+      int lastY; /**< Last cursor Y coordinate */
+      bool lastPressed; /**< If a button was pressed at last treat */
+};
+
+}
+
+#endif
+
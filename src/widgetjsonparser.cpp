@@ -46,6 +46,7 @@ WidgetJsonParser::~WidgetJsonParser()
 bool WidgetJsonParser::loadFromJson(const Kobold::String& jsonStr, 
                WidgetEventListener* listener, bool openWindows)
 {
+   FARSO_TRACE_SCOPE("WidgetJsonParser::loadFromJson");
    bool res = true;
    rapidjson::Document doc;
    doc.Parse(jsonStr.c_str());
@@ -48,6 +48,10 @@ WidgetRenderer::WidgetRenderer(int width, int height)
    this->surface = NULL;
    this->updating = false;
    this->visible = true;
+
+   /* A new renderer must be fully drawn */
+   damageAll();
+   visualChanged = true;
 }
 
 /***********************************************************************
@@ -59,6 +63,7 @@ WidgetRenderer::~WidgetRenderer()
    {
       delete surface;
    }
+   visualChanged = true;
 }
 
 /***********************************************************************
@@ -104,6 +109,10 @@ int WidgetRenderer::getPositionY()
  ***********************************************************************/
 void WidgetRenderer::setPosition(float x, float y)
 {
+   if((x != targetX.getValue()) || (y != targetY.getValue()))
+   {
+      visualChanged = true;
+   }
    targetX.setCurrent(x);
    targetY.setCurrent(y);
    doSetPosition(x, y);
@@ -148,6 +157,129 @@ void WidgetRenderer::setSize(int width, int height)
       this->width = width;
       this->height = height;
    }
+
+   damageAll();
+   visualChanged = true;
+}
+
+/***********************************************************************
+ *                            uploadSurface                            *
+ ***********************************************************************/
+void WidgetRenderer::uploadSurface()
+{
+   std::list<Rect> areas;
+   areas.push_back(Rect(0, 0, width - 1, height - 1));
+   uploadSurface(areas);
+}
+
+/***********************************************************************
+ *                            uploadSurface                            *
+ ***********************************************************************/
+void WidgetRenderer::uploadSurface(const std::list<Rect>& areas)
+{
+   /* Make sure all areas are inside our surface */
+   Rect limits(0, 0, width - 1, height - 1);
+   std::list<Rect> clipped;
+   for(std::list<Rect>::const_iterator it = areas.begin(); 
+       it != areas.end(); ++it)
+   {
+      Rect area = (*it).getIntersection(limits);
+      if(area.isDefined())
+      {
+         clipped.push_back(area);
+      }
+   }
+
+   if(!clipped.empty())
+   {
+      /* Note: all our surfaces are 32 bits per pixel. */
+      FARSO_TRACE_SCOPE("WidgetRenderer::uploadSurface");
+      uint64_t start = FrameStats::startPhase();
+      size_t bytes = doUploadSurface(clipped);
+      FrameStats::endPhase(FrameStats::PHASE_UPLOAD, start);
+      FrameStats::count(FrameStats::COUNTER_SURFACES_UPLOADED);
+      FrameStats::count(FrameStats::COUNTER_BYTES_UPLOADED, bytes);
+
+      uploads++;
+      uploadedBytes += bytes;
+      fullUploadBytes += realWidth * realHeight * 4;
+      visualChanged = true;
+   }
+}
+
+/***********************************************************************
+ *                        resetUploadCounters                          *
+ ***********************************************************************/
+void WidgetRenderer::resetUploadCounters()
+{
+   uploads = 0;
+   uploadedBytes = 0;
+   fullUploadBytes = 0;
+}
+
+/***********************************************************************
+ *                              addDamage                              *
+ ***********************************************************************/
+void WidgetRenderer::addDamage(const Rect& area)
+{
+   Rect cur = area.getIntersection(Rect(0, 0, width - 1, height - 1));
+   if(!cur.isDefined())
+   {
+      /* Nothing visible to damage */
+      return;
+   }
+
+   /* Merge with any intersecting area, keeping the list disjoint. Note 
+    * that the union could intersect with already checked ones, so we must
+    * restart after each merge. */
+   bool merged = true;
+   while(merged)
+   {
+      merged = false;
+      for(std::list<Rect>::iterator it = damage.begin(); 
+          it != damage.end(); ++it)
+      {
+         if((*it).intersects(cur))
+         {
+            cur = cur.getUnion(*it);
+            damage.erase(it);
+            merged = true;
+            break;
+         }
+      }
+   }
+
+   damage.push_back(cur);
+
+   if(damage.size() > FARSO_WIDGET_RENDERER_MAX_DAMAGE_RECTS)
+   {
+      /* Too fragmented: better to redraw its bounding rectangle */
+      Rect bounding;
+      for(std::list<Rect>::iterator it = damage.begin(); 
+          it != damage.end(); ++it)
+      {
+         bounding = bounding.getUnion(*it);
+      }
+      damage.clear();
+      damage.push_back(bounding);
+   }
+}
+
+/***********************************************************************
+ *                              damageAll                              *
+ ***********************************************************************/
+void WidgetRenderer::damageAll()
+{
+   damage.clear();
+   damage.push_back(Rect(0, 0, width - 1, height - 1));
+}
+
+/***********************************************************************
+ *                             clearDamage                             *
+ ***********************************************************************/
+void WidgetRenderer::clearDamage()
+{
+   damage.clear();
 }
 
 /***********************************************************************
@@ -169,6 +301,7 @@ void WidgetRenderer::update()
       targetY.update();
 
       doSetPosition(targetX.getValue(), targetY.getValue());
+      visualChanged = true;
 
       updating = targetX.needUpdate() || targetY.needUpdate();
    }
@@ -179,6 +312,10 @@ void WidgetRenderer::update()
  ***********************************************************************/
 void WidgetRenderer::show()
 {
+   if(!visible)
+   {
+      visualChanged = true;
+   }
    visible = true;
    doShow();
 }
@@ -188,6 +325,10 @@ void WidgetRenderer::show()
  ***********************************************************************/
 void WidgetRenderer::hide()
 {
+   if(visible)
+   {
+      visualChanged = true;
+   }
    visible = false;
    doHide();
 }
@@ -213,4 +354,8 @@ void WidgetRenderer::render()
 
 
 int WidgetRenderer::counter = 0;
+size_t WidgetRenderer::uploads = 0;
+size_t WidgetRenderer::uploadedBytes = 0;
+size_t WidgetRenderer::fullUploadBytes = 0;
+std::atomic<bool> WidgetRenderer::visualChanged(true);
 
@@ -27,6 +27,10 @@
 
 #include "farsoconfig.h"
 #include "surface.h"
+#include "rect.h"
+
+#include <atomic>
+#include <list>
 
 namespace Farso
 {
@@ -34,6 +38,10 @@ namespace Farso
 #define FARSO_WIDGET_RENDERER_FIRST_SUB_GROUP     0
 #define FARSO_WIDGET_RENDERER_LAST_SUB_GROUP      6
 
+/*! Maximum number of disjoint damaged areas kept by a WidgetRenderer 
+ * before collapsing them into its bounding rectangle. */
+#define FARSO_WIDGET_RENDERER_MAX_DAMAGE_RECTS    16
+
 /*! The renderer interface.
  * \note the surface used should be created only by the createSurface method
  * call. This is needed for the surface creation always be at the 'renderer' 
@@ -96,8 +104,60 @@ class WidgetRenderer : public Kobold::ListElement
       /*! \return the drawabe surface */
       Surface* getSurface();
 
-      /*! Upload the surface to the renderer */
-      virtual void uploadSurface() = 0;
+      /*! Upload the whole surface to the renderer */
+      void uploadSurface();
+
+      /*! Upload only some areas of the surface to the renderer.
+       * \param areas list of disjoint rectangles, in surface coordinates,
+       *        to upload. Usually the list of damaged areas. */
+      void uploadSurface(const std::list<Rect>& areas);
+
+      /*! \return total bytes uploaded by all WidgetRenderers, since the
+       *          last call to resetUploadCounters. */
+      static size_t getUploadedBytes() { return uploadedBytes; };
+
+      /*! \return total bytes that would be uploaded by all WidgetRenderers
+       *          if always uploading their whole surfaces, since the last
+       *          call to resetUploadCounters. */
+      static size_t getFullUploadBytes() { return fullUploadBytes; };
+
+      /*! \return number of surface uploads done by all WidgetRenderers,
+       *          since the last call to resetUploadCounters. */
+      static size_t getUploadCount() { return uploads; };
+
+      /*! Reset the upload counters */
+      static void resetUploadCounters();
+
+      /*! \return if any WidgetRenderer changed its visual output (created,
+       *          deleted, moved, shown, hidden or had its surface 
+       *          uploaded) since the last call to resetVisualChanges. */
+      static const bool hasVisualChanges() { return visualChanged; };
+
+      /*! Mark that the visual output changed by some external reason 
+       * (for example, the render order of the renderers). */
+      static void markVisualChanged() { visualChanged = true; };
+
+      /*! Reset the visual changes flag */
+      static void resetVisualChanges() { visualChanged = false; };
+
+      /*! Mark an area of the surface as damaged (ie: that will need to be
+       * redrawn on next draw).
+       * \param area rectangle, in surface coordinates, to add. It will be
+       *        clipped to the renderer's size and merged with any
+       *        intersecting already damaged area. */
+      void addDamage(const Rect& area);
+
+      /*! Mark the whole renderer area as damaged */
+      void damageAll();
+
+      /*! \return if there's any damaged area to redraw */
+      const bool hasDamage() const { return !damage.empty(); };
+
+      /*! \return current list of disjoint damaged areas */
+      const std::list<Rect>& getDamage() const { return damage; };
+
+      /*! Clear the list of damaged areas. Usually called after redrawn. */
+      void clearDamage();
 
       /*! Set on which render queue should render the widget. This is 
        * used to keep some widgets over others when the render order isn't
@@ -131,6 +191,12 @@ class WidgetRenderer : public Kobold::ListElement
       /*! Do the render of the widget surface */ 
       virtual void doRender() = 0;
 
+      /*! Upload areas of the surface to the renderer.
+       * \param areas list of disjoint rectangles to upload, already 
+       *        clipped to the renderer's size.
+       * \return number of bytes actually uploaded. */
+      virtual size_t doUploadSurface(const std::list<Rect>& areas) = 0;
+
       Surface* surface;      /**< The drawable surface */
 
       Kobold::String name; /**< internal name of this renderer */
@@ -145,10 +211,20 @@ class WidgetRenderer : public Kobold::ListElement
 
       bool updating; /**< If need to update or not */
 
+      std::list<Rect> damage; /**< Disjoint areas that need to be redrawn */
+
       Kobold::Target targetX; /**< Target X position */
       Kobold::Target targetY; /**< Target Y position */
 
       static int counter; /**< Counter to avoid name clash. */
+
+      static size_t uploads; /**< Number of uploads */
+      static size_t uploadedBytes; /**< Bytes uploaded */
+      static size_t fullUploadBytes; /**< Bytes if uploading whole surfaces */
+      static std::atomic<bool> visualChanged; /**< If any renderer visually
+                                                changed (only set at the
+                                                rendering thread, but could
+                                                be read from any) */
 };
 
 }